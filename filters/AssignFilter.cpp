@@ -61,6 +61,8 @@ struct AssignArgs
 {
     std::vector<AssignRange> m_assignments;
     DimRange m_condition;
+    ColumnExpression m_conditionExpr;
+    std::vector<ColumnExpression> m_assignmentExprs;
 };
 
 void AssignRange::parse(const std::string& r)
@@ -149,28 +151,58 @@ void AssignFilter::prepared(PointTableRef table)
 }
 
 
-bool AssignFilter::processOne(PointRef& point)
+void AssignFilter::ready(PointTableRef table)
 {
+    PointLayoutPtr layout(table.layout());
+
     if (m_args->m_condition.m_id != Dimension::Id::Unknown)
+        m_args->m_conditionExpr.compile(*m_args->m_condition.node());
+    m_args->m_conditionExpr.ready(layout);
+    m_args->m_assignmentExprs.clear();
+    for (auto& r : m_args->m_assignments)
+    {
+        r.m_accessor = FieldAccessor<double>(layout, r.m_id);
+        m_args->m_assignmentExprs.emplace_back();
+        m_args->m_assignmentExprs.back().compile(*r.node());
+        m_args->m_assignmentExprs.back().ready(layout);
+    }
+}
+
+
+bool AssignFilter::processOne(PointRef& point)
+{
+    if (!m_args->m_conditionExpr.evaluate(point))
+        return true;
+    for (size_t i = 0; i < m_args->m_assignments.size(); ++i)
     {
-        double condVal = point.getFieldAs<double>(m_args->m_condition.m_id);
-        if (!m_args->m_condition.valuePasses(condVal))
-            return true;
+        AssignRange& r = m_args->m_assignments[i];
+        if (m_args->m_assignmentExprs[i].evaluate(point))
+            r.m_accessor.set(point, r.m_value);
     }
-    for (AssignRange& r : m_args->m_assignments)
-        if (r.valuePasses(point.getFieldAs<double>(r.m_id)))
-            point.setField(r.m_id, r.m_value);
     return true;
 }
 
 
+// The condition is evaluated for all points before any assignment is made
+// and each assignment is made to all points before the next is tested,
+// which for each point gives the same result as processOne().
 void AssignFilter::filter(PointView& view)
 {
+    std::vector<uint8_t> condition;
+    std::vector<uint8_t> selection;
+
+    m_args->m_conditionExpr.evaluate(view, condition);
     PointRef point(view, 0);
-    for (PointId id = 0; id < view.size(); ++id)
+    for (size_t i = 0; i < m_args->m_assignments.size(); ++i)
     {
-        point.setPointId(id);
-        processOne(point);
+        AssignRange& r = m_args->m_assignments[i];
+        m_args->m_assignmentExprs[i].evaluate(view, selection);
+        for (PointId id = 0; id < view.size(); ++id)
+            if (condition[id] & selection[id])
+            {
+                point.setPointId(id);
+                r.m_accessor.set(point, r.m_value);
+            }
     }
 }
 
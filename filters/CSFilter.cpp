@@ -78,6 +78,9 @@ struct CSArgs
     double m_resolution;
     int m_rigid;
     int m_iterations;
+    double m_tileSize;
+    double m_tileBuffer;
+    int m_threads;
     std::vector<DimRange> m_ignored;
     StringList m_returns;
 };
@@ -99,6 +102,12 @@ void CSFilter::addArgs(ProgramArgs& args)
     args.add("resolution", "Cloth resolution", m_args->m_resolution, 1.0);
     args.add("rigidness", "Rigidness", m_args->m_rigid, 3);
     args.add("iterations", "Max iterations", m_args->m_iterations, 500);
+    args.add("tile_size", "Edge length of cloth tiles (0 for a single cloth)",
+        m_args->m_tileSize, 0.0);
+    args.add("tile_buffer", "Overlap between neighboring cloth tiles",
+        m_args->m_tileBuffer, 20.0);
+    args.add("threads", "Number of threads used to simulate cloth tiles",
+        m_args->m_threads, 1);
     args.add("ignore", "Ignore values", m_args->m_ignored);
     args.add("returns", "Include last returns?", m_args->m_returns,
              {"last", "only"});
@@ -113,6 +122,11 @@ void CSFilter::prepared(PointTableRef table)
 {
     const PointLayoutPtr layout(table.layout());
 
+    if (m_args->m_tileSize < 0)
+        throwError("Option 'tile_size' must not be negative.");
+    if (m_args->m_tileBuffer < 0)
+        throwError("Option 'tile_buffer' must not be negative.");
+
     for (auto& r : m_args->m_ignored)
     {
         r.m_id = layout->findDim(r.m_name);
@@ -232,7 +246,11 @@ PointViewSet CSFilter::run(PointViewPtr view)
     c.setPointCloud(csfPC);
     try
     {
-        c.do_filtering(groundIdx, offGroundIdx, true);
+        if (m_args->m_tileSize > 0)
+            c.do_filtering(groundIdx, offGroundIdx, m_args->m_tileSize,
+                m_args->m_tileBuffer, m_args->m_threads);
+        else
+            c.do_filtering(groundIdx, offGroundIdx, true);
     }
     catch (std::exception& e)
     {
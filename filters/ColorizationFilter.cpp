@@ -136,11 +136,24 @@ void ColorizationFilter::addArgs(ProgramArgs& args)
 {
     args.add("raster", "Raster filename", m_rasterFilename);
     args.add("dimensions", "Dimensions to use for colorization", m_dimSpec);
+    args.add("resample", "Resampling method: nearest, bilinear or cubic",
+        m_resampleName, "nearest");
 }
 
 
 void ColorizationFilter::initialize()
 {
+    const std::string resample(Utils::tolower(m_resampleName));
+    if (resample == "nearest")
+        m_resample = gdal::Resample::Nearest;
+    else if (resample == "bilinear")
+        m_resample = gdal::Resample::Bilinear;
+    else if (resample == "cubic")
+        m_resample = gdal::Resample::Cubic;
+    else
+        throwError("Invalid 'resample' option '" + m_resampleName + "'.  "
+            "Must be 'nearest', 'bilinear' or 'cubic'.");
+
     gdal::registerDrivers();
 
     m_raster.reset(new gdal::Raster(m_rasterFilename));
@@ -208,7 +221,7 @@ bool ColorizationFilter::processOne(PointRef& point)
     double x = point.getFieldAs<double>(Dimension::Id::X);
     double y = point.getFieldAs<double>(Dimension::Id::Y);
 
-    if (m_raster->read(x, y, data) == gdal::GDALError::None)
+    if (m_raster->read(x, y, data, m_resample) == gdal::GDALError::None)
     {
         int i(0);
         for (auto bi = m_bands.begin(); bi != m_bands.end(); ++bi)
@@ -225,11 +238,42 @@ bool ColorizationFilter::processOne(PointRef& point)
 
 void ColorizationFilter::filter(PointView& view)
 {
-    PointRef point = view.point(0);
-    for (PointId idx = 0; idx < view.size(); ++idx)
+    // Points are looked up in batches, which the raster visits in block
+    // order.
+    const point_count_t BatchSize = 65536;
+
+    std::vector<std::array<double, 2>> pos;
+    std::vector<double> data;
+    std::vector<bool> valid;
+    const size_t numBands = (size_t)m_raster->bandCount();
+    for (PointId start = 0; start < view.size(); start += BatchSize)
     {
-        point.setPointId(idx);
-        processOne(point);
+        const PointId end = (std::min)(start + BatchSize, view.size());
+        pos.resize(end - start);
+        for (PointId idx = start; idx < end; ++idx)
+        {
+            std::array<double, 2>& p = pos[idx - start];
+            p[0] = view.getFieldAs<double>(Dimension::Id::X, idx);
+            p[1] = view.getFieldAs<double>(Dimension::Id::Y, idx);
+        }
+
+        if (m_raster->read(pos, data, valid, m_resample) !=
+                gdal::GDALError::None)
+            throwError(m_raster->errorMsg());
+
+        for (PointId idx = start; idx < end; ++idx)
+        {
+            if (!valid[idx - start])
+                continue;
+            const double *d = data.data() + (idx - start) * numBands;
+            int i(0);
+            for (auto bi = m_bands.begin(); bi != m_bands.end(); ++bi)
+            {
+                BandInfo& b = *bi;
+                view.setField(b.m_dim, idx, d[i] * b.m_scale);
+                ++i;
+            }
+        }
     }
 }
 
@@ -42,7 +42,11 @@
 namespace pdal
 {
 
-namespace gdal { class Raster; }
+namespace gdal
+{
+    class Raster;
+    enum class Resample;
+}
 
 // Provides GDAL-based raster overlay that places output data in
 // specified dimensions. It also supports scaling the data by a multiplier
@@ -86,6 +90,8 @@ private:
     StringList m_dimSpec;
     std::string m_rasterFilename;
     std::vector<BandInfo> m_bands;
+    std::string m_resampleName;
+    gdal::Resample m_resample;
 
     std::unique_ptr<gdal::Raster> m_raster;
 };
@@ -37,9 +37,11 @@
 // Stéphane Guinard, Loïc Landrieu, 2017
 
 #include "CovarianceFeaturesFilter.hpp"
+#include "private/Neighborhood.hpp"
 
 #include <pdal/EigenUtils.hpp>
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/ThreadRange.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
 #include <Eigen/Dense>
@@ -86,49 +88,43 @@ void CovarianceFeaturesFilter::filter(PointView& view)
 {
 
     KD3Index& kdi = view.build3dIndex();
+    const XYZArrays coords(view);
 
-    point_count_t nloops = view.size();
-    std::vector<std::thread> threadList(m_threads);
-    for(int t = 0;t<m_threads;t++)
+    m_linearity = m_extraDims["Linearity"];
+    m_planarity = m_extraDims["Planarity"];
+    m_scattering = m_extraDims["Scattering"];
+    m_verticality = m_extraDims["Verticality"];
+
+    forEachRange(view.size(), m_threads, [&](PointId start, PointId end)
     {
-        threadList[t] = std::thread(std::bind(
-                [&](const PointId start, const PointId end)
-                {
-                    for(PointId i = start;i<end;i++)
-                        setDimensionality(view, i, kdi);
-                },
-                t*nloops/m_threads,(t+1)==m_threads?nloops:(t+1)*nloops/m_threads));
-    }
-    for (auto &t: threadList)
-        t.join();
+        NeighborhoodCovariance neighborhood(coords, kdi, m_knn + 1, m_stride);
+        for (PointId i = start; i < end; i++)
+            setDimensionality(view, i, neighborhood);
+    });
 }
 
-void CovarianceFeaturesFilter::setDimensionality(PointView &view, const PointId &id, const KD3Index &kid)
+void CovarianceFeaturesFilter::setDimensionality(PointView &view, const PointId &id, NeighborhoodCovariance &neighborhood)
 {
     using namespace Eigen;
 
-    // find the k-nearest neighbors
-    auto ids = kid.neighbors(id, m_knn + 1, m_stride);
-
-    // compute covariance of the neighborhood
-    auto B = computeCovariance(view, ids);
+    // find the k-nearest neighbors and compute covariance of the neighborhood
+    Matrix3d B = neighborhood.compute(id);
 
     // perform the eigen decomposition
-    SelfAdjointEigenSolver<Matrix3d> solver(B);
-    if (solver.info() != Success)
+    Vector3d ev;
+    Matrix3d eigenVectors;
+    if (!computeEigen3x3(B, ev, eigenVectors))
         throwError("Cannot perform eigen decomposition.");
 
     // Extract eigenvalues and eigenvectors in decreasing order (largest eigenvalue first)
-    auto ev = solver.eigenvalues();
-    std::vector<double> lambda = {(std::max(ev[2],0.0)),
-                                  (std::max(ev[1],0.0)),
-                                  (std::max(ev[0],0.0))};
+    const double lambda[3] = {(std::max(ev[2],0.0)),
+                              (std::max(ev[1],0.0)),
+                              (std::max(ev[0],0.0))};
 
     if (lambda[0] == 0)
         throwError("Eigenvalues are all 0. Can't compute local features.");
 
-    auto eigenVectors = solver.eigenvectors();
-    std::vector<double> v1(3), v2(3), v3(3);
+    double v1[3], v2[3], v3[3];
     for (int i=0; i < 3; i++)
     {
         v1[i] = eigenVectors.col(2)(i);
@@ -139,11 +135,11 @@ void CovarianceFeaturesFilter::setDimensionality(PointView &view, const PointId
     double linearity  = (sqrt(lambda[0]) - sqrt(lambda[1])) / sqrt(lambda[0]);
     double planarity  = (sqrt(lambda[1]) - sqrt(lambda[2])) / sqrt(lambda[0]);
     double scattering =  sqrt(lambda[2]) / sqrt(lambda[0]);
-    view.setField(m_extraDims["Linearity"], id, linearity);
-    view.setField(m_extraDims["Planarity"], id, planarity);
-    view.setField(m_extraDims["Scattering"], id, scattering);
+    view.setField(m_linearity, id, linearity);
+    view.setField(m_planarity, id, planarity);
+    view.setField(m_scattering, id, scattering);
 
-    std::vector<double> unary_vector(3);
+    double unary_vector[3];
     double norm = 0;
     for (int i=0; i <3 ; i++)
     {
@@ -151,6 +147,6 @@ void CovarianceFeaturesFilter::setDimensionality(PointView &view, const PointId
         norm += unary_vector[i] * unary_vector[i];
     }
     norm = sqrt(norm);
-    view.setField(m_extraDims["Verticality"], id, unary_vector[2] / norm);
+    view.setField(m_verticality, id, unary_vector[2] / norm);
 }
 }
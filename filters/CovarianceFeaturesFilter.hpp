@@ -40,6 +40,8 @@
 
 namespace pdal {
 
+class NeighborhoodCovariance;
+
 class PDAL_DLL CovarianceFeaturesFilter: public Filter
 {
 public:
@@ -56,12 +58,16 @@ private:
     std::string m_featureSet;
     std::map<std::string,Dimension::Id> m_extraDims;
     size_t m_stride;
+    Dimension::Id m_linearity;
+    Dimension::Id m_planarity;
+    Dimension::Id m_scattering;
+    Dimension::Id m_verticality;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs &args);
     virtual void filter(PointView &view);
 
-    void setDimensionality(PointView &view, const PointId &id, const KD3Index &kid);
+    void setDimensionality(PointView &view, const PointId &id, NeighborhoodCovariance &neighborhood);
 };
 }
 
@@ -40,12 +40,14 @@
 #include <pdal/util/Bounds.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/GDALUtils.hpp>
+#include <pdal/private/ThreadRange.hpp>
 
 #include "private/Point.hpp"
-#include "private/pnp/GridPnp.hpp"
+#include "private/pnp/PolygonIndex.hpp"
 
 #include <sstream>
 #include <cstdarg>
+#include <mutex>
 
 namespace pdal
 {
@@ -67,15 +69,9 @@ struct CropArgs
     std::vector<filter::Point> m_centers;
     double m_distance;
     std::vector<Polygon> m_polys;
+    int m_threads;
 };
 
-CropFilter::ViewGeom::ViewGeom(const Polygon& poly) : m_poly(poly)
-{}
-
-CropFilter::ViewGeom::ViewGeom(ViewGeom&& vg) :
-    m_poly(std::move(vg.m_poly)), m_gridPnps(std::move(vg.m_gridPnps))
-{}
-
 std::string CropFilter::getName() const { return s_info.name; }
 
 CropFilter::CropFilter() : m_args(new CropArgs)
@@ -102,6 +98,8 @@ void CropFilter::addArgs(ProgramArgs& args)
     args.add("polygon", "Bounding polying for cropped points", m_args->m_polys).
         setErrorText("Invalid polygon specification.  "
             "Must be valid GeoJSON/WKT");
+    args.add("threads", "Number of threads used to crop when not "
+        "streaming", m_args->m_threads, 1);
 }
 
 
@@ -139,16 +137,35 @@ void CropFilter::ready(PointTableRef table)
                 "option.\n";
     }
     for (auto& geom : m_geoms)
-        geom.m_poly.setSpatialReference(m_args->m_assignedSrs);
+        geom.setSpatialReference(m_args->m_assignedSrs);
+
+    PointLayoutPtr layout(table.layout());
+    m_x = FieldAccessor<double>(layout, Dimension::Id::X);
+    m_y = FieldAccessor<double>(layout, Dimension::Id::Y);
+    m_z = FieldAccessor<double>(layout, Dimension::Id::Z);
 }
 
 
 bool CropFilter::processOne(PointRef& point)
 {
-    for (auto& g : m_geoms)
-        for (auto& gridPnp : g.m_gridPnps)
-            if (crop(point, *gridPnp))
-                return true;
+    if (m_geoms.size())
+    {
+        const char *data = point.constData();
+        double x = m_x.get(point, data);
+        double y = m_y.get(point, data);
+
+        size_t count = 0;
+        for (PolygonIndex::Id id : m_index->candidates(x, y))
+            if (m_index->contains(id, x, y))
+            {
+                if (!m_args->m_cropOutside)
+                    return true;
+                count++;
+            }
+        // When cropping outside, keep the point if it's outside any polygon.
+        if (m_args->m_cropOutside && count < m_geoms.size())
+            return true;
+    }
 
     for (auto& box : m_boxes)
         if (box.is3d())
@@ -179,25 +196,24 @@ void CropFilter::spatialReferenceChanged(const SpatialReference& srs)
 
 void CropFilter::transform(const SpatialReference& srs)
 {
+    m_index.reset(new PolygonIndex);
     for (auto& geom : m_geoms)
     {
         try
         {
-            geom.m_poly.transform(srs);
+            geom.transform(srs);
+            m_index->add(geom);
         }
         catch (pdal_error& err)
         {
             throwError(err.what());
         }
-        geom.m_gridPnps.clear();
-        std::vector<Polygon> polys = geom.m_poly.polygons();
-        for (auto& p : polys)
+        catch (grid_error& err)
         {
-            std::unique_ptr<GridPnp> gridPnp(new GridPnp(
-                p.exteriorRing(), p.interiorRings()));
-            geom.m_gridPnps.push_back(std::move(gridPnp));
+            throwError(err.what());
         }
     }
+    m_index->build();
 
     // If we don't have any SRS, do nothing.
     if (srs.empty() && m_args->m_assignedSrs.empty())
@@ -232,110 +248,189 @@ PointViewSet CropFilter::run(PointViewPtr view)
     PointViewSet viewSet;
 
     transform(view->spatialReference());
-    for (auto& geom : m_geoms)
-    {
-        PointViewPtr outView = view->makeNew();
-        crop(geom, *view, *outView);
-        viewSet.insert(outView);
-    }
 
-    for (auto& box : m_boxes)
+    // Find the points to keep for each crop region over ranges of points
+    // in parallel.  The output views are selected from the input, in its
+    // original order, once all the ranges are done.
+    const point_count_t MinPerThread = 10000;
+    int threads = (std::min)(m_args->m_threads,
+        (int)(view->size() / MinPerThread) + 1);
+    std::vector<KeepList> keeps;
+    std::mutex mutex;
+    forEachRange(view->size(), threads,
+        [this, &view, &keeps, &mutex](PointId begin, PointId end)
     {
-        PointViewPtr outView = view->makeNew();
-        crop(box, *view, *outView);
-        viewSet.insert(outView);
-    }
-
-    for (auto& point: m_args->m_centers)
+        KeepList keep;
+        crop(*view, begin, end, keep);
+        std::lock_guard<std::mutex> lock(mutex);
+        keeps.push_back(std::move(keep));
+    });
+
+    size_t regions = m_geoms.size() + m_boxes.size() +
+        m_args->m_centers.size();
+    std::vector<uint8_t> selection(view->size());
+    for (size_t region = 0; region < regions; ++region)
     {
-        PointViewPtr outView = view->makeNew();
-        crop(point, *view, *outView);
-        viewSet.insert(outView);
+        std::fill(selection.begin(), selection.end(), 0);
+        for (KeepList& keep : keeps)
+            for (PointId idx : keep[region])
+                selection[idx] = 1;
+        viewSet.insert(PointView::select(view, selection));
     }
 
     return viewSet;
 }
 
-bool CropFilter::crop(const PointRef& point, const BOX3D& box)
-{
-    double x = point.getFieldAs<double>(Dimension::Id::X);
-    double y = point.getFieldAs<double>(Dimension::Id::Y);
-    double z = point.getFieldAs<double>(Dimension::Id::Z);
-
-    // Return true if we're keeping a point.
-    return (m_args->m_cropOutside != box.contains(x, y, z));
-}
 
-bool CropFilter::crop(const PointRef& point, const BOX2D& box)
+// Determine the points in the range [begin, end) to keep for each crop
+// region.  Coordinates are read in batches so that each region is tested
+// in a tight loop over the batch.
+void CropFilter::crop(PointView& input, PointId begin, PointId end,
+    KeepList& keep)
 {
-    double x = point.getFieldAs<double>(Dimension::Id::X);
-    double y = point.getFieldAs<double>(Dimension::Id::Y);
+    const point_count_t BatchSize = 4096;
 
-    // Return true if we're keeping a point.
-    return (m_args->m_cropOutside != box.contains(x, y));
-}
+    bool needZ = false;
+    for (auto& box : m_boxes)
+        needZ |= box.is3d();
+    for (auto& center : m_args->m_centers)
+        needZ |= center.is3d();
+
+    keep.resize(m_geoms.size() + m_boxes.size() + m_args->m_centers.size());
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<double> zs;
+    std::vector<std::vector<size_t>> groups(m_geoms.size());
+    std::vector<double> gx;
+    std::vector<double> gy;
+    std::vector<char> inside;
+    for (PointId start = begin; start < end; start += BatchSize)
+    {
+        size_t count = (size_t)((std::min)(start + BatchSize, end) - start);
+        xs.resize(count);
+        ys.resize(count);
+        zs.resize(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            xs[i] = m_x.get(input, start + i);
+            ys[i] = m_y.get(input, start + i);
+            zs[i] = needZ ? m_z.get(input, start + i) : 0;
+        }
 
-void CropFilter::crop(const Bounds& box, PointView& input, PointView& output)
-{
-    bool is3d = box.is3d();
-    if (is3d)
-        crop(box.to3d(), input, output);
-    else
-        crop(box.to2d(), input, output);
+        // Polygons only need to be tested against the points that fall in
+        // cells of the index that the polygon's envelope overlaps.  Group
+        // the points of the batch by polygon so that each polygon can
+        // test its points at once.
+        if (m_geoms.size())
+        {
+            for (auto& group : groups)
+                group.clear();
+            for (size_t i = 0; i < count; ++i)
+                for (PolygonIndex::Id id : m_index->candidates(xs[i], ys[i]))
+                    groups[id].push_back(i);
+
+            for (size_t g = 0; g < m_geoms.size(); ++g)
+            {
+                const std::vector<size_t>& group = groups[g];
+                gx.resize(group.size());
+                gy.resize(group.size());
+                inside.resize(group.size());
+                for (size_t j = 0; j < group.size(); ++j)
+                {
+                    gx[j] = xs[group[j]];
+                    gy[j] = ys[group[j]];
+                }
+                m_index->contains(g, gx.data(), gy.data(), group.size(),
+                    inside.data());
+
+                std::vector<PointId>& k = keep[g];
+                if (!m_args->m_cropOutside)
+                {
+                    for (size_t j = 0; j < group.size(); ++j)
+                        if (inside[j])
+                            k.push_back(start + group[j]);
+                    continue;
+                }
+                // Points not in the group are outside the polygon.
+                size_t j = 0;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    bool in = false;
+                    if (j < group.size() && group[j] == i)
+                        in = inside[j++];
+                    if (!in)
+                        k.push_back(start + i);
+                }
+            }
+        }
 
-}
+        size_t region = m_geoms.size();
+        for (auto& b : m_boxes)
+        {
+            std::vector<PointId>& k = keep[region++];
+            if (b.is3d())
+            {
+                const BOX3D box = b.to3d();
+                for (size_t i = 0; i < count; ++i)
+                    if (m_args->m_cropOutside !=
+                            box.contains(xs[i], ys[i], zs[i]))
+                        k.push_back(start + i);
+            }
+            else
+            {
+                const BOX2D box = b.to2d();
+                for (size_t i = 0; i < count; ++i)
+                    if (m_args->m_cropOutside != box.contains(xs[i], ys[i]))
+                        k.push_back(start + i);
+            }
+        }
 
-void CropFilter::crop(const BOX3D& box, PointView& input, PointView& output)
-{
-    PointRef point = input.point(0);
-    for (PointId idx = 0; idx < input.size(); ++idx)
-    {
-        point.setPointId(idx);
-        if (crop(point, box))
-            output.appendPoint(input, idx);
+        for (auto& center : m_args->m_centers)
+        {
+            std::vector<PointId>& k = keep[region++];
+            for (size_t i = 0; i < count; ++i)
+                if (crop(xs[i], ys[i], zs[i], center))
+                    k.push_back(start + i);
+        }
     }
 }
 
-void CropFilter::crop(const BOX2D& box, PointView& input, PointView& output)
+
+bool CropFilter::crop(const PointRef& point, const BOX3D& box)
 {
-    PointRef point = input.point(0);
-    for (PointId idx = 0; idx < input.size(); ++idx)
-    {
-        point.setPointId(idx);
-        if (crop(point, box))
-            output.appendPoint(input, idx);
-    }
-}
+    const char *data = point.constData();
+    double x = m_x.get(point, data);
+    double y = m_y.get(point, data);
+    double z = m_z.get(point, data);
 
+    // Return true if we're keeping a point.
+    return (m_args->m_cropOutside != box.contains(x, y, z));
+}
 
-bool CropFilter::crop(const PointRef& point, GridPnp& g)
+bool CropFilter::crop(const PointRef& point, const BOX2D& box)
 {
-    double x = point.getFieldAs<double>(Dimension::Id::X);
-    double y = point.getFieldAs<double>(Dimension::Id::Y);
-    return (m_args->m_cropOutside != g.inside(x, y));
+    const char *data = point.constData();
+    double x = m_x.get(point, data);
+    double y = m_y.get(point, data);
+
+    // Return true if we're keeping a point.
+    return (m_args->m_cropOutside != box.contains(x, y));
 }
 
 
-void CropFilter::crop(const ViewGeom& g, PointView& input, PointView& output)
+bool CropFilter::crop(const PointRef& point, const filter::Point& center)
 {
-    PointRef point = input.point(0);
-    for (auto& gridPnp : g.m_gridPnps)
-    {
-        for (PointId idx = 0; idx < input.size(); ++idx)
-        {
-            point.setPointId(idx);
-            if (crop(point, const_cast<GridPnp&>(*gridPnp)))
-                output.appendPoint(input, idx);
-        }
-    }
+    const char *data = point.constData();
+    double x = m_x.get(point, data);
+    double y = m_y.get(point, data);
+    double z = center.is3d() ? m_z.get(point, data) : 0;
+    return crop(x, y, z, center);
 }
 
 
-bool CropFilter::crop(const PointRef& point, const filter::Point& center)
+bool CropFilter::crop(double x, double y, double z,
+    const filter::Point& center)
 {
-    double x = point.getFieldAs<double>(Dimension::Id::X);
-    double y = point.getFieldAs<double>(Dimension::Id::Y);
-
     x = std::abs(x - center.x());
     y = std::abs(y - center.y());
     if (x > m_args->m_distance || y > m_args->m_distance)
@@ -344,7 +439,6 @@ bool CropFilter::crop(const PointRef& point, const filter::Point& center)
     bool inside;
     if (center.is3d())
     {
-        double z = point.getFieldAs<double>(Dimension::Id::Z);
         z = std::abs(z - center.z());
         if (z > m_args->m_distance)
             return (m_args->m_cropOutside);
@@ -355,17 +449,4 @@ bool CropFilter::crop(const PointRef& point, const filter::Point& center)
     return (m_args->m_cropOutside != inside);
 }
 
-
-void CropFilter::crop(const filter::Point& center, PointView& input,
-    PointView& output)
-{
-    PointRef point = input.point(0);
-    for (PointId idx = 0; idx < input.size(); ++idx)
-    {
-        point.setPointId(idx);
-        if (crop(point, center))
-            output.appendPoint(input, idx);
-    }
-}
-
 } // namespace pdal
@@ -36,7 +36,9 @@
 
 #include <list>
 #include <memory>
+#include <vector>
 
+#include <pdal/FieldAccessor.hpp>
 #include <pdal/Filter.hpp>
 #include <pdal/Polygon.hpp>
 #include <pdal/Streamable.hpp>
@@ -45,7 +47,7 @@ namespace pdal
 {
 
 class ProgramArgs;
-class GridPnp;
+class PolygonIndex;
 struct CropArgs;
 namespace filter
 {
@@ -63,20 +65,18 @@ public:
     std::string getName() const;
 
 private:
-    // This is just a way to marry a (multi)polygon with a list of its
-    // GridPnp's that do the actual point-in-polygon operation.
-    struct ViewGeom
-    {
-        ViewGeom(const Polygon& poly);
-        ViewGeom(ViewGeom&& vg);
+    // Points to keep for each crop region, in the order polygons, bounds,
+    // points.
+    using KeepList = std::vector<std::vector<PointId>>;
 
-        Polygon m_poly;
-        std::vector<std::unique_ptr<GridPnp>> m_gridPnps;
-    };
     std::unique_ptr<CropArgs> m_args;
     double m_distance2;
-    std::vector<ViewGeom> m_geoms;
+    std::vector<Polygon> m_geoms;
+    std::unique_ptr<PolygonIndex> m_index;
     std::vector<Bounds> m_boxes;
+    FieldAccessor<double> m_x;
+    FieldAccessor<double> m_y;
+    FieldAccessor<double> m_z;
 
     void addArgs(ProgramArgs& args);
     virtual void initialize();
@@ -87,14 +87,9 @@ private:
     virtual PointViewSet run(PointViewPtr view);
     bool crop(const PointRef& point, const BOX2D& box);
     bool crop(const PointRef& point, const BOX3D& box);
-    void crop(const BOX3D& box, PointView& input, PointView& output);
-    void crop(const BOX2D& box, PointView& input, PointView& output);
-    void crop(const Bounds& box, PointView& input, PointView& output);
-    bool crop(const PointRef& point, GridPnp& g);
-    void crop(const ViewGeom& g, PointView& input, PointView& output);
     bool crop(const PointRef& point, const filter::Point& center);
-    void crop(const filter::Point& center, PointView& input,
-        PointView& output);
+    bool crop(double x, double y, double z, const filter::Point& center);
+    void crop(PointView& input, PointId begin, PointId end, KeepList& keep);
     void transform(const SpatialReference& srs);
 
     CropFilter& operator=(const CropFilter&); // not implemented
@@ -63,9 +63,7 @@ void DecimationFilter::addArgs(ProgramArgs& args)
 PointViewSet DecimationFilter::run(PointViewPtr inView)
 {
     PointViewSet viewSet;
-    PointViewPtr outView = inView->makeNew();
-    decimate(*inView.get(), *outView.get());
-    viewSet.insert(outView);
+    viewSet.insert(decimate(inView));
     return viewSet;
 }
 
@@ -82,11 +80,13 @@ bool DecimationFilter::processOne(PointRef& point)
 }
 
 
-void DecimationFilter::decimate(PointView& input, PointView& output)
+PointViewPtr DecimationFilter::decimate(PointViewPtr input)
 {
-    PointId last_idx = (std::min)(m_limit, input.size());
+    std::vector<uint8_t> keep(input->size());
+    PointId last_idx = (std::min)(m_limit, input->size());
     for (PointId idx = m_offset; idx < last_idx; idx += m_step)
-        output.appendPoint(input, idx);
+        keep[idx] = 1;
+    return PointView::select(input, keep);
 }
 
 } // pdal
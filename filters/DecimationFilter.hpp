@@ -60,7 +60,7 @@ private:
         { m_index = 0; }
     bool processOne(PointRef& point);
     PointViewSet run(PointViewPtr view);
-    void decimate(PointView& input, PointView& output);
+    PointViewPtr decimate(PointViewPtr input);
 
     DecimationFilter& operator=(const DecimationFilter&); // not implemented
     DecimationFilter(const DecimationFilter&); // not implemented
@@ -33,9 +33,11 @@
 ****************************************************************************/
 
 #include "EigenvaluesFilter.hpp"
+#include "private/Neighborhood.hpp"
 
 #include <pdal/EigenUtils.hpp>
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/ThreadRange.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
 #include <Eigen/Dense>
@@ -65,6 +67,8 @@ void EigenvaluesFilter::addArgs(ProgramArgs& args)
 {
     args.add("knn", "k-Nearest neighbors", m_knn, 8);
     args.add("normalize", "Normalize eigenvalues?", m_normalize, false);
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
 }
 
 
@@ -80,31 +84,34 @@ void EigenvaluesFilter::filter(PointView& view)
     using namespace Eigen;
 
     KD3Index& kdi = view.build3dIndex();
+    const XYZArrays coords(view);
 
-    for (PointId i = 0; i < view.size(); ++i)
+    forEachRange(view.size(), m_threads, [&](PointId begin, PointId end)
     {
-        // find the k-nearest neighbors
-        auto ids = kdi.neighbors(i, m_knn);
-
-        // compute covariance of the neighborhood
-        auto B = computeCovariance(view, ids);
-
-        // perform the eigen decomposition
-        SelfAdjointEigenSolver<Matrix3d> solver(B);
-        if (solver.info() != Success)
-            throwError("Cannot perform eigen decomposition.");
-        auto ev = solver.eigenvalues();
-
-        if (m_normalize)
+        NeighborhoodCovariance neighborhood(coords, kdi, m_knn);
+        Vector3d ev;
+        Matrix3d evec;
+        for (PointId i = begin; i < end; ++i)
         {
-            double sum = ev[0] + ev[1] + ev[2];
-            ev /= sum;
+            // find the k-nearest neighbors and compute the covariance of the
+            // neighborhood
+            Matrix3d B = neighborhood.compute(i);
+
+            // perform the eigen decomposition
+            if (!computeEigen3x3(B, ev, evec))
+                throwError("Cannot perform eigen decomposition.");
+
+            if (m_normalize)
+            {
+                double sum = ev[0] + ev[1] + ev[2];
+                ev /= sum;
+            }
+
+            view.setField(m_e0, i, ev[0]);
+            view.setField(m_e1, i, ev[1]);
+            view.setField(m_e2, i, ev[2]);
         }
-
-        view.setField(m_e0, i, ev[0]);
-        view.setField(m_e1, i, ev[1]);
-        view.setField(m_e2, i, ev[2]);
-    }
+    });
 }
 
 } // namespace pdal
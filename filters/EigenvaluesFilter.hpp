@@ -59,6 +59,7 @@ public:
 
 private:
     int m_knn;
+    int m_threads;
     Dimension::Id m_e0, m_e1, m_e2;
     bool m_normalize;
 
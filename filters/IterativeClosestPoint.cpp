@@ -33,13 +33,17 @@
  ****************************************************************************/
 
 #include "IterativeClosestPoint.hpp"
+#include "private/Neighborhood.hpp"
 
 #include <pdal/EigenUtils.hpp>
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/ThreadRange.hpp>
+#include <pdal/util/ProgramArgs.hpp>
 #include <pdal/util/Utils.hpp>
 
 #include <Eigen/Dense>
 
+#include <limits>
 #include <numeric>
 
 namespace pdal
@@ -70,6 +74,42 @@ void IterativeClosestPoint::addArgs(ProgramArgs& args)
     args.add("max_similar",
              "Max number of similar transforms to consider converged",
              m_max_similar, 0);
+    args.add("threads", "Number of threads used for correspondence search",
+             m_threads, 1);
+    args.add("levels", "Number of resolution levels, coarse to fine",
+             m_levels, 1);
+    args.add("stride", "Use every nth moving point at the finest level",
+             m_stride, 1);
+    args.add("objective",
+             "Error metric to minimize ('point2point' or 'point2plane')",
+             m_objective, "point2point");
+    args.add("knn", "k-Nearest neighbors used to estimate normals of the "
+             "fixed points for the 'point2plane' objective", m_knn, 8);
+}
+
+void IterativeClosestPoint::initialize()
+{
+    m_objective = Utils::tolower(m_objective);
+    if (m_objective == "point2plane")
+        m_pointToPlane = true;
+    else if (m_objective == "point2point")
+        m_pointToPlane = false;
+    else
+        throwError("Invalid objective '" + m_objective + "'. Must be "
+            "'point2point' or 'point2plane'.");
+
+    if (m_levels < 1)
+        throwError("Option 'levels' must be at least 1.");
+    if (m_stride < 1)
+        throwError("Option 'stride' must be at least 1.");
+    // The coarsest level uses every (stride << (levels - 1))th point.
+    if (m_levels > 63 || (PointId)m_stride >
+            ((std::numeric_limits<PointId>::max)() >> (m_levels - 1)))
+        throwError("Options 'levels' and 'stride' are too large. The "
+            "coarsest stride, stride * 2^(levels - 1), must fit in a "
+            "point ID.");
+    if (m_knn < 3)
+        throwError("Option 'knn' must be at least 3.");
 }
 
 PointViewSet IterativeClosestPoint::run(PointViewPtr view)
@@ -102,6 +142,114 @@ void IterativeClosestPoint::done(PointTableRef _)
     }
 }
 
+std::vector<double> IterativeClosestPoint::computeNormals(
+    const XYZArrays& fixed, const KD3Index& kdi) const
+{
+    // Normals of the fixed points don't change between iterations, so they
+    // are estimated once, three values per point.  Points whose
+    // neighborhood can't be decomposed get a zero normal and so don't
+    // contribute to the point-to-plane error.
+    std::vector<double> normals(fixed.size() * 3, 0.0);
+    forEachRange(fixed.size(), m_threads, [&](PointId begin, PointId end)
+    {
+        NeighborhoodCovariance neighborhood(fixed, kdi, m_knn + 1);
+        Eigen::Vector3d eval;
+        Eigen::Matrix3d evec;
+        for (PointId i = begin; i < end; ++i)
+        {
+            if (!computeEigen3x3(neighborhood.compute(i), eval, evec))
+                continue;
+            normals[3 * i] = evec(0, 0);
+            normals[3 * i + 1] = evec(1, 0);
+            normals[3 * i + 2] = evec(2, 0);
+        }
+    });
+    return normals;
+}
+
+double IterativeClosestPoint::correspond(const XYZArrays& fixed,
+    const XYZArrays& moving, const KD3Index& kdi,
+    const std::vector<double>& normals,
+    const Eigen::Matrix4d& transformation, PointId stride,
+    Eigen::Matrix4d& estimate) const
+{
+    using namespace Eigen;
+
+    const point_count_t samples = (moving.size() + stride - 1) / stride;
+    const Matrix3d R = transformation.block<3, 3>(0, 0);
+    const Vector3d t = transformation.block<3, 1>(0, 3);
+
+    // Each sample writes only its own column/row, so the correspondence
+    // search runs without synchronization.
+    Matrix3Xd src(3, samples);
+    Matrix3Xd dst(3, samples);
+    Matrix<double, Dynamic, 6> A;
+    VectorXd b;
+    if (m_pointToPlane)
+    {
+        A.resize(samples, 6);
+        b.resize(samples);
+    }
+    std::vector<double> dists(samples);
+
+    forEachRange(samples, m_threads, [&](PointId begin, PointId end)
+    {
+        PointIdList indices(1);
+        std::vector<double> sqr_dists(1);
+        for (PointId s = begin; s < end; ++s)
+        {
+            // Transform the moving point by the current estimate on the fly
+            // and find its nearest neighbor in the fixed points.
+            const PointId i = s * stride;
+            Vector3d p = R * Vector3d(moving.x[i], moving.y[i], moving.z[i]) +
+                t;
+            kdi.knnSearch(p.x(), p.y(), p.z(), 1, &indices, &sqr_dists);
+
+            // In the PCL code, there would've been a check that the square
+            // distance did not exceed a threshold value.
+            const PointId j = indices[0];
+            Vector3d q(fixed.x[j], fixed.y[j], fixed.z[j]);
+            src.col(s) = p;
+            dst.col(s) = q;
+            dists[s] = std::sqrt(sqr_dists[0]);
+
+            if (m_pointToPlane)
+            {
+                // Linearized point-to-plane residual (small angle
+                // approximation of the rotation).
+                Vector3d n(normals[3 * j], normals[3 * j + 1],
+                    normals[3 * j + 2]);
+                A.block<1, 3>(s, 0) = p.cross(n).transpose();
+                A.block<1, 3>(s, 3) = n.transpose();
+                b(s) = n.dot(q - p);
+            }
+        }
+    });
+
+    double mse = std::accumulate(dists.begin(), dists.end(), 0.0);
+    mse /= samples;
+
+    if (m_pointToPlane)
+    {
+        Matrix<double, 6, 6> AtA = A.transpose() * A;
+        Matrix<double, 6, 1> x = AtA.ldlt().solve(A.transpose() * b);
+        estimate.setIdentity();
+        estimate.block<3, 3>(0, 0) =
+            (AngleAxisd(x(2), Vector3d::UnitZ()) *
+             AngleAxisd(x(1), Vector3d::UnitY()) *
+             AngleAxisd(x(0), Vector3d::UnitX())).toRotationMatrix();
+        estimate.block<3, 1>(0, 3) = x.tail<3>();
+        if (!estimate.allFinite())
+            estimate.setIdentity();
+    }
+    else
+    {
+        // Estimate rigid transformation using Umeyama method.
+        estimate = umeyama(src, dst, false);
+    }
+    return mse;
+}
+
 PointViewPtr IterativeClosestPoint::icp(PointViewPtr fixed,
                                         PointViewPtr moving) const
 {
@@ -111,9 +259,17 @@ PointViewPtr IterativeClosestPoint::icp(PointViewPtr fixed,
     std::iota(ids.begin(), ids.end(), 0);
     auto centroid = computeCentroid(*fixed, ids);
 
-    // Demean the fixed and moving PointViews.
+    // Demean the fixed PointView and keep raw, centered coordinates of both
+    // the fixed and moving points.
     PointViewPtr tempFixed = demeanPointView(*fixed, centroid.data());
-    PointViewPtr tempMoving = demeanPointView(*moving, centroid.data());
+    const XYZArrays fixedXYZ(*tempFixed);
+    XYZArrays movingXYZ(*moving);
+    for (PointId i = 0; i < movingXYZ.size(); ++i)
+    {
+        movingXYZ.x[i] -= centroid.x();
+        movingXYZ.y[i] -= centroid.y();
+        movingXYZ.z[i] -= centroid.z();
+    }
 
     // Initialize the final_transformation to identity. In the future, it would
     // be reasonable to alternately accept an initial guess.
@@ -123,149 +279,117 @@ PointViewPtr IterativeClosestPoint::icp(PointViewPtr fixed,
     // nearest neighbor searches in each iteration.
     KD3Index& kd_fixed = tempFixed->build3dIndex();
 
-    // Iterate to the max number of iterations or until converged.
+    std::vector<double> normals;
+    if (m_pointToPlane)
+        normals = computeNormals(fixedXYZ, kd_fixed);
+
+    // Iterate from the coarsest to the finest level.  Each level uses half
+    // as many moving points as the next one, and runs to the max number of
+    // iterations or until converged.
     bool converged(false);
-    double prev_mse(0.0);
-    int num_similar(0);
-    for (int iter = 0; iter < m_max_iters; ++iter)
+    for (int level = 0; level < m_levels; ++level)
     {
-        // At the beginning of each iteration, transform our centered, moving
-        // PointView by the current final_transformation.
-        PointViewPtr tempMovingTransformed =
-            transform(*tempMoving, final_transformation.data());
-
-        // Create empty lists to hold point correspondences, and initialize MSE
-        // to zero.
-        PointIdList fixed_idx, moving_idx;
-        fixed_idx.reserve(tempMovingTransformed->size());
-        moving_idx.reserve(tempMovingTransformed->size());
-        double mse(0.0);
-
-        // For every point in the centered, moving PointView, find the nearest
-        // neighbor in the centered fixed PointView. Record the indices of each
-        // and update the MSE.
-        for (PointId i = 0; i < tempMovingTransformed->size(); ++i)
+        const PointId stride = (PointId)m_stride << (m_levels - 1 - level);
+        log()->get(LogLevel::Debug2) << "Level " << level << ", using every " <<
+            stride << " moving point(s)\n";
+
+        converged = false;
+        double prev_mse(0.0);
+        int num_similar(0);
+        for (int iter = 0; iter < m_max_iters; ++iter)
         {
-            // Find the index of the nearest neighbor, and the square distance
-            // between each point.
-            PointRef p = tempMovingTransformed->point(i);
-            PointIdList indices(1);
-            std::vector<double> sqr_dists(1);
-            kd_fixed.knnSearch(p, 1, &indices, &sqr_dists);
-
-            // In the PCL code, there would've been a check that the square
-            // distance did not exceed a threshold value.
-
-            // Store the indices of the correspondence and update the MSE.
-            moving_idx.push_back(i);
-            fixed_idx.push_back(indices[0]);
-            mse += std::sqrt(sqr_dists[0]);
-        }
-
-        // Finalize and log the MSE.
-        mse /= moving_idx.size();
-        log()->get(LogLevel::Debug2) << "MSE: " << mse << std::endl;
-
-        // Estimate rigid transformation using Umeyama method, logging the
-        // current translation in X and Y.
-        auto A = pointViewToEigen(*tempFixed, fixed_idx);
-        auto B = pointViewToEigen(*tempMovingTransformed, moving_idx);
-        auto T = Eigen::umeyama(B.transpose(), A.transpose(), false);
-        log()->get(LogLevel::Debug2) << "Current dx: " << T.coeff(0, 3) << ", "
-                                     << "dy: " << T.coeff(1, 3) << std::endl;
-
-        // Update the final_transformation and log the X and Y translations.
-        final_transformation = final_transformation * T;
-        log()->get(LogLevel::Debug2)
-            << "Cumulative dx: " << final_transformation.coeff(0, 3) << ", "
-            << "dy: " << final_transformation.coeff(1, 3) << std::endl;
-
-        bool is_similar = false;
-
-        // Compute and log the rotation and translation of the current
-        // transformation (not cumulative).
-        double cos_angle =
-            0.5 * (T.coeff(0, 0) + T.coeff(1, 1) + T.coeff(2, 2) - 1);
-        double translation_sqr = T.coeff(0, 3) * T.coeff(0, 3) +
-                                 T.coeff(1, 3) * T.coeff(1, 3) +
-                                 T.coeff(2, 3) * T.coeff(2, 3);
-        log()->get(LogLevel::Debug2) << "Rotation: " << cos_angle << std::endl;
-        log()->get(LogLevel::Debug2)
-            << "Translation: " << translation_sqr << std::endl;
-
-        // Check for change in MSE.
-        if (std::fabs(mse - prev_mse) < m_mse_abs)
-        {
-            if (num_similar >= m_max_similar)
+            // Find correspondences for the moving points, transformed by the
+            // current final_transformation, and estimate the transformation
+            // that best aligns them.
+            Eigen::Matrix4d T;
+            double mse = correspond(fixedXYZ, movingXYZ, kd_fixed, normals,
+                final_transformation, stride, T);
+            log()->get(LogLevel::Debug2) << "MSE: " << mse << std::endl;
+            log()->get(LogLevel::Debug2) << "Current dx: " << T.coeff(0, 3) <<
+                ", " << "dy: " << T.coeff(1, 3) << std::endl;
+
+            // Update the final_transformation and log the X and Y
+            // translations.  T was estimated on the already transformed
+            // points, so it is applied after final_transformation.
+            final_transformation = T * final_transformation;
+            log()->get(LogLevel::Debug2)
+                << "Cumulative dx: " << final_transformation.coeff(0, 3) <<
+                ", " << "dy: " << final_transformation.coeff(1, 3) <<
+                std::endl;
+
+            bool is_similar = false;
+
+            // Compute and log the rotation and translation of the current
+            // transformation (not cumulative).
+            double cos_angle =
+                0.5 * (T.coeff(0, 0) + T.coeff(1, 1) + T.coeff(2, 2) - 1);
+            double translation_sqr = T.coeff(0, 3) * T.coeff(0, 3) +
+                                     T.coeff(1, 3) * T.coeff(1, 3) +
+                                     T.coeff(2, 3) * T.coeff(2, 3);
+            log()->get(LogLevel::Debug2) << "Rotation: " << cos_angle <<
+                std::endl;
+            log()->get(LogLevel::Debug2)
+                << "Translation: " << translation_sqr << std::endl;
+
+            // Check for change in MSE.
+            if (std::fabs(mse - prev_mse) < m_mse_abs)
             {
-                converged = true;
-                log()->get(LogLevel::Debug2) << "converged via absolute MSE\n";
-                break;
+                if (num_similar >= m_max_similar)
+                {
+                    converged = true;
+                    log()->get(LogLevel::Debug2) <<
+                        "converged via absolute MSE\n";
+                    break;
+                }
+                is_similar = true;
             }
-            is_similar = true;
-        }
 
-        // If the rotation and translation satisfy the specified thresholds,
-        // mark as converged, and exit the for loop.
-        if ((cos_angle >= m_rotation_threshold) &&
-            (translation_sqr <= m_translation_threshold))
-        {
-            if (num_similar >= m_max_similar)
+            // If the rotation and translation satisfy the specified
+            // thresholds, mark as converged, and exit the for loop.
+            if ((cos_angle >= m_rotation_threshold) &&
+                (translation_sqr <= m_translation_threshold))
             {
-                converged = true;
-                log()->get(LogLevel::Debug2)
-                    << "converged via rotation/translation thresholds\n";
-                break;
+                if (num_similar >= m_max_similar)
+                {
+                    converged = true;
+                    log()->get(LogLevel::Debug2)
+                        << "converged via rotation/translation thresholds\n";
+                    break;
+                }
+                is_similar = true;
             }
-            is_similar = true;
-        }
 
-        if (is_similar)
-            ++num_similar;
-        else
-            num_similar = 0;
+            if (is_similar)
+                ++num_similar;
+            else
+                num_similar = 0;
 
-        prev_mse = mse;
-    }
-
-    // Apply the final_transformation to the moving PointView.
-    for (PointId i = 0; i < moving->size(); ++i)
-    {
-        double x =
-            moving->getFieldAs<double>(Dimension::Id::X, i) - centroid.x();
-        double y =
-            moving->getFieldAs<double>(Dimension::Id::Y, i) - centroid.y();
-        double z =
-            moving->getFieldAs<double>(Dimension::Id::Z, i) - centroid.z();
-        moving->setField(Dimension::Id::X, i,
-                         x * final_transformation.coeff(0, 0) +
-                             y * final_transformation.coeff(0, 1) +
-                             z * final_transformation.coeff(0, 2) +
-                             final_transformation.coeff(0, 3) + centroid.x());
-        moving->setField(Dimension::Id::Y, i,
-                         x * final_transformation.coeff(1, 0) +
-                             y * final_transformation.coeff(1, 1) +
-                             z * final_transformation.coeff(1, 2) +
-                             final_transformation.coeff(1, 3) + centroid.y());
-        moving->setField(Dimension::Id::Z, i,
-                         x * final_transformation.coeff(2, 0) +
-                             y * final_transformation.coeff(2, 1) +
-                             z * final_transformation.coeff(2, 2) +
-                             final_transformation.coeff(2, 3) + centroid.z());
+            prev_mse = mse;
+        }
     }
 
-    // Compute the MSE one last time, using the unaltered, fixed PointView and
-    // the transformed, moving PointView.
-    double mse(0.0);
-    KD3Index& kd_fixed_orig = fixed->build3dIndex();
-    for (PointId i = 0; i < moving->size(); ++i)
+    // Apply the final_transformation to the moving PointView and compute the
+    // MSE one last time, using all of the moving points.
+    const Eigen::Matrix3d R = final_transformation.block<3, 3>(0, 0);
+    const Eigen::Vector3d t = final_transformation.block<3, 1>(0, 3);
+    std::vector<double> dists(moving->size());
+    forEachRange(moving->size(), m_threads, [&](PointId begin, PointId end)
     {
-        PointRef p = moving->point(i);
         PointIdList indices(1);
         std::vector<double> sqr_dists(1);
-        kd_fixed_orig.knnSearch(p, 1, &indices, &sqr_dists);
-        mse += std::sqrt(sqr_dists[0]);
-    }
+        for (PointId i = begin; i < end; ++i)
+        {
+            Eigen::Vector3d p = R * Eigen::Vector3d(movingXYZ.x[i],
+                movingXYZ.y[i], movingXYZ.z[i]) + t;
+            kd_fixed.knnSearch(p.x(), p.y(), p.z(), 1, &indices, &sqr_dists);
+            dists[i] = std::sqrt(sqr_dists[0]);
+
+            moving->setField(Dimension::Id::X, i, p.x() + centroid.x());
+            moving->setField(Dimension::Id::Y, i, p.y() + centroid.y());
+            moving->setField(Dimension::Id::Z, i, p.z() + centroid.z());
+        }
+    });
+    double mse = std::accumulate(dists.begin(), dists.end(), 0.0);
     mse /= moving->size();
     log()->get(LogLevel::Debug2) << "MSE: " << mse << std::endl;
 
@@ -36,9 +36,14 @@
 
 #include <pdal/Filter.hpp>
 
+#include <Eigen/Dense>
+
 namespace pdal
 {
 
+class KD3Index;
+struct XYZArrays;
+
 class PDAL_DLL IterativeClosestPoint : public Filter
 {
 public:
@@ -53,11 +58,24 @@ private:
     double m_rotation_threshold;
     double m_translation_threshold;
     double m_mse_abs;
+    int m_threads;
+    int m_levels;
+    int m_stride;
+    int m_knn;
+    std::string m_objective;
+    bool m_pointToPlane;
 
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
     virtual PointViewSet run(PointViewPtr view);
     virtual void done(PointTableRef _);
     PointViewPtr icp(PointViewPtr fixed, PointViewPtr moving) const;
+    std::vector<double> computeNormals(const XYZArrays& fixed,
+        const KD3Index& kdi) const;
+    double correspond(const XYZArrays& fixed, const XYZArrays& moving,
+        const KD3Index& kdi, const std::vector<double>& normals,
+        const Eigen::Matrix4d& transformation, PointId stride,
+        Eigen::Matrix4d& estimate) const;
 
     PointViewPtr m_fixed;
     bool m_complete;
@@ -72,26 +72,27 @@ void MongoExpressionFilter::prepared(PointTableRef table)
         std::endl;
 
     m_expression = makeUnique<Expression>(*table.layout(), m_json);
+    // Resolve dimensions now so that points can be checked once the
+    // filter is prepared.  They're resolved again in ready(), since later
+    // stages may add dimensions.
+    m_expression->ready(table.layout());
 
     log()->get(LogLevel::Debug) << "Built expression: " << *m_expression <<
         std::endl;
 }
 
+void MongoExpressionFilter::ready(PointTableRef table)
+{
+    m_expression->ready(table.layout());
+}
+
 PointViewSet MongoExpressionFilter::run(PointViewPtr inView)
 {
     PointViewSet views;
-    PointViewPtr view(inView->makeNew());
-
-    for (PointId i(0); i < inView->size(); ++i)
-    {
-        PointRef pr(inView->point(i));
-        if (processOne(pr))
-        {
-            view->appendPoint(*inView, i);
-        }
-    }
-
-    views.insert(view);
+
+    std::vector<uint8_t> selection;
+    m_expression->check(*inView, selection);
+    views.insert(PointView::select(inView, selection));
     return views;
 }
 
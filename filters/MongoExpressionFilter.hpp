@@ -55,6 +55,7 @@ public:
 private:
     virtual void addArgs(ProgramArgs& args) override;
     virtual void prepared(PointTableRef table) override;
+    virtual void ready(PointTableRef table) override;
     virtual PointViewSet run(PointViewPtr view) override;
 
     NL::json m_json;
@@ -41,10 +41,12 @@
 // [2] https://github.com/CloudCompare/CloudCompare.
 
 #include "NormalFilter.hpp"
+#include "private/Neighborhood.hpp"
 #include "private/Point.hpp"
 
 #include <pdal/EigenUtils.hpp>
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/ThreadRange.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
 #include <Eigen/Dense>
@@ -70,6 +72,7 @@ struct NormalArgs
     filter::Point m_viewpoint;
     bool m_up;
     bool m_refine;
+    int m_threads;
 };
 
 NormalFilter::NormalFilter() : m_args(new NormalArgs), m_count(0) {}
@@ -91,6 +94,8 @@ void NormalFilter::addArgs(ProgramArgs& args)
     args.add("refine",
              "Refine normals using minimum spanning tree propagation?",
              m_args->m_refine, true);
+    args.add("threads", "Number of threads used to run this filter",
+             m_args->m_threads, 1);
 }
 
 void NormalFilter::addDimensions(PointLayoutPtr layout)
@@ -127,53 +132,65 @@ void NormalFilter::prepared(PointTableRef table)
 void NormalFilter::compute(PointView& view, KD3Index& kdi)
 {
     log()->get(LogLevel::Debug) << "Computing normal vectors\n";
-    for (auto&& p : view)
+
+    const XYZArrays coords(view);
+    const bool useViewpoint = m_viewpointArg->set();
+    Vector3d viewpoint;
+    if (useViewpoint)
+        viewpoint << m_args->m_viewpoint.x(), m_args->m_viewpoint.y(),
+            m_args->m_viewpoint.z();
+
+    // Each thread handles a contiguous range of points and owns its
+    // neighborhood buffers, so no allocation happens per point.
+    forEachRange(view.size(), m_args->m_threads,
+        [&](PointId begin, PointId end)
     {
-        // Perform eigen decomposition of covariance matrix computed from
-        // neighborhood composed of k-nearest neighbors.
-        PointIdList neighbors = kdi.neighbors(p.pointId(), m_args->m_knn);
-        auto B = computeCovariance(view, neighbors);
-        SelfAdjointEigenSolver<Matrix3d> solver(B);
-        if (solver.info() != Success)
-            throwError("Cannot perform eigen decomposition.");
-
-        // The curvature is computed as the ratio of the first (smallest)
-        // eigenvalue to the sum of all eigenvalues.
-        auto eval = solver.eigenvalues();
-        double sum = eval[0] + eval[1] + eval[2];
-        double curvature = sum ? std::fabs(eval[0] / sum) : 0;
-
-        // The normal is defined by the eigenvector corresponding to the
-        // smallest eigenvalue.
-        Vector3d normal = solver.eigenvectors().col(0);
-
-        if (m_viewpointArg->set())
-        {
-            // If a viewpoint has been specified, orient the normals to face the
-            // viewpoint by taking the dot product of the vector connecting the
-            // point with the viewpoint and the normal. Flip the normal, where
-            // the dot product is negative.
-            double dx = m_args->m_viewpoint.x() - p.getFieldAs<double>(Id::X);
-            double dy = m_args->m_viewpoint.y() - p.getFieldAs<double>(Id::Y);
-            double dz = m_args->m_viewpoint.z() - p.getFieldAs<double>(Id::Z);
-            Vector3d vp(dx, dy, dz);
-            if (vp.dot(normal) < 0)
-                normal *= -1.0;
-        }
-        else if (m_args->m_up)
+        NeighborhoodCovariance neighborhood(coords, kdi, m_args->m_knn);
+        Vector3d eval;
+        Matrix3d evec;
+        for (PointId i = begin; i < end; ++i)
         {
-            // If normals are expected to be upward facing, invert them when the
-            // Z component is negative.
-            if (normal[2] < 0)
-                normal *= -1.0;
-        }
+            // Perform eigen decomposition of covariance matrix computed from
+            // neighborhood composed of k-nearest neighbors.
+            Matrix3d B = neighborhood.compute(i);
+            if (!computeEigen3x3(B, eval, evec))
+                throwError("Cannot perform eigen decomposition.");
+
+            // The curvature is computed as the ratio of the first (smallest)
+            // eigenvalue to the sum of all eigenvalues.
+            double sum = eval[0] + eval[1] + eval[2];
+            double curvature = sum ? std::fabs(eval[0] / sum) : 0;
+
+            // The normal is defined by the eigenvector corresponding to the
+            // smallest eigenvalue.
+            Vector3d normal = evec.col(0);
+
+            if (useViewpoint)
+            {
+                // If a viewpoint has been specified, orient the normals to
+                // face the viewpoint by taking the dot product of the vector
+                // connecting the point with the viewpoint and the normal.
+                // Flip the normal, where the dot product is negative.
+                Vector3d vp(viewpoint[0] - coords.x[i],
+                    viewpoint[1] - coords.y[i], viewpoint[2] - coords.z[i]);
+                if (vp.dot(normal) < 0)
+                    normal *= -1.0;
+            }
+            else if (m_args->m_up)
+            {
+                // If normals are expected to be upward facing, invert them
+                // when the Z component is negative.
+                if (normal[2] < 0)
+                    normal *= -1.0;
+            }
 
-        // Set the computed normal and curvature dimensions.
-        p.setField(Id::NormalX, normal[0]);
-        p.setField(Id::NormalY, normal[1]);
-        p.setField(Id::NormalZ, normal[2]);
-        p.setField(Id::Curvature, curvature);
-    }
+            // Set the computed normal and curvature dimensions.
+            view.setField(Id::NormalX, i, normal[0]);
+            view.setField(Id::NormalY, i, normal[1]);
+            view.setField(Id::NormalZ, i, normal[2]);
+            view.setField(Id::Curvature, i, curvature);
+        }
+    });
 }
 
 void NormalFilter::update(
@@ -35,15 +35,56 @@
 #include "OutlierFilter.hpp"
 
 #include <pdal/KDIndex.hpp>
+#include <pdal/private/ThreadRange.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 #include <pdal/util/Utils.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
 #include <vector>
 
 namespace pdal
 {
 
+namespace
+{
+
+// nanoflann adaptor over interleaved X/Y/Z coordinates gathered from the
+// cells surrounding a cell being classified in stream mode.
+class CellCoords
+{
+public:
+    CellCoords(const std::vector<double>& coords) : m_coords(coords)
+    {}
+
+    std::size_t kdtree_get_point_count() const
+        { return m_coords.size() / 3; }
+    double kdtree_get_pt(const std::size_t idx, int dim) const
+        { return m_coords[idx * 3 + dim]; }
+    double kdtree_distance(const double *p1, const std::size_t idx,
+        size_t /*numDims*/) const
+    {
+        const double *p2 = m_coords.data() + idx * 3;
+        double d0 = p1[0] - p2[0];
+        double d1 = p1[1] - p2[1];
+        double d2 = p1[2] - p2[2];
+
+        return d0 * d0 + d1 * d1 + d2 * d2;
+    }
+    template <class BBOX> bool kdtree_get_bbox(BBOX&) const
+        { return false; }
+
+private:
+    const std::vector<double>& m_coords;
+};
+
+typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<
+    double, CellCoords, double>, CellCoords, 3, std::size_t> CellTree;
+
+} // unnamed namespace
+
 static StaticPluginInfo const s_info
 {
     "filters.outlier",
@@ -67,6 +108,33 @@ void OutlierFilter::addArgs(ProgramArgs& args)
     args.add("mean_k", "Mean number of neighbors", m_meanK, 8);
     args.add("multiplier", "Standard deviation threshold", m_multiplier, 2.0);
     args.add("class", "Class to use for noise points", m_class, ClassLabel::LowPoint);
+    args.add("threads", "Number of threads used to run this filter",
+        m_threads, 1);
+    args.add("cell", "Edge length of the XY cells that buffer points in "
+        "stream mode", m_cell, 10.0);
+    args.add("window", "Number of points read after a cell was last "
+        "touched before it is classified in stream mode", m_window,
+        (point_count_t)100000);
+}
+
+void OutlierFilter::initialize()
+{
+    if (Utils::iequals(m_method, "statistical"))
+        m_methodType = Method::Statistical;
+    else if (Utils::iequals(m_method, "radius"))
+        m_methodType = Method::Radius;
+    else
+        m_methodType = Method::Unknown;
+
+    if (m_cell <= 0)
+        throwError("Option 'cell' must be positive.");
+    if (m_window == 0)
+        throwError("Option 'window' must be positive.");
+
+    // The radius method only looks at the cells adjacent to the cell of
+    // a point, so cells must be at least as large as the radius.
+    if (m_methodType == Method::Radius)
+        m_cell = (std::max)(m_cell, m_radius);
 }
 
 void OutlierFilter::addDimensions(PointLayoutPtr layout)
@@ -81,12 +149,21 @@ Indices OutlierFilter::processRadius(PointViewPtr inView)
 
     point_count_t np = inView->size();
 
-    PointIdList inliers, outliers;
+    // A point is an inlier once more than m_minK points (including itself)
+    // are found within the radius, so neighbors are only counted, and only
+    // up to that limit.
+    const point_count_t limit = (point_count_t)m_minK + 1;
+    std::vector<char> inlier(np);
+    forEachRange(np, m_threads, [&](PointId begin, PointId end)
+    {
+        for (PointId i = begin; i < end; ++i)
+            inlier[i] = index.radiusCount(i, m_radius, limit) >= limit;
+    });
 
+    PointIdList inliers, outliers;
     for (PointId i = 0; i < np; ++i)
     {
-        auto ids = index.radius(i, m_radius);
-        if (ids.size() > size_t(m_minK))
+        if (inlier[i])
             inliers.push_back(i);
         else
             outliers.push_back(i);
@@ -109,21 +186,22 @@ Indices OutlierFilter::processStatistical(PointViewPtr inView)
     // we increase the count by one because the query point itself will
     // be included with a distance of 0
     point_count_t count = m_meanK + 1;
-    PointIdList indices(count);
-    std::vector<double> sqr_dists(count);
-    for (PointId i = 0; i < np; ++i)
+    forEachRange(np, m_threads, [&](PointId begin, PointId end)
     {
-
-        index.knnSearch(i, count, &indices, &sqr_dists);
-
-        for (size_t j = 1; j < count; ++j)
+        PointIdList indices(count);
+        std::vector<double> sqr_dists(count);
+        for (PointId i = begin; i < end; ++i)
         {
-            double delta = std::sqrt(sqr_dists[j]) - distances[i];
-            distances[i] += (delta / j);
+            std::fill(sqr_dists.begin(), sqr_dists.end(), 0.0);
+            index.knnSearch(i, count, &indices, &sqr_dists);
+
+            for (size_t j = 1; j < count; ++j)
+            {
+                double delta = std::sqrt(sqr_dists[j]) - distances[i];
+                distances[i] += (delta / j);
+            }
         }
-        indices.clear(); indices.resize(count);
-        sqr_dists.clear(); sqr_dists.resize(count);
-    }
+    });
 
     size_t n(0);
     double M1(0.0);
@@ -161,11 +239,11 @@ PointViewSet OutlierFilter::run(PointViewPtr inView)
         return viewSet;
 
     Indices indices;
-    if (Utils::iequals(m_method, "statistical"))
+    if (m_methodType == Method::Statistical)
     {
         indices = processStatistical(inView);
     }
-    else if (Utils::iequals(m_method, "radius"))
+    else if (m_methodType == Method::Radius)
     {
         indices = processRadius(inView);
     }
@@ -211,4 +289,221 @@ PointViewSet OutlierFilter::run(PointViewPtr inView)
     return viewSet;
 }
 
+void OutlierFilter::ready(PointTableRef table)
+{
+    m_dimTypes = table.layout()->dimTypes();
+    m_pointSize = 0;
+    for (auto& dt : m_dimTypes)
+        m_pointSize += Dimension::size(dt.m_type);
+    m_buf.resize(m_pointSize + 1);
+
+    m_cells.clear();
+    m_ready.clear();
+    m_seq = 0;
+    m_statCount = 0;
+    m_statMean = 0.0;
+    m_statM2 = 0.0;
+}
+
+// Find the cell containing a position.  Returns false if the position
+// can't be binned because it's NaN or too large.
+bool OutlierFilter::cellKey(double x, double y, CellKey& key) const
+{
+    // Leave room to address the neighbors of any cell.
+    const double limit =
+        (double)((std::numeric_limits<int64_t>::max)() / 2);
+
+    double cx = std::floor(x / m_cell);
+    double cy = std::floor(y / m_cell);
+    if (!(std::abs(cx) < limit && std::abs(cy) < limit))
+        return false;
+    key = CellKey((int64_t)cx, (int64_t)cy);
+    return true;
+}
+
+// A cell is stale once m_window points have been read since a point last
+// landed in it.  Cells that don't exist are always stale.
+bool OutlierFilter::stale(const CellKey& key, bool all) const
+{
+    if (all)
+        return true;
+    auto it = m_cells.find(key);
+    return it == m_cells.end() || m_seq - it->second.touched >= m_window;
+}
+
+bool OutlierFilter::processOne(PointRef& point)
+{
+    if (m_methodType == Method::Unknown)
+        return true;
+
+    double x = point.getFieldAs<double>(Dimension::Id::X);
+    double y = point.getFieldAs<double>(Dimension::Id::Y);
+    double z = point.getFieldAs<double>(Dimension::Id::Z);
+
+    // A point that can't be placed in a cell has no neighbors, so it's
+    // an outlier.
+    CellKey key;
+    if (!cellKey(x, y, key))
+    {
+        point.setField(Dimension::Id::Classification, m_class);
+        return true;
+    }
+
+    Cell& cell = m_cells[key];
+    cell.coords.push_back(x);
+    cell.coords.push_back(y);
+    cell.coords.push_back(z);
+    size_t offset = cell.held.size();
+    cell.held.resize(offset + m_pointSize);
+    point.getPackedData(m_dimTypes, cell.held.data() + offset);
+    cell.touched = m_seq++;
+
+    // Scanning the cells for completed neighborhoods on every point would
+    // be wasteful; a few times per window is enough.
+    if (m_seq % (std::max)(m_window / 4, (point_count_t)1) == 0)
+        release(false);
+
+    // The incoming point is held.  Its slot is reused for a point whose
+    // neighborhood is complete, if any.
+    return emit(point);
+}
+
+bool OutlierFilter::flushOne(PointRef& point)
+{
+    if (m_ready.empty())
+        release(true);
+    return emit(point);
+}
+
+bool OutlierFilter::emit(PointRef& point)
+{
+    if (m_ready.empty())
+        return false;
+
+    auto end = m_ready.begin() + m_pointSize + 1;
+    std::copy(m_ready.begin(), end, m_buf.begin());
+    m_ready.erase(m_ready.begin(), end);
+
+    point.setPackedData(m_dimTypes, m_buf.data() + 1);
+    if (m_buf[0])
+        point.setField(Dimension::Id::Classification, m_class);
+    return true;
+}
+
+// Classify held points in every cell whose 3x3 neighborhood is complete,
+// then drop cells that no held point can need as a neighbor any longer.
+void OutlierFilter::release(bool all)
+{
+    auto complete = [this, all](const CellKey& key)
+    {
+        for (int64_t i = -1; i <= 1; ++i)
+            for (int64_t j = -1; j <= 1; ++j)
+                if (!stale(CellKey(key.first + i, key.second + j), all))
+                    return false;
+        return true;
+    };
+
+    for (auto& c : m_cells)
+        if (c.second.held.size() && complete(c.first))
+            classify(c.first, c.second);
+
+    auto needed = [this](const CellKey& key)
+    {
+        for (int64_t i = -1; i <= 1; ++i)
+            for (int64_t j = -1; j <= 1; ++j)
+            {
+                auto it = m_cells.find(CellKey(key.first + i,
+                    key.second + j));
+                if (it != m_cells.end() && it->second.held.size())
+                    return true;
+            }
+        return false;
+    };
+
+    for (auto it = m_cells.begin(); it != m_cells.end();)
+    {
+        if (stale(it->first, all) && !needed(it->first))
+            it = m_cells.erase(it);
+        else
+            ++it;
+    }
+}
+
+void OutlierFilter::classify(const CellKey& key, Cell& cell)
+{
+    // Gather the cell's own points first so that held points keep their
+    // index, followed by the points of the surrounding cells.
+    std::vector<double> coords(cell.coords);
+    for (int64_t i = -1; i <= 1; ++i)
+        for (int64_t j = -1; j <= 1; ++j)
+        {
+            if (i == 0 && j == 0)
+                continue;
+            auto it = m_cells.find(CellKey(key.first + i, key.second + j));
+            if (it != m_cells.end())
+                coords.insert(coords.end(), it->second.coords.begin(),
+                    it->second.coords.end());
+        }
+
+    CellCoords adaptor(coords);
+    CellTree tree(3, adaptor, nanoflann::KDTreeSingleIndexAdaptorParams(100));
+    tree.buildIndex();
+
+    const size_t first = cell.firstHeld;
+    const size_t count = cell.coords.size() / 3 - first;
+    std::vector<char> outlier(count);
+    if (m_methodType == Method::Radius)
+    {
+        const point_count_t limit = (point_count_t)m_minK + 1;
+        for (size_t i = 0; i < count; ++i)
+        {
+            CountResultSet<double, std::size_t> resultSet(m_radius * m_radius,
+                limit);
+            tree.findNeighbors(resultSet, coords.data() + (first + i) * 3,
+                nanoflann::SearchParams());
+            outlier[i] = resultSet.size() < limit;
+        }
+    }
+    else
+    {
+        // The mean and standard deviation of the neighbor distances can't
+        // be known for the whole input, so the threshold is taken from the
+        // running statistics of all the points classified so far.
+        const size_t k = m_meanK + 1;
+        std::vector<std::size_t> indices(k);
+        std::vector<double> sqr_dists(k);
+        std::vector<double> distances(count, 0.0);
+        for (size_t i = 0; i < count; ++i)
+        {
+            size_t found = tree.knnSearch(coords.data() + (first + i) * 3, k,
+                indices.data(), sqr_dists.data());
+            for (size_t j = 1; j < found; ++j)
+            {
+                double delta = std::sqrt(sqr_dists[j]) - distances[i];
+                distances[i] += (delta / j);
+            }
+
+            m_statCount++;
+            double delta = distances[i] - m_statMean;
+            m_statMean += delta / m_statCount;
+            m_statM2 += delta * (distances[i] - m_statMean);
+        }
+
+        double stdev = m_statCount > 1 ?
+            std::sqrt(m_statM2 / (m_statCount - 1.0)) : 0.0;
+        double threshold = m_statMean + m_multiplier * stdev;
+        for (size_t i = 0; i < count; ++i)
+            outlier[i] = !(distances[i] < threshold);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        m_ready.push_back(outlier[i]);
+        auto pos = cell.held.begin() + i * m_pointSize;
+        m_ready.insert(m_ready.end(), pos, pos + m_pointSize);
+    }
+    cell.held.clear();
+    cell.firstHeld = cell.coords.size() / 3;
+}
+
 } // namespace pdal
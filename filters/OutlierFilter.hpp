@@ -35,10 +35,13 @@
 #pragma once
 
 #include <pdal/Filter.hpp>
+#include <pdal/Streamable.hpp>
 
+#include <deque>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace pdal
 {
@@ -51,7 +54,7 @@ struct Indices
     PointIdList outliers;
 };
 
-class PDAL_DLL OutlierFilter : public pdal::Filter
+class PDAL_DLL OutlierFilter : public pdal::Filter, public Streamable
 {
 public:
     OutlierFilter() : Filter()
@@ -61,15 +64,59 @@ public:
     std::string getName() const;
 
 private:
+    // In stream mode points are held in XY cells until the cell and its
+    // eight neighbors have been idle for m_window points.
+    struct Cell
+    {
+        Cell() : firstHeld(0), touched(0)
+        {}
+
+        std::vector<double> coords;  // X/Y/Z of every point seen in the cell.
+        std::vector<char> held;      // Packed data of points not yet emitted.
+        size_t firstHeld;            // Index of the first held point.
+        point_count_t touched;       // Sequence number of the last point.
+    };
+    typedef std::pair<int64_t, int64_t> CellKey;
+
+    enum class Method
+    {
+        Statistical,
+        Radius,
+        Unknown
+    };
+
     std::string m_method;
+    Method m_methodType;
     int m_minK;
     double m_radius;
     int m_meanK;
     double m_multiplier;
     uint8_t m_class;
+    int m_threads;
+    double m_cell;
+    point_count_t m_window;
+
+    std::map<CellKey, Cell> m_cells;
+    std::deque<char> m_ready;
+    std::vector<char> m_buf;
+    DimTypeList m_dimTypes;
+    size_t m_pointSize;
+    point_count_t m_seq;
+    point_count_t m_statCount;
+    double m_statMean;
+    double m_statM2;
 
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void addArgs(ProgramArgs& args);
+    virtual void initialize();
+    virtual void ready(PointTableRef table);
+    virtual bool processOne(PointRef& point);
+    virtual bool flushOne(PointRef& point);
+    bool cellKey(double x, double y, CellKey& key) const;
+    bool stale(const CellKey& key, bool all) const;
+    void release(bool all);
+    void classify(const CellKey& key, Cell& cell);
+    bool emit(PointRef& point);
     Indices processRadius(PointViewPtr inView);
     Indices processStatistical(PointViewPtr inView);
     virtual PointViewSet run(PointViewPtr view);
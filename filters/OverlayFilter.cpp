@@ -37,8 +37,11 @@
 #include <vector>
 
 #include <pdal/GDALUtils.hpp>
+#include <pdal/private/ThreadRange.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
+#include "private/pnp/PolygonIndex.hpp"
+
 namespace pdal
 {
 
@@ -52,6 +55,13 @@ static StaticPluginInfo const s_info
 
 CREATE_STATIC_STAGE(OverlayFilter, s_info)
 
+OverlayFilter::OverlayFilter() : m_ds(0), m_lyr(0)
+{}
+
+
+OverlayFilter::~OverlayFilter()
+{}
+
 
 void OverlayFilter::addArgs(ProgramArgs& args)
 {
@@ -64,6 +74,8 @@ void OverlayFilter::addArgs(ProgramArgs& args)
     args.add("query", "OGR SQL query to execute on the "
         "datasource to fetch geometry and attributes", m_query);
     args.add("layer", "Datasource layer to use", m_layer);
+    args.add("threads", "Number of threads used to assign values when "
+        "not streaming", m_threads, 1);
 }
 
 
@@ -125,6 +137,7 @@ void OverlayFilter::ready(PointTableRef table)
         feature = OGRFeaturePtr(OGR_L_GetNextFeature(m_lyr), featureDeleter);
     }
     while (feature);
+    m_index.reset();
 }
 
 
@@ -143,30 +156,69 @@ void OverlayFilter::spatialReferenceChanged(const SpatialReference& srs)
             throwError(err.what());
         }
     }
+    m_index.reset();
 }
 
 
-bool OverlayFilter::processOne(PointRef& point)
+// Index the polygons in their current spatial reference.
+void OverlayFilter::buildIndex()
 {
-    for (const auto& poly : m_polygons)
+    m_index.reset(new PolygonIndex);
+    try
     {
-        double x = point.getFieldAs<double>(Dimension::Id::X);
-        double y = point.getFieldAs<double>(Dimension::Id::Y);
-        if (poly.geom.contains(x, y))
-            point.setField(m_dim, poly.val);
+        for (auto& poly : m_polygons)
+            m_index->add(poly.geom);
     }
+    catch (const grid_error& err)
+    {
+        throwError(err.what());
+    }
+    m_index->build();
+}
+
+
+// When polygons overlap, the value of the last polygon containing the point
+// is assigned.
+bool OverlayFilter::processOne(PointRef& point)
+{
+    if (!m_index)
+        buildIndex();
+
+    double x = point.getFieldAs<double>(Dimension::Id::X);
+    double y = point.getFieldAs<double>(Dimension::Id::Y);
+    int64_t id = m_index->last(x, y);
+    if (id >= 0)
+        point.setField(m_dim, m_polygons[id].val);
     return true;
 }
 
 
 void OverlayFilter::filter(PointView& view)
 {
-    PointRef point(view, 0);
-    for (PointId id = 0; id < view.size(); ++id)
+    if (!m_index)
+        buildIndex();
+
+    // Find the containing polygon for ranges of points in parallel.  Values
+    // are set once all the threads are done.
+    std::vector<int64_t> ids(view.size());
+    auto classify = [this, &view, &ids](PointId begin, PointId end)
     {
-        point.setPointId(id);
-        processOne(point);
-    }
+        for (PointId idx = begin; idx < end; ++idx)
+        {
+            double x = view.getFieldAs<double>(Dimension::Id::X, idx);
+            double y = view.getFieldAs<double>(Dimension::Id::Y, idx);
+            ids[idx] = m_index->last(x, y);
+        }
+    };
+
+    const point_count_t MinPerThread = 10000;
+    int threads = (std::min)(m_threads,
+        (int)(view.size() / MinPerThread) + 1);
+    forEachRange(view.size(), threads, classify);
+
+    for (PointId idx = 0; idx < view.size(); ++idx)
+        if (ids[idx] >= 0)
+            view.setField(m_dim, idx, m_polygons[ids[idx]].val);
 }
 
 } // namespace pdal
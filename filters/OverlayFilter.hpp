@@ -57,6 +57,7 @@ typedef std::shared_ptr<void> OGRFeaturePtr;
 typedef std::shared_ptr<void> OGRGeometryPtr;
 
 class Arg;
+class PolygonIndex;
 
 class PDAL_DLL OverlayFilter : public Filter, public Streamable
 {
@@ -67,8 +68,8 @@ class PDAL_DLL OverlayFilter : public Filter, public Streamable
     };
 
 public:
-    OverlayFilter() : m_ds(0), m_lyr(0)
-    {}
+    OverlayFilter();
+    ~OverlayFilter();
 
     std::string getName() const { return "filters.overlay"; }
 
@@ -81,6 +82,8 @@ private:
     virtual void ready(PointTableRef table);
     virtual void filter(PointView& view);
 
+    void buildIndex();
+
     OverlayFilter& operator=(const OverlayFilter&) = delete;
     OverlayFilter(const OverlayFilter&) = delete;
 
@@ -95,6 +98,8 @@ private:
     std::string m_layer;
     Dimension::Id m_dim;
     std::vector<PolyVal> m_polygons;
+    std::unique_ptr<PolygonIndex> m_index;
+    int m_threads;
 };
 
 } // namespace pdal
@@ -96,9 +96,17 @@ void RangeFilter::prepared(PointTableRef table)
 // as ORs between ranges of the same dimension and ANDs between ranges
 // of different dimensions.  This is simple logic, but is probably the most
 // common case.
+void RangeFilter::ready(PointTableRef table)
+{
+    m_expression.reset(new ColumnExpression);
+    m_expression->compile(*DimRange::node(m_ranges));
+    m_expression->ready(table.layout());
+}
+
+
 bool RangeFilter::processOne(PointRef& point)
 {
-    return DimRange::pointPasses(m_ranges, point);
+    return m_expression->evaluate(point);
 }
 
 
@@ -108,16 +116,9 @@ PointViewSet RangeFilter::run(PointViewPtr inView)
     if (!inView->size())
         return viewSet;
 
-    PointViewPtr outView = inView->makeNew();
-
-    for (PointId i = 0; i < inView->size(); ++i)
-    {
-        PointRef point = inView->point(i);
-        if (processOne(point))
-            outView->appendPoint(*inView, i);
-    }
-
-    viewSet.insert(outView);
+    std::vector<uint8_t> selection;
+    m_expression->evaluate(*inView, selection);
+    viewSet.insert(PointView::select(inView, selection));
     return viewSet;
 }
 
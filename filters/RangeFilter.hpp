@@ -45,6 +45,7 @@ namespace pdal
 {
 
 struct DimRange;
+class ColumnExpression;
 
 class PDAL_DLL RangeFilter : public Filter,  public Streamable
 {
@@ -56,9 +57,11 @@ public:
 
 private:
     std::vector<DimRange> m_ranges;
+    std::unique_ptr<ColumnExpression> m_expression;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
+    virtual void ready(PointTableRef table);
     virtual bool processOne(PointRef& point);
     virtual PointViewSet run(PointViewPtr view);
 
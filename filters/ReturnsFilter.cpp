@@ -34,6 +34,7 @@
 
 #include "ReturnsFilter.hpp"
 
+#include <pdal/FieldAccessor.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
 namespace pdal
@@ -92,26 +93,33 @@ PointViewSet ReturnsFilter::run(PointViewPtr inView)
             throwError("Invalid output type: '" + r + "'.");
     }
 
-    PointViewPtr firstView = inView->makeNew();
-    PointViewPtr intermediateView = inView->makeNew();
-    PointViewPtr lastView = inView->makeNew();
-    PointViewPtr onlyView = inView->makeNew();
+    std::vector<uint8_t> first(inView->size());
+    std::vector<uint8_t> intermediate(inView->size());
+    std::vector<uint8_t> last(inView->size());
+    std::vector<uint8_t> only(inView->size());
 
-    for (PointId idx = 0; idx < inView->size(); idx++)
+    FieldAccessor<uint8_t> returnNumber(inView->layout(),
+        Dimension::Id::ReturnNumber);
+    FieldAccessor<uint8_t> numberOfReturns(inView->layout(),
+        Dimension::Id::NumberOfReturns);
+    auto classify = [&](PointId idx, char *data)
     {
-        PointRef p = inView->point(idx);
-        uint8_t rn = p.getFieldAs<uint8_t>(Dimension::Id::ReturnNumber);
-        uint8_t nr = p.getFieldAs<uint8_t>(Dimension::Id::NumberOfReturns);
-        if ((m_outputTypes & returnFirst) && (rn == 1) && (nr > 1))
-            firstView->appendPoint(*inView.get(), idx);
-        if ((m_outputTypes & returnIntermediate) && (rn > 1) && (rn < nr) &&
-            (nr > 2))
-            intermediateView->appendPoint(*inView.get(), idx);
-        if ((m_outputTypes & returnLast) && (rn == nr) && (nr > 1))
-            lastView->appendPoint(*inView.get(), idx);
-        if ((m_outputTypes & returnOnly) && (nr == 1))
-            onlyView->appendPoint(*inView.get(), idx);
-    }
+        uint8_t rn = data ? returnNumber.get(data) :
+            returnNumber.get(*inView, idx);
+        uint8_t nr = data ? numberOfReturns.get(data) :
+            numberOfReturns.get(*inView, idx);
+        first[idx] = (m_outputTypes & returnFirst) && (rn == 1) && (nr > 1);
+        intermediate[idx] = (m_outputTypes & returnIntermediate) &&
+            (rn > 1) && (rn < nr) && (nr > 2);
+        last[idx] = (m_outputTypes & returnLast) && (rn == nr) && (nr > 1);
+        only[idx] = (m_outputTypes & returnOnly) && (nr == 1);
+    };
+    inView->forEachPoint(classify);
+
+    PointViewPtr firstView = PointView::select(inView, first);
+    PointViewPtr intermediateView = PointView::select(inView, intermediate);
+    PointViewPtr lastView = PointView::select(inView, last);
+    PointViewPtr onlyView = PointView::select(inView, only);
 
     if (m_outputTypes & returnFirst)
     {
@@ -34,6 +34,16 @@
 
 #include "SortFilter.hpp"
 
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <random>
+
+#include <arbiter/arbiter.hpp>
+
+#include <pdal/util/FileUtils.hpp>
+
 namespace pdal
 {
 
@@ -48,12 +58,130 @@ CREATE_STATIC_STAGE(SortFilter, s_info)
 
 std::string SortFilter::getName() const { return s_info.name; }
 
+namespace
+{
+
+// Stable LSD radix sort of entries on their keys, 16 bits at a time.
+// Passes where every key has the same digit are skipped.
+template<typename T>
+void radixSort(std::vector<T>& entries)
+{
+    if (entries.size() < 1024)
+    {
+        std::stable_sort(entries.begin(), entries.end(),
+            [](const T& e1, const T& e2){ return e1.key < e2.key; });
+        return;
+    }
+
+    std::vector<T> temp(entries.size());
+    std::vector<size_t> counts(1 << 16);
+    for (int shift = 0; shift < 64; shift += 16)
+    {
+        std::fill(counts.begin(), counts.end(), 0);
+        for (const T& e : entries)
+            counts[(e.key >> shift) & 0xFFFF]++;
+        if (counts[(entries.front().key >> shift) & 0xFFFF] == entries.size())
+            continue;
+
+        size_t pos = 0;
+        for (size_t& c : counts)
+        {
+            size_t n = c;
+            c = pos;
+            pos += n;
+        }
+        for (const T& e : entries)
+            temp[counts[(e.key >> shift) & 0xFFFF]++] = e;
+        entries.swap(temp);
+    }
+}
+
+} // unnamed namespace
+
+
+// A sorted run of points in a temporary file.  Each record is the sort
+// key followed by the packed point.
+struct SortFilter::Run
+{
+    Run(const std::string& filename, size_t recordSize) :
+        m_filename(filename), m_recordSize(recordSize), m_count(0),
+        m_pos(0), m_end(0)
+    {}
+
+    ~Run()
+    {
+        m_in.close();
+        FileUtils::deleteFile(m_filename);
+    }
+
+    void open(point_count_t blockPoints)
+    {
+        m_in.open(m_filename, std::ios::in | std::ios::binary);
+        if (!m_in)
+            throw pdal_error("Unable to open temporary file '" +
+                m_filename + "'.");
+        m_block.resize(blockPoints * m_recordSize);
+    }
+
+    // Advance to the next record.  Returns false when the run is exhausted.
+    bool next()
+    {
+        m_pos += m_recordSize;
+        if (m_pos < m_end)
+            return true;
+        if (!m_count)
+            return false;
+
+        point_count_t count = (std::min)(m_count,
+            (point_count_t)(m_block.size() / m_recordSize));
+        m_in.read(m_block.data(), count * m_recordSize);
+        if (!m_in)
+            throw pdal_error("Error reading temporary file '" +
+                m_filename + "'.");
+        m_count -= count;
+        m_pos = 0;
+        m_end = count * m_recordSize;
+        return true;
+    }
+
+    uint64_t key() const
+    {
+        uint64_t k;
+        std::memcpy(&k, m_block.data() + m_pos, sizeof(k));
+        return k;
+    }
+
+    const char *point() const
+        { return m_block.data() + m_pos + sizeof(uint64_t); }
+
+    std::string m_filename;
+    size_t m_recordSize;
+    point_count_t m_count;
+    std::ifstream m_in;
+    std::vector<char> m_block;
+    size_t m_pos;
+    size_t m_end;
+};
+
+
+SortFilter::SortFilter() : m_pointSize(0), m_merging(false), m_next(0)
+{}
+
+
+SortFilter::~SortFilter()
+{}
+
+
 void SortFilter::addArgs(ProgramArgs& args)
 {
     args.add("dimension", "Dimension on which to sort", m_dimName).
         setPositional();
     args.add("order", "Sort order ASC(ending) or DESC(ending)", m_order,
         SortOrder::ASC);
+    args.add("buffer_size", "Megabytes of point data to sort in memory "
+        "before spilling to temporary files (stream mode)", m_bufferSize,
+        (uint64_t)1024);
+    args.add("temp_dir", "Directory for temporary files", m_tempDir);
 }
 
 void SortFilter::prepared(PointTableRef table)
@@ -63,15 +191,207 @@ void SortFilter::prepared(PointTableRef table)
         throwError("Dimension '" + m_dimName + "' not found.");
 }
 
+void SortFilter::ready(PointTableRef table)
+{
+    m_dimTypes = table.layout()->dimTypes();
+    m_pointSize = table.layout()->pointSize();
+
+    std::string temp(m_tempDir.size() ? m_tempDir : arbiter::getTempPath());
+    m_tempBase = temp + "/pdal-sort-" + std::to_string(std::random_device()());
+    clear();
+}
+
+// Keys are mapped to unsigned integers that order the same way as the
+// values (descending if requested), so ties keep their input order.
+uint64_t SortFilter::key(double d) const
+{
+    // Make -0 and 0 equal.
+    if (d == 0)
+        d = 0;
+
+    uint64_t k;
+    std::memcpy(&k, &d, sizeof(k));
+    const uint64_t signBit = 1ULL << 63;
+    k = (k & signBit) ? ~k : (k | signBit);
+    return (m_order == SortOrder::ASC) ? k : ~k;
+}
+
 void SortFilter::filter(PointView& view)
 {
-    auto cmp = [this](const PointRef& p1, const PointRef& p2)
+    // Extract the keys once rather than fetching fields on each comparison.
+    std::vector<Entry> entries(view.size());
+    for (PointId idx = 0; idx < view.size(); ++idx)
+        entries[idx] = { key(view.getFieldAs<double>(m_dim, idx)), idx };
+    radixSort(entries);
+
+    // Move the points into sorted order with swaps.  'where' holds the
+    // current position of each original point and 'at' the original point
+    // at each position.
+    std::vector<PointId> where(view.size());
+    std::vector<PointId> at(view.size());
+    for (PointId idx = 0; idx < view.size(); ++idx)
+        where[idx] = at[idx] = idx;
+    for (PointId idx = 0; idx < view.size(); ++idx)
+    {
+        const PointId orig = entries[idx].id;
+        const PointId pos = where[orig];
+        if (pos == idx)
+            continue;
+        PointRef::swap(PointRef(view, idx), PointRef(view, pos));
+        const PointId displaced = at[idx];
+        at[idx] = orig;
+        at[pos] = displaced;
+        where[orig] = idx;
+        where[displaced] = pos;
+    }
+}
+
+// Every point is held until the input is exhausted.
+bool SortFilter::processOne(PointRef& point)
+{
+    m_entries.push_back({ key(point.getFieldAs<double>(m_dim)),
+        (PointId)m_entries.size() });
+    size_t offset = m_data.size();
+    m_data.resize(offset + m_pointSize);
+    point.getPackedData(m_dimTypes, m_data.data() + offset);
+
+    if (m_data.size() + m_entries.size() * sizeof(Entry) >=
+            m_bufferSize * 1024 * 1024)
+        spill();
+    return false;
+}
+
+// Sort the points in memory and write them, with their keys, to a
+// temporary file.
+void SortFilter::spill()
+{
+    radixSort(m_entries);
+
+    const size_t recordSize = sizeof(uint64_t) + m_pointSize;
+    std::unique_ptr<Run> run(new Run(m_tempBase + "-" +
+        std::to_string(m_runs.size()) + ".bin", recordSize));
+    std::ofstream out(run->m_filename,
+        std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!out)
+        throwError("Unable to create temporary file '" +
+            run->m_filename + "'.");
+
+    const size_t BlockPoints = 1 << 16;
+    std::vector<char> block;
+    block.reserve(BlockPoints * recordSize);
+    for (size_t i = 0; i < m_entries.size(); ++i)
+    {
+        const Entry& e = m_entries[i];
+        const char *k = reinterpret_cast<const char *>(&e.key);
+        block.insert(block.end(), k, k + sizeof(e.key));
+        const char *p = m_data.data() + e.id * m_pointSize;
+        block.insert(block.end(), p, p + m_pointSize);
+        if (block.size() == BlockPoints * recordSize ||
+            i == m_entries.size() - 1)
+        {
+            out.write(block.data(), block.size());
+            block.clear();
+        }
+    }
+    out.close();
+    if (!out)
+        throwError("Error writing temporary file '" +
+            run->m_filename + "'.");
+
+    log()->get(LogLevel::Debug) << "Wrote " << m_entries.size() <<
+        " sorted points to '" << run->m_filename << "'." << std::endl;
+    run->m_count = m_entries.size();
+    m_runs.push_back(std::move(run));
+    m_entries.clear();
+    m_data.clear();
+}
+
+void SortFilter::startMerge()
+{
+    m_merging = true;
+    if (m_runs.empty())
+    {
+        radixSort(m_entries);
+        m_next = 0;
+        return;
+    }
+
+    if (m_entries.size())
+        spill();
+    std::vector<char>().swap(m_data);
+    std::vector<Entry>().swap(m_entries);
+
+    // Share the memory budget among the runs' read buffers.
+    const size_t recordSize = sizeof(uint64_t) + m_pointSize;
+    point_count_t blockPoints = (m_bufferSize * 1024 * 1024) /
+        (m_runs.size() * recordSize);
+    blockPoints = Utils::clamp(blockPoints, (point_count_t)1024,
+        (point_count_t)65536);
+    for (size_t i = 0; i < m_runs.size(); ++i)
+    {
+        Run& r = *m_runs[i];
+        r.open(blockPoints);
+        r.m_pos = r.m_end = 0;
+        if (r.next())
+            m_heap.push_back({ r.key(), i });
+    }
+
+    // Ties are broken by run number, so the merge is stable.
+    std::make_heap(m_heap.begin(), m_heap.end(),
+        std::greater<std::pair<uint64_t, size_t>>());
+}
+
+bool SortFilter::flushOne(PointRef& point)
+{
+    if (!m_merging)
+        startMerge();
+
+    // Once drained, start over so that more input can be sorted.
+    if (m_runs.empty())
+    {
+        if (m_next == m_entries.size())
+        {
+            clear();
+            return false;
+        }
+        point.setPackedData(m_dimTypes,
+            m_data.data() + m_entries[m_next++].id * m_pointSize);
+        return true;
+    }
+
+    if (m_heap.empty())
     {
-        bool result = p1.compare(m_dim, p2);
-        return (m_order == SortOrder::ASC) ? result : !result;
-    };
+        clear();
+        return false;
+    }
 
-    std::stable_sort(view.begin(), view.end(), cmp);
+    auto cmp = std::greater<std::pair<uint64_t, size_t>>();
+    std::pop_heap(m_heap.begin(), m_heap.end(), cmp);
+    Run& r = *m_runs[m_heap.back().second];
+    point.setPackedData(m_dimTypes, r.point());
+    if (r.next())
+    {
+        m_heap.back().first = r.key();
+        std::push_heap(m_heap.begin(), m_heap.end(), cmp);
+    }
+    else
+        m_heap.pop_back();
+    return true;
+}
+
+void SortFilter::done(PointTableRef)
+{
+    clear();
+}
+
+void SortFilter::clear()
+{
+    std::vector<char>().swap(m_data);
+    std::vector<Entry>().swap(m_entries);
+    m_runs.clear();
+    m_heap.clear();
+    m_merging = false;
+    m_next = 0;
 }
 
 std::istream& operator >> (std::istream& in, SortOrder& order)
@@ -34,7 +34,10 @@
 
 #pragma once
 
+#include <memory>
+
 #include <pdal/Filter.hpp>
+#include <pdal/Streamable.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
 namespace pdal
@@ -50,15 +53,23 @@ std::istream& operator >> (std::istream& in, SortOrder& order);
 std::ostream& operator << (std::ostream& in, const SortOrder& order);
 
 
-class PDAL_DLL SortFilter : public Filter
+class PDAL_DLL SortFilter : public Filter, public Streamable
 {
 public:
-    SortFilter()
-    {}
+    SortFilter();
+    ~SortFilter();
 
     std::string getName() const;
 
 private:
+    // A sort key and the position of the point it was taken from.
+    struct Entry
+    {
+        uint64_t key;
+        PointId id;
+    };
+    struct Run;
+
     // Dimension on which to sort.
     Dimension::Id m_dim;
     // Dimension name.
@@ -67,9 +78,32 @@ private:
     // Sort order.
     SortOrder m_order;
 
+    // Stream mode: sorted runs of at most m_bufferSize megabytes are
+    // written to temporary files and merged once the input is exhausted.
+    uint64_t m_bufferSize;
+    std::string m_tempDir;
+    std::string m_tempBase;
+    DimTypeList m_dimTypes;
+    size_t m_pointSize;
+    std::vector<char> m_data;
+    std::vector<Entry> m_entries;
+    std::vector<std::unique_ptr<Run>> m_runs;
+    std::vector<std::pair<uint64_t, size_t>> m_heap;
+    bool m_merging;
+    size_t m_next;
+
     virtual void addArgs(ProgramArgs& args);
     virtual void prepared(PointTableRef table);
+    virtual void ready(PointTableRef table);
     virtual void filter(PointView& view);
+    virtual bool processOne(PointRef& point);
+    virtual bool flushOne(PointRef& point);
+    virtual void done(PointTableRef table);
+
+    uint64_t key(double d) const;
+    void spill();
+    void startMerge();
+    void clear();
 
     SortFilter& operator=(const SortFilter&) = delete;
     SortFilter(const SortFilter&) = delete;
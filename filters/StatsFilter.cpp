@@ -135,12 +135,8 @@ using namespace stats;
 
 bool StatsFilter::processOne(PointRef& point)
 {
-    for (auto p = m_stats.begin(); p != m_stats.end(); ++p)
-    {
-        Dimension::Id d = p->first;
-        Summary& c = p->second;
-        c.insert(point.getFieldAs<double>(d));
-    }
+    for (auto& f : m_fields)
+        f.second->insert(f.first.get(point));
     return true;
 }
 
@@ -239,6 +235,15 @@ void StatsFilter::prepared(PointTableRef table)
 }
 
 
+void StatsFilter::ready(PointTableRef table)
+{
+    m_fields.clear();
+    for (auto& s : m_stats)
+        m_fields.push_back(std::make_pair(
+            FieldAccessor<double>(table.layout(), s.first), &s.second));
+}
+
+
 void StatsFilter::extractMetadata(PointTableRef table)
 {
     uint32_t position(0);
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <pdal/FieldAccessor.hpp>
 #include <pdal/Filter.hpp>
 #include <pdal/Streamable.hpp>
 
@@ -227,6 +228,7 @@ private:
     virtual void addArgs(ProgramArgs& args);
     virtual bool processOne(PointRef& point);
     virtual void prepared(PointTableRef table);
+    virtual void ready(PointTableRef table);
     virtual void done(PointTableRef table);
     virtual void filter(PointView& view);
     void extractMetadata(PointTableRef table);
@@ -237,6 +239,7 @@ private:
     StringList m_global;
     bool m_advanced;
     std::map<Dimension::Id, stats::Summary> m_stats;
+    std::vector<std::pair<FieldAccessor<double>, stats::Summary *>> m_fields;
 };
 
 } // namespace pdal
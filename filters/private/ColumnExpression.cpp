@@ -0,0 +1,472 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "ColumnExpression.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace pdal
+{
+
+namespace
+{
+
+// Number of points evaluated at a time.
+const size_t BlockSize = 4096;
+
+} // unnamed namespace
+
+
+ColumnExpression::NodePtr ColumnExpression::range(Dimension::Id dim,
+    double lower, double upper, bool lowerInclusive, bool upperInclusive,
+    bool negate)
+{
+    NodePtr node(new Node(Node::Type::Range));
+    node->m_dim = dim;
+    node->m_lower = lower;
+    node->m_upper = upper;
+    node->m_lowerInclusive = lowerInclusive;
+    node->m_upperInclusive = upperInclusive;
+    node->m_negate = negate;
+    return node;
+}
+
+
+ColumnExpression::NodePtr ColumnExpression::compare(Dimension::Id dim,
+    Compare op, double value)
+{
+    const double inf = std::numeric_limits<double>::infinity();
+
+    // Every comparison with NaN but inequality is false.
+    if (std::isnan(value))
+        return constant(op == Compare::Ne);
+
+    switch (op)
+    {
+    case Compare::Eq:
+        return range(dim, value, value, true, true);
+    case Compare::Ne:
+        return range(dim, value, value, true, true, true);
+    case Compare::Lt:
+        return range(dim, -inf, value, true, false);
+    case Compare::Lte:
+        return range(dim, -inf, value, true, true);
+    case Compare::Gt:
+        return range(dim, value, inf, false, true);
+    case Compare::Gte:
+    default:
+        return range(dim, value, inf, true, true);
+    }
+}
+
+
+ColumnExpression::NodePtr ColumnExpression::compare(Dimension::Id dim,
+    Compare op, Dimension::Id other)
+{
+    NodePtr node(new Node(Node::Type::CompareDim));
+    node->m_dim = dim;
+    node->m_compare = op;
+    node->m_other = other;
+    return node;
+}
+
+
+ColumnExpression::NodePtr ColumnExpression::in(Dimension::Id dim,
+    const std::vector<double>& values,
+    const std::vector<Dimension::Id>& others, bool negate)
+{
+    NodePtr node(new Node(Node::Type::In));
+    node->m_dim = dim;
+    node->m_values = values;
+    node->m_others = others;
+    node->m_negate = negate;
+    return node;
+}
+
+
+ColumnExpression::NodePtr ColumnExpression::logical(Logic op,
+    NodeList children)
+{
+    if (op == Logic::Not && children.size() != 1)
+        throw pdal_error("Logical NOT requires a single expression.");
+
+    NodePtr node(new Node(Node::Type::Logic));
+    node->m_logic = op;
+    node->m_children = std::move(children);
+    return node;
+}
+
+
+ColumnExpression::NodePtr ColumnExpression::constant(bool value)
+{
+    NodePtr node(new Node(Node::Type::Constant));
+    node->m_value = value;
+    return node;
+}
+
+
+ColumnExpression::ColumnExpression() : m_depth(0), m_maxDepth(0)
+{
+    Step step(Step::Op::Constant, Mode::Set);
+    step.m_value = true;
+    push(step);
+}
+
+
+void ColumnExpression::compile(const Node& root)
+{
+    m_steps.clear();
+    m_dims.clear();
+    m_accessors.clear();
+    m_depth = 0;
+    m_maxDepth = 0;
+    compileNode(root, Mode::Set);
+}
+
+
+// Tests are combined into the mask on the top of a stack.  A test
+// compiled with Mode::Set starts a new mask.  Nested ANDs and ORs of the
+// same kind are flattened into a single mask, so only a change of
+// operator requires a new mask and a step to combine it with the one
+// below.
+void ColumnExpression::compileNode(const Node& node, Mode mode)
+{
+    switch (node.m_type)
+    {
+    case Node::Type::Range:
+    {
+        // Make both bounds inclusive so that each value is tested with a
+        // pair of comparisons.  A NaN bound doesn't limit the range.  An
+        // exclusive bound at the far end of the range of doubles excludes
+        // every value, so it's made NaN, which fails every comparison.
+        const double inf = std::numeric_limits<double>::infinity();
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+
+        Step step(Step::Op::Range, mode);
+        step.m_column = column(node.m_dim);
+        step.m_lower = node.m_lower;
+        if (std::isnan(node.m_lower))
+            step.m_lower = -inf;
+        else if (!node.m_lowerInclusive)
+            step.m_lower = (node.m_lower == inf) ? nan :
+                std::nextafter(node.m_lower, inf);
+        step.m_upper = node.m_upper;
+        if (std::isnan(node.m_upper))
+            step.m_upper = inf;
+        else if (!node.m_upperInclusive)
+            step.m_upper = (node.m_upper == -inf) ? nan :
+                std::nextafter(node.m_upper, -inf);
+        step.m_negate = node.m_negate;
+        push(step);
+        break;
+    }
+    case Node::Type::CompareDim:
+    {
+        Step step(Step::Op::CompareDim, mode);
+        step.m_column = column(node.m_dim);
+        step.m_other = column(node.m_other);
+        step.m_compare = node.m_compare;
+        push(step);
+        break;
+    }
+    case Node::Type::In:
+    {
+        Step step(Step::Op::In, mode);
+        step.m_column = column(node.m_dim);
+        step.m_values = node.m_values;
+        for (Dimension::Id other : node.m_others)
+            step.m_others.push_back(column(other));
+        step.m_negate = node.m_negate;
+        push(step);
+        break;
+    }
+    case Node::Type::Constant:
+    {
+        Step step(Step::Op::Constant, mode);
+        step.m_value = node.m_value;
+        push(step);
+        break;
+    }
+    case Node::Type::Logic:
+    {
+        const NodeList& children = node.m_children;
+        if (node.m_logic == Logic::Not)
+        {
+            compileNode(*children.front(), Mode::Set);
+            push(Step(Step::Op::Not, Mode::Set));
+        }
+        else
+        {
+            Mode inner = (node.m_logic == Logic::And) ? Mode::And : Mode::Or;
+            if (children.empty())
+            {
+                Step step(Step::Op::Constant, mode);
+                step.m_value = (node.m_logic == Logic::And);
+                push(step);
+                return;
+            }
+            if (mode == inner)
+            {
+                for (const NodePtr& child : children)
+                    compileNode(*child, inner);
+                return;
+            }
+            compileNode(*children.front(), Mode::Set);
+            for (size_t i = 1; i < children.size(); ++i)
+                compileNode(*children[i], inner);
+        }
+
+        // The node's result is on the top of the stack.  Combine it
+        // with the mask below if necessary.
+        if (mode == Mode::And)
+            push(Step(Step::Op::And, Mode::Set));
+        else if (mode == Mode::Or)
+            push(Step(Step::Op::Or, Mode::Set));
+        break;
+    }
+    }
+}
+
+
+void ColumnExpression::push(Step step)
+{
+    switch (step.m_op)
+    {
+    case Step::Op::And:
+    case Step::Op::Or:
+        m_depth--;
+        break;
+    case Step::Op::Not:
+        break;
+    default:
+        if (step.m_mode == Mode::Set)
+            m_depth++;
+        break;
+    }
+    m_maxDepth = (std::max)(m_maxDepth, m_depth);
+    m_steps.push_back(std::move(step));
+}
+
+
+size_t ColumnExpression::column(Dimension::Id dim)
+{
+    for (size_t i = 0; i < m_dims.size(); ++i)
+        if (m_dims[i] == dim)
+            return i;
+    m_dims.push_back(dim);
+    return m_dims.size() - 1;
+}
+
+
+void ColumnExpression::ready(PointLayoutPtr layout)
+{
+    m_accessors.clear();
+    for (Dimension::Id dim : m_dims)
+        m_accessors.push_back(FieldAccessor<double>(layout, dim));
+    m_columns.assign(m_dims.size(), std::vector<double>(BlockSize));
+    // The bottom mask is the output.
+    m_masks.assign(m_maxDepth ? m_maxDepth - 1 : 0,
+        std::vector<uint8_t>(BlockSize));
+    m_temp.resize(BlockSize);
+}
+
+
+// Points are read in order with forEachPoint() so that a view selected
+// from another doesn't have to build its index.
+void ColumnExpression::evaluate(PointView& view,
+    std::vector<uint8_t>& selection) const
+{
+    selection.resize(view.size());
+
+    size_t count = 0;
+    auto gather = [this, &view, &selection, &count](PointId idx, char *data)
+    {
+        for (size_t c = 0; c < m_accessors.size(); ++c)
+        {
+            const FieldAccessor<double>& acc = m_accessors[c];
+            m_columns[c][count] = data ? acc.get(data) : acc.get(view, idx);
+        }
+        if (++count == BlockSize)
+        {
+            run(count, selection.data() + idx + 1 - count);
+            count = 0;
+        }
+    };
+    view.forEachPoint(gather);
+    if (count)
+        run(count, selection.data() + view.size() - count);
+}
+
+
+bool ColumnExpression::evaluate(const PointRef& point) const
+{
+    for (size_t c = 0; c < m_accessors.size(); ++c)
+        m_columns[c][0] = m_accessors[c].get(point);
+
+    uint8_t out;
+    run(1, &out);
+    return out;
+}
+
+
+// Store the result of a test for each point in a mask, or combine it with
+// the mask's existing value.  The mode is checked outside of the loops so
+// that each loop can be vectorized.
+template<typename Test>
+void ColumnExpression::store(Mode mode, uint8_t *m, size_t count, Test test)
+{
+    switch (mode)
+    {
+    case Mode::Set:
+        for (size_t i = 0; i < count; ++i)
+            m[i] = test(i);
+        break;
+    case Mode::And:
+        for (size_t i = 0; i < count; ++i)
+            m[i] &= test(i);
+        break;
+    case Mode::Or:
+        for (size_t i = 0; i < count; ++i)
+            m[i] |= test(i);
+        break;
+    }
+}
+
+
+void ColumnExpression::run(size_t count, uint8_t *out) const
+{
+    auto mask = [this, out](size_t level)
+    {
+        return level ? m_masks[level - 1].data() : out;
+    };
+
+    size_t depth = 0;
+    for (const Step& step : m_steps)
+    {
+        if (step.m_op == Step::Op::Not)
+        {
+            uint8_t *m = mask(depth - 1);
+            for (size_t i = 0; i < count; ++i)
+                m[i] ^= 1;
+            continue;
+        }
+        if (step.m_op == Step::Op::And || step.m_op == Step::Op::Or)
+        {
+            const uint8_t *top = mask(depth - 1);
+            uint8_t *m = mask(depth - 2);
+            store(step.m_op == Step::Op::And ? Mode::And : Mode::Or, m, count,
+                [top](size_t i){ return top[i]; });
+            depth--;
+            continue;
+        }
+
+        uint8_t *m = (step.m_mode == Mode::Set) ? mask(depth++) :
+            mask(depth - 1);
+        const Mode mode = step.m_mode;
+        switch (step.m_op)
+        {
+        case Step::Op::Range:
+        {
+            const double *v = m_columns[step.m_column].data();
+            const double lower = step.m_lower;
+            const double upper = step.m_upper;
+            const uint8_t negate = step.m_negate;
+            store(mode, m, count, [=](size_t i)
+                { return (uint8_t)((v[i] >= lower) & (v[i] <= upper)) ^
+                    negate; });
+            break;
+        }
+        case Step::Op::CompareDim:
+        {
+            const double *a = m_columns[step.m_column].data();
+            const double *b = m_columns[step.m_other].data();
+            switch (step.m_compare)
+            {
+            case Compare::Eq:
+                store(mode, m, count, [=](size_t i)
+                    { return (uint8_t)(a[i] == b[i]); });
+                break;
+            case Compare::Ne:
+                store(mode, m, count, [=](size_t i)
+                    { return (uint8_t)(a[i] != b[i]); });
+                break;
+            case Compare::Lt:
+                store(mode, m, count, [=](size_t i)
+                    { return (uint8_t)(a[i] < b[i]); });
+                break;
+            case Compare::Lte:
+                store(mode, m, count, [=](size_t i)
+                    { return (uint8_t)(a[i] <= b[i]); });
+                break;
+            case Compare::Gt:
+                store(mode, m, count, [=](size_t i)
+                    { return (uint8_t)(a[i] > b[i]); });
+                break;
+            case Compare::Gte:
+                store(mode, m, count, [=](size_t i)
+                    { return (uint8_t)(a[i] >= b[i]); });
+                break;
+            }
+            break;
+        }
+        case Step::Op::In:
+        {
+            const double *v = m_columns[step.m_column].data();
+            uint8_t *t = m_temp.data();
+            std::fill(t, t + count, 0);
+            for (double val : step.m_values)
+                for (size_t i = 0; i < count; ++i)
+                    t[i] |= (uint8_t)(v[i] == val);
+            for (size_t other : step.m_others)
+            {
+                const double *o = m_columns[other].data();
+                for (size_t i = 0; i < count; ++i)
+                    t[i] |= (uint8_t)(v[i] == o[i]);
+            }
+            const uint8_t negate = step.m_negate;
+            store(mode, m, count, [=](size_t i)
+                { return (uint8_t)(t[i] ^ negate); });
+            break;
+        }
+        case Step::Op::Constant:
+        {
+            const uint8_t val = step.m_value;
+            store(mode, m, count, [=](size_t)
+                { return val; });
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+} // namespace pdal
@@ -0,0 +1,208 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <pdal/FieldAccessor.hpp>
+#include <pdal/PointRef.hpp>
+#include <pdal/PointView.hpp>
+
+namespace pdal
+{
+
+// A predicate over the dimensions of points, compiled to a flat plan that
+// is evaluated a column at a time.  When evaluating a view, the values of
+// each dimension used by the predicate are gathered for a block of points
+// and each test is a branch-free pass over a column that is combined
+// directly into a selection mask, so that the compiler can vectorize the
+// comparisons.  Comparing doubles into byte masks needs SSE4.2 or AVX on
+// x86; with SSE2 alone only the mask combinations are vectorized.  Single
+// points, as in stream mode, are run through the same plan.
+//
+// A predicate is built as a tree of nodes and passed to compile().
+// ready() must be called with the final layout before evaluation.
+// Evaluation uses scratch space held by the expression, so an expression
+// can't be evaluated by multiple threads at once.
+class ColumnExpression
+{
+public:
+    enum class Compare
+    {
+        Eq,
+        Ne,
+        Lt,
+        Lte,
+        Gt,
+        Gte
+    };
+
+    enum class Logic
+    {
+        And,
+        Or,
+        Not
+    };
+
+    struct Node;
+    typedef std::unique_ptr<Node> NodePtr;
+    typedef std::vector<NodePtr> NodeList;
+
+    struct Node
+    {
+        enum class Type
+        {
+            Range,
+            CompareDim,
+            In,
+            Logic,
+            Constant
+        };
+
+        Node(Type type) : m_type(type), m_dim(Dimension::Id::Unknown),
+            m_other(Dimension::Id::Unknown), m_lower(0), m_upper(0),
+            m_lowerInclusive(true), m_upperInclusive(true), m_negate(false),
+            m_compare(Compare::Eq), m_logic(Logic::And), m_value(false)
+        {}
+
+        Type m_type;
+        Dimension::Id m_dim;
+        Dimension::Id m_other;
+        double m_lower;
+        double m_upper;
+        bool m_lowerInclusive;
+        bool m_upperInclusive;
+        bool m_negate;
+        Compare m_compare;
+        Logic m_logic;
+        bool m_value;
+        std::vector<double> m_values;
+        std::vector<Dimension::Id> m_others;
+        NodeList m_children;
+    };
+
+    // Test that the value of a dimension is in a range, or outside of it
+    // if 'negate' is true.  NaN values are outside of every range.  NaN
+    // bounds don't limit the range.
+    static NodePtr range(Dimension::Id dim, double lower, double upper,
+        bool lowerInclusive, bool upperInclusive, bool negate = false);
+    // Compare the value of a dimension with a constant.
+    static NodePtr compare(Dimension::Id dim, Compare op, double value);
+    // Compare the value of a dimension with that of another dimension.
+    static NodePtr compare(Dimension::Id dim, Compare op, Dimension::Id other);
+    // Test that the value of a dimension is equal to one of a set of
+    // constants or the value of one of a set of dimensions, or to none of
+    // them if 'negate' is true.
+    static NodePtr in(Dimension::Id dim, const std::vector<double>& values,
+        const std::vector<Dimension::Id>& others, bool negate = false);
+    // Combine nodes.  An AND of no nodes is true and an OR of no nodes is
+    // false.  A NOT takes a single node.
+    static NodePtr logical(Logic op, NodeList children);
+    static NodePtr constant(bool value);
+
+    ColumnExpression();
+
+    // Compile a predicate.  Replaces any previously compiled predicate.
+    void compile(const Node& root);
+
+    // Resolve the dimensions used by the predicate in the layout.
+    void ready(PointLayoutPtr layout);
+
+    // Evaluate the predicate for every point in a view.  On return,
+    // 'selection' has an entry for each point of the view that is 1 if the
+    // point passes and 0 otherwise.
+    void evaluate(PointView& view, std::vector<uint8_t>& selection) const;
+
+    // Evaluate the predicate for a point.
+    bool evaluate(const PointRef& point) const;
+
+private:
+    // How a test is combined with the current mask.
+    enum class Mode
+    {
+        Set,
+        And,
+        Or
+    };
+
+    struct Step
+    {
+        enum class Op
+        {
+            Range,
+            CompareDim,
+            In,
+            Constant,
+            Not,
+            And,
+            Or
+        };
+
+        Step(Op op, Mode mode) : m_op(op), m_mode(mode), m_column(0),
+            m_other(0), m_lower(0), m_upper(0), m_negate(false),
+            m_compare(Compare::Eq), m_value(false)
+        {}
+
+        Op m_op;
+        Mode m_mode;
+        size_t m_column;
+        size_t m_other;
+        double m_lower;
+        double m_upper;
+        bool m_negate;
+        Compare m_compare;
+        bool m_value;
+        std::vector<double> m_values;
+        std::vector<size_t> m_others;
+    };
+
+    void compileNode(const Node& node, Mode mode);
+    void push(Step step);
+    size_t column(Dimension::Id dim);
+    void run(size_t count, uint8_t *out) const;
+    template<typename Test>
+    static void store(Mode mode, uint8_t *m, size_t count, Test test);
+
+    std::vector<Step> m_steps;
+    std::vector<Dimension::Id> m_dims;
+    std::vector<FieldAccessor<double>> m_accessors;
+    size_t m_depth;
+    size_t m_maxDepth;
+
+    // Scratch space for evaluation.
+    mutable std::vector<std::vector<double>> m_columns;
+    mutable std::vector<std::vector<uint8_t>> m_masks;
+    mutable std::vector<uint8_t> m_temp;
+};
+
+} // namespace pdal
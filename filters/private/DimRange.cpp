@@ -149,11 +149,37 @@ bool DimRange::pointPasses(const std::vector<DimRange>& ranges, PointRef& point)
         // a new dimension.
         else if (passes)
             continue;
-        passes = r.valuePasses(point.getFieldAs<double>(r.m_id));
+        passes = r.valuePasses(r.value(point));
     }
     return passes;
 }
 
+ColumnExpression::NodePtr DimRange::node() const
+{
+    return ColumnExpression::range(m_id, m_lower_bound, m_upper_bound,
+        m_inclusive_lower_bound, m_inclusive_upper_bound, m_negate);
+}
+
+// Build an expression with the logic of pointPasses().  The range list
+// must be sorted.
+ColumnExpression::NodePtr DimRange::node(const std::vector<DimRange>& ranges)
+{
+    ColumnExpression::NodeList dims;
+    ColumnExpression::NodeList alternatives;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        alternatives.push_back(ranges[i].node());
+        if (i + 1 == ranges.size() || ranges[i + 1].m_id != ranges[i].m_id)
+        {
+            dims.push_back(ColumnExpression::logical(
+                ColumnExpression::Logic::Or, std::move(alternatives)));
+            alternatives.clear();
+        }
+    }
+    return ColumnExpression::logical(ColumnExpression::Logic::And,
+        std::move(dims));
+}
+
 void DimRange::parse(const std::string& r)
 {
     std::string::size_type pos = subParse(r);
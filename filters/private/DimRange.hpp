@@ -37,9 +37,12 @@
 #include <string>
 
 #include <pdal/Dimension.hpp>
+#include <pdal/FieldAccessor.hpp>
 #include <pdal/PointRef.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
+#include "ColumnExpression.hpp"
+
 namespace pdal
 {
 
@@ -71,8 +74,15 @@ struct DimRange
 
     void parse(const std::string& s);
     bool valuePasses(double d) const;
+    double value(const PointRef& point) const
+    {
+        return m_accessor.valid() ? m_accessor.get(point) :
+            point.getFieldAs<double>(m_id);
+    }
     static bool pointPasses(const std::vector<DimRange>& ranges,
         PointRef& point);
+    ColumnExpression::NodePtr node() const;
+    static ColumnExpression::NodePtr node(const std::vector<DimRange>& ranges);
 
     std::string m_name;
     Dimension::Id m_id;
@@ -81,6 +91,9 @@ struct DimRange
     bool m_inclusive_lower_bound;
     bool m_inclusive_upper_bound;
     bool m_negate;
+    // Optional accessor for m_id, set by stages once the layout is
+    // complete.
+    FieldAccessor<double> m_accessor;
 
 protected:
     std::string::size_type subParse(const std::string& r);
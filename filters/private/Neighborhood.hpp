@@ -0,0 +1,120 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+#pragma once
+
+#include <pdal/EigenUtils.hpp>
+#include <pdal/KDIndex.hpp>
+#include <pdal/PointView.hpp>
+
+#include <vector>
+
+namespace pdal
+{
+
+// Contiguous copy of the XYZ coordinates of a PointView.  Hot loops that
+// repeatedly visit neighborhoods read positions from here instead of going
+// through the point table for every access.
+struct XYZArrays
+{
+    explicit XYZArrays(const PointView& view) :
+        x(view.size()), y(view.size()), z(view.size())
+    {
+        for (PointId i = 0; i < view.size(); ++i)
+        {
+            x[i] = view.getFieldAs<double>(Dimension::Id::X, i);
+            y[i] = view.getFieldAs<double>(Dimension::Id::Y, i);
+            z[i] = view.getFieldAs<double>(Dimension::Id::Z, i);
+        }
+    }
+
+    std::size_t size() const
+        { return x.size(); }
+
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+};
+
+// Computes the covariance of k-nearest neighborhoods.  All buffers are
+// allocated once, so an instance should be created per thread and reused
+// for every point that thread visits.
+class NeighborhoodCovariance
+{
+public:
+    NeighborhoodCovariance(const XYZArrays& coords, const KD3Index& kdi,
+            point_count_t k, std::size_t stride = 1) :
+        m_coords(coords), m_kdi(kdi), m_stride((std::max)(stride,
+            std::size_t(1)))
+    {
+        // Account for a point count smaller than the requested number of
+        // neighbors, as KD3Index::neighbors() does.
+        m_k = (std::min)(k, (point_count_t)coords.size());
+        m_searchK = (std::min)(m_k * m_stride,
+            (point_count_t)coords.size());
+        m_ids.resize(m_searchK);
+        m_dists.resize(m_searchK);
+        m_x.resize(m_k);
+        m_y.resize(m_k);
+        m_z.resize(m_k);
+    }
+
+    // Find the neighbors of point 'idx' and return their covariance.
+    Eigen::Matrix3d compute(PointId idx)
+    {
+        m_kdi.knnSearch(m_coords.x[idx], m_coords.y[idx], m_coords.z[idx],
+            m_searchK, &m_ids, &m_dists);
+
+        // Select every nth neighbor when a stride is requested.
+        point_count_t n = 0;
+        for (point_count_t i = 0; i < m_searchK && n < m_k; i += m_stride)
+        {
+            const PointId j = m_ids[i];
+            m_x[n] = m_coords.x[j];
+            m_y[n] = m_coords.y[j];
+            m_z[n] = m_coords.z[j];
+            ++n;
+        }
+        return computeCovariance(m_x.data(), m_y.data(), m_z.data(), n);
+    }
+
+private:
+    const XYZArrays& m_coords;
+    const KD3Index& m_kdi;
+    std::size_t m_stride;
+    point_count_t m_k;
+    point_count_t m_searchK;
+    PointIdList m_ids;
+    std::vector<double> m_dists;
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_z;
+};
+
+} // namespace pdal
@@ -23,8 +23,35 @@
 #include "Cloth.h"
 #include "Rasterization.h"
 #include "c2cdist.h"
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <pdal/Log.hpp>
+#include <pdal/private/ThreadRange.hpp>
+
+namespace {
+
+// Drop the cloth onto its terrain.
+void simulate(Cloth& cloth, const Params& params) {
+    double time_step2 = params.time_step * params.time_step;
+    double gravity    = 0.2;
+
+    cloth.addForce(Vec3(0, -gravity, 0) * time_step2);
+
+    for (int i = 0; i < params.interations; i++) {
+        double maxDiff = cloth.timeStep();
+        cloth.terrCollision();
+        if ((maxDiff != 0) && (maxDiff < 0.005)) {
+            // early stop
+            break;
+        }
+    }
+
+    if (params.bSloopSmooth)
+        cloth.movableFilter();
+}
+
+} // namespace
 
 
 CSF::CSF(int index) {
@@ -160,28 +187,8 @@ void CSF::do_filtering(std::vector<int>& groundIndexes,
     log->get(pdal::LogLevel::Debug) << "[" << this->index << "] Rasterizing..." << endl;
     Rasterization::RasterTerrian(cloth, point_cloud, cloth.getHeightvals());
 
-    double time_step2 = params.time_step * params.time_step;
-    double gravity    = 0.2;
-
     log->get(pdal::LogLevel::Debug) << "[" << this->index << "] Simulating..." << endl;
-    cloth.addForce(Vec3(0, -gravity, 0) * time_step2);
-
-    // boost::progress_display pd(params.interations);
-    for (int i = 0; i < params.interations; i++) {
-        double maxDiff = cloth.timeStep();
-        cloth.terrCollision();
-		//params.class_threshold / 100
-        if ((maxDiff != 0) && (maxDiff < 0.005)) {
-            // early stop
-            break;
-        }
-        // pd++;
-    }
-
-    if (params.bSloopSmooth) {
-        log->get(pdal::LogLevel::Debug) << "[" << this->index << "]  - post handle..." << endl;
-        cloth.movableFilter();
-    }
+    simulate(cloth, params);
 
     if (exportCloth)
         cloth.saveToFile();
@@ -190,6 +197,114 @@ void CSF::do_filtering(std::vector<int>& groundIndexes,
     c2c.calCloud2CloudDist(cloth, point_cloud, groundIndexes, offGroundIndexes);
 }
 
+void CSF::do_filtering(std::vector<int>& groundIndexes,
+                       std::vector<int>& offGroundIndexes,
+                       double            tileSize,
+                       double            tileBuffer,
+                       int               threads) {
+    log->get(pdal::LogLevel::Debug) << "[" << this->index << "] Configuring terrain..." << endl;
+    csf::Point bbMin, bbMax;
+    point_cloud.computeBoundingBox(bbMin, bbMax);
+
+    // The global cloth is laid out exactly as in the untiled case; tiles
+    // are windows onto it.
+    const double res = params.cloth_resolution;
+    double cloth_y_height = 0.05;
+
+    int  clothbuffer_d = 2;
+    Vec3 origin_pos(
+        bbMin.x - clothbuffer_d * res,
+        bbMax.y + cloth_y_height,
+        bbMin.z - clothbuffer_d * res
+    );
+
+    int width_num = static_cast<int>(
+        floor((bbMax.x - bbMin.x) / res)
+    ) + 2 * clothbuffer_d;
+
+    int height_num = static_cast<int>(
+        floor((bbMax.z - bbMin.z) / res)
+    ) + 2 * clothbuffer_d;
+
+    log->get(pdal::LogLevel::Debug) << "[" << this->index << "] Rasterizing..." << endl;
+    vector<double> heightVals;
+    Rasterization::RasterTerrian(point_cloud, origin_pos, res, width_num,
+                                 height_num, heightVals);
+
+    // A point's bilinear interpolation reaches one node beyond its own,
+    // so tiles always overlap by a couple of nodes.
+    int tileNodes   = (std::max)(static_cast<int>(ceil(tileSize / res)), 1);
+    int bufferNodes = (std::max)(static_cast<int>(ceil(tileBuffer / res)), 2);
+    int tilesX      = (width_num + tileNodes - 1) / tileNodes;
+    int tilesY      = (height_num + tileNodes - 1) / tileNodes;
+
+    vector<vector<int> > tilePoints((size_t)tilesX * tilesY);
+    for (std::size_t i = 0; i < point_cloud.size(); i++) {
+        int col = int((point_cloud[i].x - origin_pos.f[0]) / res);
+        int row = int((point_cloud[i].z - origin_pos.f[2]) / res);
+        tilePoints[(row / tileNodes) * tilesX + col / tileNodes].push_back(i);
+    }
+
+    log->get(pdal::LogLevel::Debug) << "[" << this->index << "] Simulating " <<
+        tilesX << " x " << tilesY << " tiles..." << endl;
+    vector<char> ground(point_cloud.size(), 0);
+    pdal::forEachIndex(tilePoints.size(), threads, [&](pdal::point_count_t t) {
+        const vector<int>& indices = tilePoints[t];
+        if (indices.empty())
+            return;
+
+        int tx = int(t % tilesX);
+        int ty = int(t / tilesX);
+        int c0 = (std::max)(tx * tileNodes - bufferNodes, 0);
+        int c1 = (std::min)((tx + 1) * tileNodes + bufferNodes, width_num);
+        int r0 = (std::max)(ty * tileNodes - bufferNodes, 0);
+        int r1 = (std::min)((ty + 1) * tileNodes + bufferNodes, height_num);
+
+        Cloth cloth(
+            Vec3(origin_pos.f[0] + c0 * res, origin_pos.f[1],
+                 origin_pos.f[2] + r0 * res),
+            c1 - c0,
+            r1 - r0,
+            res,
+            res,
+            0.3,
+            9999,
+            params.rigidness,
+            params.time_step
+        );
+
+        vector<double>& tileHeights = cloth.getHeightvals();
+        tileHeights.resize(cloth.getSize());
+        for (int r = r0; r < r1; r++) {
+            std::copy(heightVals.begin() + (size_t)r * width_num + c0,
+                      heightVals.begin() + (size_t)r * width_num + c1,
+                      tileHeights.begin() + (size_t)(r - r0) * (c1 - c0));
+        }
+
+        simulate(cloth, params);
+
+        csf::PointCloud pc;
+        pc.reserve(indices.size());
+        for (int i : indices)
+            pc.push_back(point_cloud[i]);
+
+        vector<int> tileGround, tileOffGround;
+        c2cdist c2c(params.class_threshold);
+        c2c.calCloud2CloudDist(cloth, pc, tileGround, tileOffGround);
+        for (int i : tileGround)
+            ground[indices[i]] = 1;
+    });
+
+    groundIndexes.resize(0);
+    offGroundIndexes.resize(0);
+    for (std::size_t i = 0; i < ground.size(); i++) {
+        if (ground[i])
+            groundIndexes.push_back(i);
+        else
+            offGroundIndexes.push_back(i);
+    }
+}
+
 void CSF::savePoints(vector<int> grp, string path) {
     if (path == "") {
         return;
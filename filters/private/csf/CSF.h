@@ -111,6 +111,16 @@ public:
                       std::vector<int>& offGroundIndexes,
                       bool              exportCloth = false);
 
+    // Same as above, but the cloth is split into square tiles of
+    // 'tileSize' that overlap their neighbors by 'tileBuffer' and are
+    // simulated independently on up to 'threads' threads.  The terrain
+    // is rasterized once for all tiles.
+    void do_filtering(std::vector<int>& groundIndexes,
+                      std::vector<int>& offGroundIndexes,
+                      double            tileSize,
+                      double            tileBuffer,
+                      int               threads);
+
 private:
 
 #ifdef _CSF_DLL_EXPORT_
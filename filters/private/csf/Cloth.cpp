@@ -57,8 +57,6 @@ Cloth::Cloth(const Vec3& _origin_pos,
         }
     }
 
-    saveToFile("initial-nodes.txt");
-
     // Connecting immediate neighbor particles with constraints
     // (distance 1 and sqrt(2) in the grid)
     for (int x = 0; x < num_particles_width; x++) {
@@ -123,7 +121,6 @@ void Cloth::addForce(const Vec3 direction) {
     for (std::size_t i = 0; i < particles.size(); i++) {
         particles[i].addForce(direction);
     }
-    saveToFile("force-nodes.txt");
 }
 
 void Cloth::terrCollision() {
@@ -137,7 +134,6 @@ void Cloth::terrCollision() {
             particles[i].makeUnmovable();
         }
     }
-    saveToFile("collision-notes.txt");
 }
 
 void Cloth::movableFilter() {
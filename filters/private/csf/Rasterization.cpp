@@ -142,3 +142,113 @@ void Rasterization::RasterTerrian(Cloth          & cloth,
         }
     }
 }
+
+void Rasterization::RasterTerrian(const csf::PointCloud& pc,
+                                  const Vec3           & origin,
+                                  double                 step,
+                                  int                    width,
+                                  int                    height,
+                                  vector<double>       & heightVal) {
+    const size_t size = (size_t)width * height;
+    vector<double> nearest(size, MIN_INF);
+    vector<double> nearestDist(size, MAX_INF);
+
+    for (std::size_t i = 0; i < pc.size(); i++) {
+        double deltaX = pc[i].x - origin.f[0];
+        double deltaZ = pc[i].z - origin.f[2];
+        int    col    = int(deltaX / step + 0.5);
+        int    row    = int(deltaZ / step + 0.5);
+
+        if ((col >= 0) && (row >= 0) && (col < width) && (row < height)) {
+            size_t idx = (size_t)row * width + col;
+            double pc2nodeDist = SQUARE_DIST(
+                pc[i].x, pc[i].z,
+                origin.f[0] + col * step,
+                origin.f[2] + row * step
+            );
+
+            if (pc2nodeDist < nearestDist[idx]) {
+                nearestDist[idx] = pc2nodeDist;
+                nearest[idx]     = pc[i].y;
+            }
+        }
+    }
+    heightVal.resize(size);
+
+    // Nodes without a point take a value by the same search order as
+    // findHeightValByScanline().
+    bool unresolved = false;
+
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            size_t idx = (size_t)y * width + x;
+            double h   = nearest[idx];
+
+            for (int i = x + 1; i < width && h <= MIN_INF; i++)
+                h = nearest[(size_t)y * width + i];
+
+            for (int i = x - 1; i >= 0 && h <= MIN_INF; i--)
+                h = nearest[(size_t)y * width + i];
+
+            for (int j = y - 1; j >= 0 && h <= MIN_INF; j--)
+                h = nearest[(size_t)j * width + x];
+
+            for (int j = y + 1; j < height && h <= MIN_INF; j++)
+                h = nearest[(size_t)j * width + x];
+
+            heightVal[idx] = h;
+
+            if (h <= MIN_INF)
+                unresolved = true;
+        }
+    }
+
+    if (!unresolved)
+        return;
+
+    // Nodes whose row and column are both empty take the value of the
+    // closest node with a point, walking the cloth's constraint
+    // neighborhood as findHeightValByNeighbor() does.  A single
+    // breadth-first search from all such nodes replaces the per-node
+    // search.
+    const int offsets[][2] = {
+        { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 },
+        { 1, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 },
+        { 2, 0 }, { -2, 0 }, { 0, 2 }, { 0, -2 },
+        { 2, 2 }, { -2, -2 }, { 2, -2 }, { -2, 2 }
+    };
+    queue<size_t> nqueue;
+    vector<double> reached(nearest);
+
+    for (size_t idx = 0; idx < size; idx++) {
+        if (nearest[idx] > MIN_INF)
+            nqueue.push(idx);
+    }
+
+    while (!nqueue.empty()) {
+        size_t cur = nqueue.front();
+        nqueue.pop();
+        int cx = int(cur % width);
+        int cy = int(cur / width);
+
+        for (auto& o : offsets) {
+            int nx = cx + o[0];
+            int ny = cy + o[1];
+
+            if ((nx < 0) || (ny < 0) || (nx >= width) || (ny >= height))
+                continue;
+
+            size_t n = (size_t)ny * width + nx;
+
+            if (reached[n] <= MIN_INF) {
+                reached[n] = reached[cur];
+                nqueue.push(n);
+            }
+        }
+    }
+
+    for (size_t idx = 0; idx < size; idx++) {
+        if (heightVal[idx] <= MIN_INF)
+            heightVal[idx] = reached[idx];
+    }
+}
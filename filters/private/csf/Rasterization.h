@@ -39,6 +39,16 @@ public:
     void static   RasterTerrian(Cloth          & cloth,
                                 csf::PointCloud& pc,
                                 vector<double> & heightVal);
+
+    // Rasterize onto a bare grid of cloth nodes (no particles) so that a
+    // single rasterization can be shared by several cloth tiles.  Nodes
+    // without a point take their value the same way RasterTerrian does.
+    void static   RasterTerrian(const csf::PointCloud& pc,
+                                const Vec3           & origin,
+                                double                 step,
+                                int                    width,
+                                int                    height,
+                                vector<double>       & heightVal);
 };
 
 #endif // ifndef _KNN_H_
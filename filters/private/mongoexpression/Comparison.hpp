@@ -126,12 +126,19 @@ public:
         }
     }
 
-    double get(const pdal::PointRef& pr) const
+    bool isDimension() const
     {
-        if (m_id == Dimension::Id::Unknown)
-            return m_value;
-        else
-            return pr.getFieldAs<double>(m_id);
+        return m_id != Dimension::Id::Unknown;
+    }
+
+    Dimension::Id id() const
+    {
+        return m_id;
+    }
+
+    double value() const
+    {
+        return m_value;
     }
 
     std::string toString() const
@@ -171,9 +178,32 @@ public:
         , m_operand(op)
     { }
 
-    virtual bool operator()(const pdal::PointRef& pr) const override
+    virtual ColumnExpression::NodePtr node() const override
     {
-        return compare(pr.getFieldAs<double>(m_dimId), m_operand.get(pr));
+        ColumnExpression::Compare op(ColumnExpression::Compare::Eq);
+        switch (type())
+        {
+        case ComparisonType::gt:
+            op = ColumnExpression::Compare::Gt;
+            break;
+        case ComparisonType::gte:
+            op = ColumnExpression::Compare::Gte;
+            break;
+        case ComparisonType::lt:
+            op = ColumnExpression::Compare::Lt;
+            break;
+        case ComparisonType::lte:
+            op = ColumnExpression::Compare::Lte;
+            break;
+        case ComparisonType::ne:
+            op = ColumnExpression::Compare::Ne;
+            break;
+        default:
+            break;
+        }
+        if (m_operand.isDimension())
+            return ColumnExpression::compare(m_dimId, op, m_operand.id());
+        return ColumnExpression::compare(m_dimId, op, m_operand.value());
     }
 
     virtual std::string toString(std::string pre) const override
@@ -185,9 +215,6 @@ public:
         return ss.str();
     }
 
-protected:
-    virtual bool compare(double a, double b) const = 0;
-
 private:
     Operand m_operand;
 };
@@ -200,7 +227,6 @@ public:
     { }
 
 protected:
-    virtual bool compare(double a, double b) const override { return a == b; }
     virtual ComparisonType type() const override { return ComparisonType::eq; }
 };
 
@@ -212,7 +238,6 @@ public:
     { }
 
 protected:
-    virtual bool compare(double a, double b) const override { return a > b; }
     virtual ComparisonType type() const override { return ComparisonType::gt; }
 };
 
@@ -224,7 +249,6 @@ public:
     { }
 
 protected:
-    virtual bool compare(double a, double b) const override { return a >= b; }
     virtual ComparisonType type() const override { return ComparisonType::gte; }
 };
 
@@ -236,7 +260,6 @@ public:
     { }
 
 protected:
-    virtual bool compare(double a, double b) const override { return a < b; }
     virtual ComparisonType type() const override { return ComparisonType::lt; }
 };
 
@@ -248,7 +271,6 @@ public:
     { }
 
 protected:
-    virtual bool compare(double a, double b) const override { return a <= b; }
     virtual ComparisonType type() const override { return ComparisonType::lte; }
 };
 
@@ -260,7 +282,6 @@ public:
     { }
 
 protected:
-    virtual bool compare(double a, double b) const override { return a != b; }
     virtual ComparisonType type() const override { return ComparisonType::ne; }
 };
 
@@ -282,6 +303,21 @@ public:
         return ss.str();
     }
 
+    virtual ColumnExpression::NodePtr node() const override
+    {
+        std::vector<double> values;
+        std::vector<Dimension::Id> others;
+        for (const auto& op : m_operands)
+        {
+            if (op.isDimension())
+                others.push_back(op.id());
+            else
+                values.push_back(op.value());
+        }
+        return ColumnExpression::in(m_dimId, values, others,
+            type() == ComparisonType::nin);
+    }
+
 protected:
     const Operands m_operands;
 };
@@ -295,15 +331,6 @@ public:
 
 protected:
     virtual ComparisonType type() const override { return ComparisonType::in; }
-
-    virtual bool operator()(const pdal::PointRef& pr) const override
-    {
-        const double val(pr.getFieldAs<double>(m_dimId));
-        return std::any_of(
-                m_operands.begin(),
-                m_operands.end(),
-                [&pr, val](const Operand& op) { return val == op.get(pr); });
-    }
 };
 
 class ComparisonNone : public ComparisonMulti
@@ -315,15 +342,6 @@ public:
 
 protected:
     virtual ComparisonType type() const override { return ComparisonType::nin; }
-
-    virtual bool operator()(const pdal::PointRef& pr) const override
-    {
-        const double val(pr.getFieldAs<double>(m_dimId));
-        return std::none_of(
-                m_operands.begin(),
-                m_operands.end(),
-                [&pr, val](const Operand& op) { return val == op.get(pr); });
-    }
 };
 
 } // namespace pdal
@@ -47,11 +47,23 @@ public:
         : m_layout(layout)
     {
         build(m_root, json);
+        m_plan.compile(*m_root.node());
+    }
+
+    // Resolve the dimensions of the expression once the layout is complete.
+    void ready(PointLayoutPtr layout)
+    {
+        m_plan.ready(layout);
     }
 
     bool check(const pdal::PointRef& pr) const
     {
-        return m_root(pr);
+        return m_plan.evaluate(pr);
+    }
+
+    void check(PointView& view, std::vector<uint8_t>& selection) const
+    {
+        m_plan.evaluate(view, selection);
     }
 
     std::string toString() const
@@ -64,6 +76,7 @@ private:
 
     const PointLayout& m_layout;
     LogicalAnd m_root;
+    ColumnExpression m_plan;
 };
 
 inline std::ostream& operator<<(std::ostream& os, const Expression& expression)
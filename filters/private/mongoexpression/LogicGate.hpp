@@ -100,23 +100,41 @@ public:
 
     virtual LogicalOperator type() const = 0;
 
-protected:
-    std::vector<std::unique_ptr<Filterable>> m_filters;
-};
-
-class LogicalAnd : public LogicGate
-{
-public:
-    virtual bool operator()(const pdal::PointRef& pr) const override
+    virtual ColumnExpression::NodePtr node() const override
     {
+        ColumnExpression::NodeList children;
         for (const auto& f : m_filters)
+            children.push_back(f->node());
+
+        switch (type())
         {
-            if (!(*f)(pr)) return false;
+        case LogicalOperator::lAnd:
+            return ColumnExpression::logical(ColumnExpression::Logic::And,
+                std::move(children));
+        case LogicalOperator::lNot:
+            return ColumnExpression::logical(ColumnExpression::Logic::Not,
+                std::move(children));
+        case LogicalOperator::lOr:
+            return ColumnExpression::logical(ColumnExpression::Logic::Or,
+                std::move(children));
+        case LogicalOperator::lNor:
+        default:
+        {
+            ColumnExpression::NodeList nor;
+            nor.push_back(ColumnExpression::logical(
+                ColumnExpression::Logic::Or, std::move(children)));
+            return ColumnExpression::logical(ColumnExpression::Logic::Not,
+                std::move(nor));
+        }
         }
-
-        return true;
     }
 
+protected:
+    std::vector<std::unique_ptr<Filterable>> m_filters;
+};
+
+class LogicalAnd : public LogicGate
+{
 protected:
     virtual LogicalOperator type() const override
     {
@@ -136,11 +154,6 @@ public:
         LogicGate::push(std::move(f));
     }
 
-    virtual bool operator()(const pdal::PointRef& pr) const override
-    {
-        return !(*m_filters.at(0))(pr);
-    }
-
 private:
     virtual LogicalOperator type() const override
     {
@@ -150,17 +163,6 @@ private:
 
 class LogicalOr : public LogicGate
 {
-public:
-    virtual bool operator()(const pdal::PointRef& pr) const override
-    {
-        for (const auto& f : m_filters)
-        {
-            if ((*f)(pr)) return true;
-        }
-
-        return false;
-    }
-
 protected:
     virtual LogicalOperator type() const override
     {
@@ -170,13 +172,6 @@ protected:
 
 class LogicalNor : public LogicalOr
 {
-public:
-    using LogicalOr::operator();
-    virtual bool operator()(const pdal::PointRef& pr) const override
-    {
-        return !LogicalOr::operator()(pr);
-    }
-
 protected:
     virtual LogicalOperator type() const override
     {
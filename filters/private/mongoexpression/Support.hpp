@@ -39,6 +39,8 @@
 #include <pdal/PointLayout.hpp>
 #include <pdal/PointRef.hpp>
 
+#include "../ColumnExpression.hpp"
+
 namespace pdal
 {
 
@@ -53,7 +55,8 @@ public:
 class Filterable : public Loggable
 {
 public:
-    virtual bool operator()(const PointRef& pr) const = 0;
+    // Lower to a node of a column expression.
+    virtual ColumnExpression::NodePtr node() const = 0;
 };
 
 class Comparable : public Loggable
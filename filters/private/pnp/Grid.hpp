@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 // Grid class that holds some object of interest.  The downside of this
@@ -28,6 +29,12 @@ public:
         { return m_cells[index(xpos, ypos)]; }
     T& cell(Pos pos)
         { return cell(pos.first, pos.second); }
+    /**
+      Return a reference to a cell given its index in the grid
+      (ypos * width + xpos).
+    */
+    T& cell(size_t index)
+        { return m_cells[index]; }
 
     /**
       Convert external coordinates to a grid position.
@@ -48,6 +55,22 @@ public:
     }
 #pragma warning(pop)
 
+    /**
+      Convert external coordinates to a grid position, clamping the position
+      to the grid.
+    */
+    Pos clampedPos(double x, double y) const
+    {
+        double xpos = (x - m_xOrigin) / m_cellWidth;
+        double ypos = (y - m_yOrigin) / m_cellHeight;
+        Pos pos;
+        pos.first = xpos <= 0 ? 0 :
+            (std::min)((size_t)xpos, m_width - 1);
+        pos.second = ypos <= 0 ? 0 :
+            (std::min)((size_t)ypos, m_height - 1);
+        return pos;
+    }
+
     /**
       Determine the origin of the specified cell in external coordinates.
     */
@@ -64,6 +87,16 @@ public:
     */
     Point origin() const
         { return { m_xOrigin, m_yOrigin }; }
+    /**
+      Return the number of cells in the X direction.
+    */
+    size_t width() const
+        { return m_width; }
+    /**
+      Return the number of cells in the Y direction.
+    */
+    size_t height() const
+        { return m_height; }
     /**
       Return the cell width.
     */
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <memory>
 #include <random>
 #include <vector>
 #include <set>
@@ -70,12 +74,70 @@ public:
         // do it now.
         if (!cell.computed())
             computeCell(cell, idx);
+        return testPoint(cell, x, y);
+    }
 
-        // If there are no edges in the cell, the status of the cell is uniform,
-        // just return the state.
-        if (cell.empty())
-            return cell.inside();
-        return testCell(cell, x, y);
+    // Determine if each of 'count' points is inside the polygon, setting
+    // the corresponding entry of 'out' to 1 if so and 0 otherwise.
+    void inside(const double *x, const double *y, size_t count,
+        char *out) const
+    {
+        // Find grid cells for all the points first.  The loop body has no
+        // branches and converts cell coordinates as 32-bit integers, so GCC
+        // vectorizes it when SSE4.2 or AVX is enabled.
+        std::vector<int64_t> cells(count);
+        const Grid<Cell>::Point origin = m_grid->origin();
+        const double ox = xval(origin);
+        const double oy = yval(origin);
+        const double cellWidth = m_grid->cellWidth();
+        const double cellHeight = m_grid->cellHeight();
+        const int64_t gridWidth = (int64_t)m_grid->width();
+        const double width = (double)m_grid->width();
+        const double height = (double)m_grid->height();
+        for (size_t i = 0; i < count; ++i)
+        {
+            double xpos = (x[i] - ox) / cellWidth;
+            double ypos = (y[i] - oy) / cellHeight;
+            bool valid = (xpos >= 0) & (ypos >= 0) &
+                (xpos < width) & (ypos < height);
+            int64_t xcell = (int32_t)(valid ? xpos : 0);
+            int64_t ycell = (int32_t)(valid ? ypos : 0);
+            cells[i] = valid ? ycell * gridWidth + xcell : -1;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (cells[i] < 0)
+            {
+                out[i] = 0;
+                continue;
+            }
+            Cell& cell = m_grid->cell((size_t)cells[i]);
+            if (!cell.computed())
+            {
+                XYIndex idx(cells[i] % m_grid->width(),
+                    cells[i] / m_grid->width());
+                computeCell(cell, idx);
+            }
+            out[i] = testPoint(cell, x[i], y[i]) ? 1 : 0;
+        }
+    }
+
+    // Compute the reference point and state of every cell up front.  Once
+    // prepared, inside() doesn't modify the grid, so it can be called
+    // from multiple threads at once.
+    void prepare()
+    {
+        // Cells are computed left to right so that the cell to the left,
+        // which is used to determine state, is always available.
+        for (size_t y = 0; y < m_grid->height(); ++y)
+            for (size_t x = 0; x < m_grid->width(); ++x)
+            {
+                XYIndex idx(x, y);
+                Cell& cell = m_grid->cell(idx);
+                if (!cell.computed())
+                    computeCell(cell, idx);
+            }
     }
 
 private:
@@ -115,11 +177,17 @@ private:
             { return m_inside; }
         void setInside(bool inside)
             { m_inside = inside; }
+        Grid<Cell> *children() const
+            { return m_children.get(); }
+        void setChildren(Grid<Cell> *children)
+            { m_children.reset(children); }
 
     private:
         std::vector<size_t> m_edges;
         bool m_inside;
         GridPnp::Point m_point;
+        // Finer grid covering this cell when the cell has many edges.
+        std::unique_ptr<Grid<Cell>> m_children;
     };
 
     class EdgeIt
@@ -300,10 +368,6 @@ private:
 
         m_grid.reset(new Grid<Cell>(gridSize.first, gridSize.second,
             cellWidth, cellHeight, xOrigin, yOrigin));
-        m_xDistribution.reset(
-            new std::uniform_real_distribution<>(0, m_grid->cellWidth()));
-        m_yDistribution.reset(
-            new std::uniform_real_distribution<>(0, m_grid->cellHeight()));
     }
 
 
@@ -345,11 +409,177 @@ private:
 
 
     // Put a reference point in the cell.  Figure out if the reference point
-    // is inside the polygon.
+    // is inside the polygon.  Split the cell if it has many edges.
     void computeCell(Cell& cell, XYIndex& pos) const
     {
-        generateRefPoint(cell, pos);
+        generateRefPoint(*m_grid, cell, pos);
         determinePointStatus(cell, pos);
+        refineCell(cell, m_grid->cellOrigin(pos), m_grid->cellWidth(),
+            m_grid->cellHeight(), 0);
+    }
+
+
+    // Find the cell at the finest level that contains a position and test
+    // the position against the edges of that cell.
+    bool testPoint(const Cell& cell, double x, double y) const
+    {
+        const Cell *c = &cell;
+        while (c->children())
+            c = &c->children()->cell(c->children()->clampedPos(x, y));
+
+        // If there are no edges in the cell, the status of the cell is
+        // uniform, just return the state.
+        if (c->empty())
+            return c->inside();
+        return testCell(*c, x, y);
+    }
+
+
+    // The grid size is chosen from the average edge length, so where
+    // vertices are dense (a detailed coastline, for instance) a single cell
+    // can hold many edges, all of which must be checked for a point in the
+    // cell.  Split such cells into a finer grid, recursively.  Only edges
+    // in the parent cell can cross the segment between a child cell's
+    // reference point and the parent's reference point, so the state of
+    // each child can be determined without looking outside the parent.
+    void refineCell(Cell& cell, const Point& origin, double cellWidth,
+        double cellHeight, int level) const
+    {
+        const size_t MaxEdges = 32;
+        const int MaxLevel = 4;
+
+        if (cell.edges().size() <= MaxEdges || level >= MaxLevel)
+            return;
+
+        // Aim for a couple of edges per child cell.
+        size_t splits = (size_t)std::ceil(
+            std::sqrt(cell.edges().size() / 2.0));
+        splits = (std::min)((std::max)(splits, (size_t)2), (size_t)16);
+
+        Grid<Cell> *children = new Grid<Cell>(splits, splits,
+            cellWidth / splits, cellHeight / splits,
+            xval(origin), yval(origin));
+        cell.setChildren(children);
+
+        // Add each edge to the children that it passes through.  Edges are
+        // clipped to the parent cell first, since they can extend well
+        // beyond it.
+        for (EdgeId id : cell.edges())
+        {
+            Point p1, p2;
+            if (!clipEdge(id, origin, cellWidth, cellHeight, p1, p2))
+                continue;
+            VoxelRayTrace vrt(children->cellWidth(), children->cellHeight(),
+                xval(origin), yval(origin),
+                xval(p1), yval(p1), xval(p2), yval(p2));
+            VoxelRayTrace::CellList traversedCells = vrt.emit();
+            const size_t last = splits - 1;
+            XYIndex prev(splits, splits);
+            for (auto& c : traversedCells)
+            {
+                XYIndex pos(
+                    c.first < 0 ? 0 : (std::min)((size_t)c.first, last),
+                    c.second < 0 ? 0 : (std::min)((size_t)c.second, last));
+                if (pos != prev)
+                    children->cell(pos).addEdge(id);
+                prev = pos;
+            }
+        }
+
+        // Set the state of each child as is done for top-level cells, except
+        // that the first child in each row is compared with the parent's
+        // reference point instead of a point known to be outside.
+        for (size_t y = 0; y < splits; ++y)
+            for (size_t x = 0; x < splits; ++x)
+            {
+                XYIndex pos(x, y);
+                Cell& child = children->cell(pos);
+                generateRefPoint(*children, child, pos);
+                if (x == 0)
+                {
+                    Edge edge{ child.point(), cell.point() };
+                    size_t intersectCount = intersections(edge, cell.edges());
+                    child.setInside(
+                        cell.inside() != (intersectCount % 2 == 1));
+                }
+                else
+                {
+                    Cell& prevChild = children->cell(XYIndex(x - 1, y));
+                    Edge edge{ child.point(), prevChild.point() };
+                    // Edges are added in order, so the lists are sorted.
+                    std::vector<size_t> edges;
+                    std::set_union(child.edges().begin(), child.edges().end(),
+                        prevChild.edges().begin(), prevChild.edges().end(),
+                        std::back_inserter(edges));
+                    size_t intersectCount = intersections(edge, edges);
+                    child.setInside(
+                        prevChild.inside() != (intersectCount % 2 == 1));
+                }
+            }
+
+        // Long edges cross every child in their path, so splitting
+        // doesn't always help.  Only split children again when this split
+        // substantially reduced the number of edges.
+        for (size_t y = 0; y < splits; ++y)
+            for (size_t x = 0; x < splits; ++x)
+            {
+                XYIndex pos(x, y);
+                Cell& child = children->cell(pos);
+                if (child.edges().size() * 2 < cell.edges().size())
+                    refineCell(child, children->cellOrigin(pos),
+                        children->cellWidth(), children->cellHeight(),
+                        level + 1);
+            }
+    }
+
+
+    // Clip an edge to a cell (Liang-Barsky).  Return false if the edge
+    // doesn't pass through the cell.
+    bool clipEdge(EdgeId id, const Point& origin, double cellWidth,
+        double cellHeight, Point& p1, Point& p2) const
+    {
+        p1 = point1(id);
+        p2 = point2(id);
+        // Expand the cell a bit so that edges along the boundary are
+        // included.
+        double xpad = cellWidth * 1e-9;
+        double ypad = cellHeight * 1e-9;
+        double xmin = xval(origin) - xpad;
+        double xmax = xval(origin) + cellWidth + xpad;
+        double ymin = yval(origin) - ypad;
+        double ymax = yval(origin) + cellHeight + ypad;
+
+        double dx = xval(p2) - xval(p1);
+        double dy = yval(p2) - yval(p1);
+        double t0 = 0;
+        double t1 = 1;
+        auto clip = [&t0, &t1](double p, double q)
+        {
+            if (p == 0)
+                return q >= 0;
+            double r = q / p;
+            if (p < 0)
+            {
+                if (r > t1)
+                    return false;
+                t0 = (std::max)(t0, r);
+            }
+            else
+            {
+                if (r < t0)
+                    return false;
+                t1 = (std::min)(t1, r);
+            }
+            return true;
+        };
+        if (!clip(-dx, xval(p1) - xmin) || !clip(dx, xmax - xval(p1)) ||
+                !clip(-dy, yval(p1) - ymin) || !clip(dy, ymax - yval(p1)))
+            return false;
+
+        Point start = p1;
+        p1 = Point(xval(start) + t0 * dx, yval(start) + t0 * dy);
+        p2 = Point(xval(start) + t1 * dx, yval(start) + t1 * dy);
+        return true;
     }
 
 
@@ -359,7 +589,7 @@ private:
     // a known status (inside or outside the polygon).  So we just pick a point
     // that isn't collinear with any of the segments in the cell.  Eliminating
     // collinearity eliminates special cases when counting crossings.
-    void generateRefPoint(Cell& cell, XYIndex& pos) const
+    void generateRefPoint(Grid<Cell>& grid, Cell& cell, XYIndex& pos) const
     {
         // A test point is valid if it's not collinear with any segments
         // in the cell.
@@ -371,12 +601,14 @@ private:
             return true;
         };
 
-        Grid<Cell>::Point origin = m_grid->cellOrigin(pos);
+        std::uniform_real_distribution<> xDistribution(0, grid.cellWidth());
+        std::uniform_real_distribution<> yDistribution(0, grid.cellHeight());
+        Grid<Cell>::Point origin = grid.cellOrigin(pos);
         double x, y;
         do
         {
-            x = xval(origin) + (*m_xDistribution)(m_ranGen);
-            y = yval(origin) + (*m_yDistribution)(m_ranGen);
+            x = xval(origin) + xDistribution(m_ranGen);
+            y = yval(origin) + yDistribution(m_ranGen);
         } while (!validTestPoint(x, y, cell));
         cell.setPoint(x, y);
     }
@@ -449,7 +681,7 @@ private:
     // Determine if a point in a cell is inside the polygon or outside.
     // We're always calling a point that lies on an edge as 'inside'
     // the polygon.
-    bool testCell(Cell& cell, double x, double y) const
+    bool testCell(const Cell& cell, double x, double y) const
     {
         Edge tester({x, y}, cell.point());
 
@@ -515,8 +747,6 @@ private:
 
     RingList m_rings;
     mutable std::mt19937 m_ranGen;
-    std::unique_ptr<std::uniform_real_distribution<>> m_xDistribution;
-    std::unique_ptr<std::uniform_real_distribution<>> m_yDistribution;
     std::unique_ptr<Grid<Cell>> m_grid;
     double m_xMin;
     double m_xMax;
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <pdal/Polygon.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include "Grid.hpp"
+#include "GridPnp.hpp"
+
+namespace pdal
+{
+
+// Index over a set of polygons for point-in-polygon queries.  The envelope
+// of each polygon is binned into a uniform grid that covers all the
+// polygons, so a point is only tested against those polygons whose
+// envelopes overlap the cell in which it falls.  Each polygon is tested
+// with a prepared GridPnp per part.
+//
+// Once build() has been called, the index isn't modified by queries and
+// can be used from multiple threads at once.
+class PolygonIndex
+{
+public:
+    using Id = size_t;
+    using IdList = std::vector<Id>;
+
+    // Add a polygon to the index.  Polygons are identified by the order
+    // in which they're added, starting at 0.
+    void add(const Polygon& poly)
+    {
+        Entry e;
+        BOX3D b = poly.bounds();
+        e.m_bounds = BOX2D(b.minx, b.miny, b.maxx, b.maxy);
+        for (const Polygon& p : poly.polygons())
+        {
+            std::unique_ptr<GridPnp> g(
+                new GridPnp(p.exteriorRing(), p.interiorRings()));
+            g->prepare();
+            e.m_parts.push_back(std::move(g));
+        }
+        m_entries.push_back(std::move(e));
+        m_grid.reset();
+    }
+
+    // Create the envelope grid.  Must be called after all polygons have
+    // been added and before any query.
+    void build()
+    {
+        BOX2D extent;
+        for (const Entry& e : m_entries)
+            if (e.m_parts.size())
+                extent.grow(e.m_bounds);
+        m_grid.reset();
+        if (extent.empty())
+            return;
+
+        // Aim for about four cells per polygon, but limit the size of
+        // the grid.
+        double width = (std::max)(extent.maxx - extent.minx,
+            std::numeric_limits<double>::epsilon());
+        double height = (std::max)(extent.maxy - extent.miny,
+            std::numeric_limits<double>::epsilon());
+        double cells = (std::min)(4.0 * m_entries.size(), 1024.0 * 1024.0);
+        double cellSize = std::sqrt(width * height / cells);
+        size_t xCount = (std::min)(
+            (size_t)std::ceil(width / cellSize), (size_t)1024);
+        size_t yCount = (std::min)(
+            (size_t)std::ceil(height / cellSize), (size_t)1024);
+        xCount = (std::max)(xCount, (size_t)1);
+        yCount = (std::max)(yCount, (size_t)1);
+
+        // Add a small margin so that points on the maximum edge of the
+        // extent fall in the grid.
+        double cellWidth = width / xCount * (1 + 1e-9);
+        double cellHeight = height / yCount * (1 + 1e-9);
+        m_grid.reset(new Grid<IdList>(xCount, yCount, cellWidth, cellHeight,
+            extent.minx, extent.miny));
+
+        // Ids are added in order, so each cell's list is sorted.
+        for (Id id = 0; id < m_entries.size(); ++id)
+        {
+            const Entry& e = m_entries[id];
+            if (e.m_parts.empty())
+                continue;
+            Grid<IdList>::Pos lo, hi;
+            cellRange(e.m_bounds.minx, e.m_bounds.miny, lo);
+            cellRange(e.m_bounds.maxx, e.m_bounds.maxy, hi);
+            for (size_t y = lo.second; y <= hi.second; ++y)
+                for (size_t x = lo.first; x <= hi.first; ++x)
+                    m_grid->cell(x, y).push_back(id);
+        }
+    }
+
+    // Number of polygons in the index.
+    size_t size() const
+        { return m_entries.size(); }
+
+    // Return the IDs of the polygons whose envelopes overlap the grid cell
+    // containing the position, in ascending order.  Polygons in the list
+    // don't necessarily contain the position.
+    const IdList& candidates(double x, double y) const
+    {
+        static const IdList empty;
+
+        Grid<IdList>::Pos pos;
+        if (!m_grid || std::isnan(x) || std::isnan(y) ||
+                !m_grid->cellPos(x, y, pos))
+            return empty;
+        return m_grid->cell(pos);
+    }
+
+    // Determine if the polygon with the given ID contains the position.
+    bool contains(Id id, double x, double y) const
+    {
+        const Entry& e = m_entries[id];
+        if (x < e.m_bounds.minx || x > e.m_bounds.maxx ||
+                y < e.m_bounds.miny || y > e.m_bounds.maxy)
+            return false;
+        for (const std::unique_ptr<GridPnp>& g : e.m_parts)
+            if (g->inside(x, y))
+                return true;
+        return false;
+    }
+
+    // Determine if the polygon with the given ID contains each of 'count'
+    // positions, setting the corresponding entry of 'out' to 1 if so and
+    // 0 otherwise.
+    void contains(Id id, const double *x, const double *y, size_t count,
+        char *out) const
+    {
+        const Entry& e = m_entries[id];
+        std::fill(out, out + count, 0);
+        std::vector<char> part(count);
+        for (const std::unique_ptr<GridPnp>& g : e.m_parts)
+        {
+            g->inside(x, y, count, part.data());
+            for (size_t i = 0; i < count; ++i)
+                out[i] |= part[i];
+        }
+    }
+
+    // Return the highest ID of the polygons that contain the position,
+    // or -1 if no polygon contains it.
+    int64_t last(double x, double y) const
+    {
+        const IdList& ids = candidates(x, y);
+        for (auto it = ids.rbegin(); it != ids.rend(); ++it)
+            if (contains(*it, x, y))
+                return (int64_t)*it;
+        return -1;
+    }
+
+private:
+    struct Entry
+    {
+        BOX2D m_bounds;
+        std::vector<std::unique_ptr<GridPnp>> m_parts;
+    };
+
+    // Find the cell for a position, clamping to the grid.
+    void cellRange(double x, double y, Grid<IdList>::Pos& pos) const
+    {
+        Grid<IdList>::Point origin = m_grid->origin();
+        double xpos = (x - origin.first) / m_grid->cellWidth();
+        double ypos = (y - origin.second) / m_grid->cellHeight();
+        pos.first = (size_t)Utils::clamp(xpos, 0.0,
+            (double)(m_grid->width() - 1));
+        pos.second = (size_t)Utils::clamp(ypos, 0.0,
+            (double)(m_grid->height() - 1));
+    }
+
+    std::vector<Entry> m_entries;
+    std::unique_ptr<Grid<IdList>> m_grid;
+};
+
+} // namespace pdal
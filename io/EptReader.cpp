@@ -36,6 +36,7 @@
 
 #include <limits>
 
+#include "private/EptCache.hpp"
 #include "private/EptSupport.hpp"
 
 #include "LasReader.hpp"
@@ -64,6 +65,29 @@ namespace
 
     const std::string addonFilename { "ept-addon.json" };
 
+    std::string cacheDataName(const Key& key)
+    {
+        return "d-" + key.toString() + ".bin";
+    }
+
+    // Position of a node among the nodes of its depth when they're to be
+    // spread across space: the octant choices from the root down are
+    // interleaved with the coarsest in the lowest bits, so that any prefix
+    // of the sorted nodes is spread over the whole area.
+    uint64_t spreadOrder(const Key& key)
+    {
+        uint64_t code(0);
+        const uint64_t bits((std::min)(key.d, (uint64_t)21));
+        for (uint64_t i(0); i < bits; ++i)
+        {
+            const uint64_t shift(key.d - 1 - i);
+            code |= ((key.x >> shift) & 1) << (3 * i);
+            code |= ((key.y >> shift) & 1) << (3 * i + 1);
+            code |= ((key.z >> shift) & 1) << (3 * i + 2);
+        }
+        return code;
+    }
+
     Dimension::Type getRemoteType(const NL::json& dim)
     {
         try {
@@ -139,6 +163,11 @@ public:
     double m_resolution = 0;
     std::vector<Polygon> m_polys;
     NL::json m_addons;
+    std::string m_cache;
+    uint64_t m_cacheSize;
+    bool m_progressive;
+    point_count_t m_pointBudget;
+    double m_timeBudget;
 
     NL::json m_query;
     NL::json m_headers;
@@ -170,6 +199,16 @@ void EptReader::addArgs(ProgramArgs& args)
         m_args->m_query);
     args.add("ogr", "OGR filter geometries",
         m_args->m_ogr);
+    args.add("progressive", "Read nodes coarse to fine, spread over the "
+        "query area", m_args->m_progressive);
+    args.add("point_budget", "Maximum number of points to read",
+        m_args->m_pointBudget);
+    args.add("time_budget", "Time, in seconds, after which no more nodes "
+        "are read", m_args->m_timeBudget);
+    args.add("cache", "Directory in which to cache hierarchy and point data",
+        m_args->m_cache);
+    args.add("cache_size", "Maximum size of the cache, in megabytes",
+        m_args->m_cacheSize, (uint64_t)1024);
 }
 
 
@@ -237,7 +276,18 @@ void EptReader::initialize()
     debug << "Endpoint: " << m_ep->prefixedRoot() << std::endl;
     try
     {
-        m_info.reset(new EptInfo(parse(get("ept.json"))));
+        const std::string info(get("ept.json"));
+        m_info.reset(new EptInfo(parse(info)));
+
+        // Cached entries are only valid for the dataset as described by
+        // this ept.json.
+        if (m_args->m_cache.size())
+        {
+            m_cache = EptCache::open(m_args->m_cache,
+                m_args->m_cacheSize * 1024 * 1024);
+            m_cacheDataset =
+                EptCache::datasetId(m_ep->prefixedRoot(), info);
+        }
     }
     catch (std::exception& e)
     {
@@ -245,6 +295,9 @@ void EptReader::initialize()
     }
     debug << "Got EPT info" << std::endl;
     debug << "SRS: " << m_info->srs() << std::endl;
+    if (m_cache)
+        debug << "Cache: " << m_args->m_cache << "/" << m_cacheDataset <<
+            std::endl;
 
     setSpatialReference(m_info->srs());
 
@@ -488,6 +541,25 @@ void EptReader::addDimensions(PointLayoutPtr layout)
 
     m_remoteLayout->finalize();
 
+    // Decoded LAZ points have scaled XYZ, so they're cached as doubles.
+    // Dimensions are registered in the same order as in the remote layout
+    // so that IDs match.
+    if (m_cache && m_info->dataType() == EptInfo::DataType::Laszip)
+    {
+        m_lasCacheLayout.reset(new FixedPointLayout());
+        for (auto& el : schema)
+        {
+            const std::string name(el["name"].get<std::string>());
+            const Dimension::Id id(Dimension::id(name));
+            const Dimension::Type type =
+                (id == Dimension::Id::X || id == Dimension::Id::Y ||
+                    id == Dimension::Id::Z) ?
+                Dimension::Type::Double : getRemoteType(el);
+            m_lasCacheLayout->registerOrAssignFixedDim(name, type);
+        }
+        m_lasCacheLayout->finalize();
+    }
+
     using D = Dimension::Id;
 
     m_dimTypes = m_remoteLayout->dimTypes();
@@ -563,6 +635,14 @@ void EptReader::ready(PointTableRef table)
     m_pointIdDim = table.layout()->findDim("EptPointId");
 
     m_overlaps.clear();
+    m_deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(m_args->m_timeBudget));
+
+    // Points are tested against the query polygons on several threads.
+    // Make sure the polygons' lookup structures are complete before that.
+    for (Polygon& poly : m_args->m_polys)
+        poly.prepare();
 
     // Determine all overlapping data files we'll need to fetch.
     try
@@ -573,6 +653,7 @@ void EptReader::ready(PointTableRef table)
     {
         throwError(e.what());
     }
+    orderNodes();
 
     point_count_t overlapPoints(0);
 
@@ -606,23 +687,41 @@ void EptReader::ready(PointTableRef table)
     }
 }
 
-void EptReader::overlaps()
+std::shared_ptr<const NL::json> EptReader::fetchHierarchy(
+    const arbiter::Endpoint& ep, const Key& key) const
 {
-    auto parseEndpoint = [this](const arbiter::Endpoint& ep,
-        const std::string file)
+    // Addons are generally local and change independently of the EPT
+    // resource, so only the resource's hierarchy is cached.
+    const bool local(&ep == m_ep.get());
+    const bool cached(local && m_cache);
+    const std::string name("h-" + key.toString() + ".json");
+
+    std::shared_ptr<const NL::json> j;
+    if (cached)
     {
-        NL::json j;
-        try
-        {
-            j = NL::json::parse(get(file));
-        }
-        catch (NL::json::parse_error&)
-        {
-            throwError("Error parsing EPT hierarchy file '" + file + "'.");
-        }
-        return j;
-    };
+        j = m_cache->hierarchy(m_cacheDataset, name);
+        if (j)
+            return j;
+    }
+
+    const std::string file("ept-hierarchy/" + key.toString() + ".json");
+    const std::string text(local ? get(file) : ep.get(file));
+    try
+    {
+        j.reset(new NL::json(NL::json::parse(text)));
+    }
+    catch (NL::json::parse_error&)
+    {
+        throw ept_error("Error parsing EPT hierarchy file '" + file + "'.");
+    }
 
+    if (cached)
+        m_cache->putHierarchy(m_cacheDataset, name, text, j);
+    return j;
+}
+
+void EptReader::overlaps()
+{
     // Determine all the keys that overlap the queried area by traversing the
     // EPT hierarchy:
     //      https://entwine.io/entwine-point-tile.html#ept-hierarchy)
@@ -631,24 +730,21 @@ void EptReader::overlaps()
     // thread pool.
     Key key;
     key.b = m_info->bounds();
-    const std::string file("ept-hierarchy/" + key.toString() + ".json");
 
     {
-        const NL::json root = parseEndpoint(*m_ep, file);
+        const auto root(fetchHierarchy(*m_ep, key));
         // First, determine the overlapping nodes from the EPT resource.
-        overlaps(*m_ep, m_overlaps, root, key);
+        overlaps(*m_ep, m_overlaps, *root, key);
         m_pool->await();
     }
 
     for (auto& addon : m_addons)
     {
         // Next, determine the overlapping nodes from each addon dimension.
-        const NL::json root = parseEndpoint(addon->ep(), file);
-        overlaps(addon->ep(), addon->hierarchy(), root, key);
+        const auto root(fetchHierarchy(addon->ep(), key));
+        overlaps(addon->ep(), addon->hierarchy(), *root, key);
         m_pool->await();
     }
-
-    m_overlapIt = m_overlaps.begin();
 }
 
 void EptReader::overlaps(const arbiter::Endpoint& ep,
@@ -684,9 +780,8 @@ void EptReader::overlaps(const arbiter::Endpoint& ep,
         // hierarchy subtree corresponding to this root.
         m_pool->add([this, &ep, &target, key]()
         {
-            const auto subRoot(parse(ep.get(
-                            "ept-hierarchy/" + key.toString() + ".json")));
-            overlaps(ep, target, subRoot, key);
+            const auto subRoot(fetchHierarchy(ep, key));
+            overlaps(ep, target, *subRoot, key);
         });
     }
     else
@@ -702,6 +797,62 @@ void EptReader::overlaps(const arbiter::Endpoint& ep,
     }
 }
 
+void EptReader::orderNodes()
+{
+    auto build = [this]()
+    {
+        m_nodes.clear();
+        uint64_t nodeId(1);
+        for (auto it = m_overlaps.cbegin(); it != m_overlaps.cend(); ++it)
+            m_nodes.emplace_back(it, nodeId++);
+
+        // Keys sort by depth first, so this only changes the order of
+        // nodes within a depth.
+        if (m_args->m_progressive)
+            std::stable_sort(m_nodes.begin(), m_nodes.end(),
+                [](const Node& a, const Node& b)
+                {
+                    const Key& ka(a.first->first);
+                    const Key& kb(b.first->first);
+                    if (ka.d != kb.d)
+                        return ka.d < kb.d;
+                    return spreadOrder(ka) < spreadOrder(kb);
+                });
+    };
+
+    build();
+    m_nodeIndex = 0;
+    if (!m_args->m_pointBudget)
+        return;
+
+    // Take nodes in order until the budget is reached.  The first node
+    // is always read.
+    point_count_t total(0);
+    std::size_t count(0);
+    for (; count < m_nodes.size(); ++count)
+    {
+        total += m_nodes[count].first->second;
+        if (count && total > m_args->m_pointBudget)
+            break;
+    }
+    if (count == m_nodes.size())
+        return;
+
+    log()->get(LogLevel::Debug) << "Point budget allows " << count << "/" <<
+        m_nodes.size() << " nodes" << std::endl;
+    for (std::size_t i(count); i < m_nodes.size(); ++i)
+        m_overlaps.erase(m_nodes[i].first);
+    build();
+}
+
+
+bool EptReader::expired() const
+{
+    return m_args->m_timeBudget > 0 &&
+        std::chrono::steady_clock::now() > m_deadline;
+}
+
+
 PointViewSet EptReader::run(PointViewPtr view)
 {
 #ifndef PDAL_HAVE_ZSTD
@@ -710,31 +861,36 @@ PointViewSet EptReader::run(PointViewPtr view)
             "PDAL must be configured with WITH_ZSTD=On");
 #endif
 
-    // Start these at 1 to differentiate from points added by other stages,
-    // which will be ignored by the EPT writer.
-    uint64_t nodeId(1);
-
+    // Reserve room for the points of every node up front, using the point
+    // counts from the hierarchy.  Each node is then decoded into its own
+    // range of the view.
+    const PointId viewStart(view->size());
+    point_count_t total(0);
     for (const auto& entry : m_overlaps)
+        total += entry.second;
+    reserve(*view, total);
+    std::vector<char> keep(total, 0);
+
+    // Nodes are placed in the view in the order they're read.  Once the
+    // time budget is used up, the remaining nodes are skipped and their
+    // points dropped below.
+    PointId startId(viewStart);
+    for (const Node& node : m_nodes)
     {
-        const Key& key(entry.first);
+        const Key& key(node.first->first);
+        const uint64_t nodeId(node.second);
+        const bool first(startId == viewStart);
 
         log()->get(LogLevel::Debug) << "Data " << nodeId << "/" <<
             m_overlaps.size() << ": " << key.toString() << std::endl;
 
-        m_pool->add([this, &view, &key, nodeId]()
+        char *nodeKeep = keep.data() + (startId - viewStart);
+        m_pool->add([this, &view, &key, nodeId, startId, nodeKeep, first]()
         {
-            PointId startId(0);
+            if (!first && expired())
+                return;
 
-            if (m_info->dataType() == EptInfo::DataType::Laszip)
-                startId = readLaszip(*view, key, nodeId);
-            else if (m_info->dataType() == EptInfo::DataType::Binary)
-                startId = readBinary(*view, key, nodeId);
-#ifdef PDAL_HAVE_ZSTD
-            else if (m_info->dataType() == EptInfo::DataType::Zstandard)
-                startId = readZstandard(*view, key, nodeId);
-#endif
-            else
-                throw ept_error("Unrecognized EPT dataType");
+            readNode(*view, key, nodeId, startId, nodeKeep);
 
             // Read addon information after the native data, we'll possibly
             // overwrite attributes.
@@ -742,21 +898,64 @@ PointViewSet EptReader::run(PointViewPtr view)
                 readAddon(*view, key, *addon, startId);
         });
 
-        ++nodeId;
+        startId += node.first->second;
     }
 
     m_pool->await();
     log()->get(LogLevel::Debug) << "Done reading!" << std::endl;
 
+    // Drop the points that were outside of the query, if any.
+    PointViewPtr out(view);
+    if (std::find(keep.begin(), keep.end(), 0) != keep.end())
+    {
+        out = view->makeNew();
+        for (PointId id(0); id < viewStart; ++id)
+            out->appendPoint(*view, id);
+        for (PointId i(0); i < total; ++i)
+            if (keep[i])
+                out->appendPoint(*view, viewStart + i);
+    }
+
     PointViewSet views;
-    views.insert(view);
+    views.insert(out);
     return views;
 }
 
 
-PointId EptReader::readLaszip(PointView& dst, const Key& key,
-        const uint64_t nodeId) const
+void EptReader::reserve(PointView& view, point_count_t count) const
+{
+    for (point_count_t i(0); i < count; ++i)
+        view.getOrAddPoint(view.size());
+}
+
+
+void EptReader::readNode(PointView& view, const Key& key, uint64_t nodeId,
+    PointId startId, char *keep) const
+{
+    if (m_info->dataType() == EptInfo::DataType::Laszip)
+        readLaszip(view, key, nodeId, startId, keep);
+    else if (m_info->dataType() == EptInfo::DataType::Binary)
+        readBinary(view, key, nodeId, startId, keep);
+#ifdef PDAL_HAVE_ZSTD
+    else if (m_info->dataType() == EptInfo::DataType::Zstandard)
+        readZstandard(view, key, nodeId, startId, keep);
+#endif
+    else
+        throw ept_error("Unrecognized EPT dataType");
+}
+
+
+void EptReader::readLaszip(PointView& dst, const Key& key,
+    const uint64_t nodeId, PointId startId, char *keep) const
 {
+    std::vector<char> data;
+    if (m_cache && m_cache->data(m_cacheDataset, cacheDataName(key), data))
+    {
+        processPackedData(dst, key, nodeId, startId, keep, *m_lasCacheLayout,
+            data.data(), data.size());
+        return;
+    }
+
     // If the file is remote (HTTP, S3, Dropbox, etc.), getLocalHandle will
     // download the file and `localPath` will return the location of the
     // downloaded file in a temporary directory.  Otherwise it's a no-op.
@@ -777,72 +976,117 @@ PointId EptReader::readLaszip(PointView& dst, const Key& key,
 
     const auto views(reader.execute(table));
 
+    const point_count_t count(m_overlaps.at(key));
     PointId pointId(0);
+    for (auto& src : views)
+        pointId += src->size();
+    if (pointId > count)
+        throw ept_error("Node " + key.toString() + " contains more "
+            "points than its hierarchy entry.");
+
+    if (m_cache)
+    {
+        // Store the decoded points so that they needn't be decompressed
+        // again, then process them like any other packed data.
+        const DimTypeList dims(m_lasCacheLayout->dimTypes());
+        data.resize(pointId * m_lasCacheLayout->pointSize());
+        ShallowPointTable cacheTable(*m_lasCacheLayout, data.data(),
+            data.size());
+        PointRef out(cacheTable);
+        PointId cacheId(0);
+        for (auto& src : views)
+        {
+            PointRef pr(*src);
+            for (PointId i(0); i < src->size(); ++i)
+            {
+                pr.setPointId(i);
+                out.setPointId(cacheId++);
+                for (const DimType& dt : dims)
+                    out.setField(dt.m_id, pr.getFieldAs<double>(dt.m_id));
+            }
+        }
+        m_cache->putData(m_cacheDataset, cacheDataName(key), data.data(),
+            data.size());
+        processPackedData(dst, key, nodeId, startId, keep, *m_lasCacheLayout,
+            data.data(), data.size());
+        return;
+    }
 
-    lock.lock();
-    const PointId startId(dst.size());
+    pointId = 0;
     for (auto& src : views)
     {
         PointRef pr(*src);
         for (uint64_t i(0); i < src->size(); ++i)
         {
             pr.setPointId(i);
-            process(dst, pr, nodeId, pointId);
+            keep[pointId] = process(dst, pr, nodeId, pointId,
+                startId + pointId);
             ++pointId;
         }
     }
-
-    return startId;
 }
 
-PointId EptReader::processPackedData(PointView& dst, const uint64_t nodeId,
+void EptReader::processPackedData(PointView& dst, const Key& key,
+    const uint64_t nodeId, PointId startId, char *keep, PointLayout& layout,
     char* data, const uint64_t size) const
 {
-    ShallowPointTable table(*m_remoteLayout, data, size);
+    ShallowPointTable table(layout, data, size);
     PointRef pr(table);
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    if (table.numPoints() > m_overlaps.at(key))
+        throw ept_error("Node " + key.toString() + " contains more "
+            "points than its hierarchy entry.");
 
-    const PointId startId(dst.size());
     for (PointId pointId(0); pointId < table.numPoints(); ++pointId)
     {
         pr.setPointId(pointId);
-        process(dst, pr, nodeId, pointId);
+        keep[pointId] = process(dst, pr, nodeId, pointId, startId + pointId);
     }
-
-    return startId;
 }
 
-PointId EptReader::readBinary(PointView& dst, const Key& key,
-        const uint64_t nodeId) const
+void EptReader::readBinary(PointView& dst, const Key& key,
+    const uint64_t nodeId, PointId startId, char *keep) const
 {
-    auto data(getBinary("ept-data/" + key.toString() + ".bin"));
-    return processPackedData(dst, nodeId, data.data(), data.size());
+    std::vector<char> data;
+    if (!m_cache || !m_cache->data(m_cacheDataset, cacheDataName(key), data))
+    {
+        data = getBinary("ept-data/" + key.toString() + ".bin");
+        if (m_cache)
+            m_cache->putData(m_cacheDataset, cacheDataName(key), data.data(),
+                data.size());
+    }
+    processPackedData(dst, key, nodeId, startId, keep, *m_remoteLayout,
+        data.data(), data.size());
 }
 
 #ifdef PDAL_HAVE_ZSTD
-uint64_t EptReader::readZstandard(PointView& dst, const Key& key,
-        const uint64_t nodeId) const
+void EptReader::readZstandard(PointView& dst, const Key& key,
+    const uint64_t nodeId, PointId startId, char *keep) const
 {
-    auto compressed(m_ep->getBinary("ept-data/" + key.toString() + ".zst"));
     std::vector<char> data;
-    pdal::ZstdDecompressor dec([&data](char* pos, std::size_t size)
+    if (!m_cache || !m_cache->data(m_cacheDataset, cacheDataName(key), data))
     {
-        data.insert(data.end(), pos, pos + size);
-    });
+        auto compressed(getBinary("ept-data/" + key.toString() + ".zst"));
+        pdal::ZstdDecompressor dec([&data](char* pos, std::size_t size)
+        {
+            data.insert(data.end(), pos, pos + size);
+        });
 
-    dec.decompress(compressed.data(), compressed.size());
-    return processPackedData(dst, nodeId, data.data(), data.size());
+        dec.decompress(compressed.data(), compressed.size());
+        if (m_cache)
+            m_cache->putData(m_cacheDataset, cacheDataName(key), data.data(),
+                data.size());
+    }
+    processPackedData(dst, key, nodeId, startId, keep, *m_remoteLayout,
+        data.data(), data.size());
 }
 #endif
 
-void EptReader::process(PointView& dst, PointRef& pr, const uint64_t nodeId,
-        const PointId pointId) const
+bool EptReader::process(PointView& dst, PointRef& pr, const uint64_t nodeId,
+        const PointId pointId, const PointId dstId) const
 {
     using D = Dimension::Id;
 
-    const point_count_t dstId(dst.size());
-
     const double x = pr.getFieldAs<double>(D::X) *
         m_xyzTransforms[0].m_scale.m_val + m_xyzTransforms[0].m_offset.m_val;
     const double y = pr.getFieldAs<double>(D::Y) *
@@ -864,26 +1108,28 @@ void EptReader::process(PointView& dst, PointRef& pr, const uint64_t nodeId,
         return false;
     };
 
-    if (selected && m_queryBounds.contains(x, y, z) && passesPolyFilter(x, y))
-    {
-        dst.setField(Dimension::Id::X, dstId, x);
-        dst.setField(Dimension::Id::Y, dstId, y);
-        dst.setField(Dimension::Id::Z, dstId, z);
+    if (!selected || !m_queryBounds.contains(x, y, z) ||
+        !passesPolyFilter(x, y))
+        return false;
 
-        for (const DimType& dt : m_dimTypes)
+    dst.setField(Dimension::Id::X, dstId, x);
+    dst.setField(Dimension::Id::Y, dstId, y);
+    dst.setField(Dimension::Id::Z, dstId, z);
+
+    for (const DimType& dt : m_dimTypes)
+    {
+        if (dt.m_id != D::X && dt.m_id != D::Y && dt.m_id != D::Z)
         {
-            if (dt.m_id != D::X && dt.m_id != D::Y && dt.m_id != D::Z)
-            {
-                const double d = pr.getFieldAs<double>(dt.m_id) *
-                    dt.m_xform.m_scale.m_val + dt.m_xform.m_offset.m_val;
+            const double d = pr.getFieldAs<double>(dt.m_id) *
+                dt.m_xform.m_scale.m_val + dt.m_xform.m_offset.m_val;
 
-                dst.setField(dt.m_id, dstId, d);
-            }
+            dst.setField(dt.m_id, dstId, d);
         }
-
-        dst.setField(m_nodeIdDim, dstId, nodeId);
-        dst.setField(m_pointIdDim, dstId, pointId);
     }
+
+    dst.setField(m_nodeIdDim, dstId, nodeId);
+    dst.setField(m_pointIdDim, dstId, pointId);
+    return true;
 }
 
 
@@ -902,9 +1148,6 @@ void EptReader::readAddon(PointView& dst, const Key& key, const Addon& addon,
         // for an EPT-read of the full dataset.  If the native EPT set already
         // contains Classification, then we should overwrite it with zeroes
         // where the addon leaves off.
-
-        std::lock_guard<std::mutex> lock(m_mutex);
-
         np = m_overlaps.at(key);
         for (PointId id(pointId); id < pointId + np; ++id)
         {
@@ -927,7 +1170,6 @@ void EptReader::readAddon(PointView& dst, const Key& key, const Addon& addon,
         throwError("Invalid addon content length");
     }
 
-    std::lock_guard<std::mutex> lock(m_mutex);
     const char* pos(data.data());
     for (PointId id(pointId); id < pointId + np; ++id)
     {
@@ -952,6 +1194,7 @@ struct EptReader::NodeBuffer
     NodeBuffer(PointLayout& layout) : table(layout), view(table) { }
     VectorPointTable table;
     PointView view;
+    std::vector<char> keep;
 };
 
 void EptReader::load()
@@ -960,11 +1203,19 @@ void EptReader::load()
     // a lookahead buffer of nodes.
     while (
         m_upcomingNodeBuffers.size() < m_pool->size() &&
-        m_overlapIt != m_overlaps.end())
+        m_nodeIndex < m_nodes.size())
     {
-        const auto nodeId(m_nodeId++);
-        const auto key(m_overlapIt->first);
-        ++m_overlapIt;
+        if (m_nodeIndex && expired())
+        {
+            log()->get(LogLevel::Debug) << "Time budget used after " <<
+                m_nodeIndex << "/" << m_nodes.size() << " nodes" << std::endl;
+            m_nodeIndex = m_nodes.size();
+            break;
+        }
+
+        const Node& node(m_nodes[m_nodeIndex++]);
+        const auto nodeId(node.second);
+        const auto key(node.first->first);
 
         log()->get(LogLevel::Debug) << nodeId << "/" << m_overlaps.size() <<
             std::endl;
@@ -981,16 +1232,11 @@ void EptReader::load()
             std::unique_ptr<NodeBuffer> nodeBuffer(
                 new NodeBuffer(*m_userLayout));
 
-            if (m_info->dataType() == EptInfo::DataType::Laszip)
-                readLaszip(nodeBuffer->view, key, nodeId);
-#ifdef PDAL_HAVE_ZSTD
-            else if (m_info->dataType() == EptInfo::DataType::Zstandard)
-                readZstandard(nodeBuffer->view, key, nodeId);
-#endif
-            else if (m_info->dataType() == EptInfo::DataType::Binary)
-                readBinary(nodeBuffer->view, key, nodeId);
-            else
-                throw ept_error("Unrecognized EPT dataType");
+            const point_count_t count(m_overlaps.at(key));
+            reserve(nodeBuffer->view, count);
+            nodeBuffer->keep.resize(count, 0);
+            readNode(nodeBuffer->view, key, nodeId, 0,
+                nodeBuffer->keep.data());
 
             for (const auto& addon : m_addons)
                 readAddon(nodeBuffer->view, key, *addon);
@@ -1007,6 +1253,15 @@ void EptReader::load()
 
 EptReader::NodeBufferIt EptReader::findBuffer()
 {
+    // In progressive mode, nodes are handed out in the order they were
+    // requested.  New requests are at the front of the list.
+    if (m_args->m_progressive)
+    {
+        if (m_upcomingNodeBuffers.size() && m_upcomingNodeBuffers.back())
+            return std::prev(m_upcomingNodeBuffers.end());
+        return m_upcomingNodeBuffers.end();
+    }
+
     return std::find_if(
         m_upcomingNodeBuffers.begin(),
         m_upcomingNodeBuffers.end(),
@@ -1043,15 +1298,19 @@ bool EptReader::next()
 
 bool EptReader::processOne(PointRef& point)
 {
-    while (!m_currentNodeBuffer)
+    while (true)
     {
-        if (!next()) return false;
+        if (!m_currentNodeBuffer && !next()) return false;
 
         // If we have a query bounds or query polygon, it's possible that the
-        // octree bounds of a node overlaps the query, but this node contains
-        // no matching points for the query.  So we may have a zero point
-        // buffer which we have to handle.
-        if (m_currentNodeBuffer->view.empty()) m_currentNodeBuffer.reset();
+        // octree bounds of a node overlaps the query, but some or all of the
+        // points of the node don't match the query.  Skip those.
+        const std::vector<char>& keep(m_currentNodeBuffer->keep);
+        while (m_pointId < keep.size() && !keep[m_pointId])
+            ++m_pointId;
+        if (m_pointId < keep.size())
+            break;
+        m_currentNodeBuffer.reset();
     }
 
     auto& sourceView(m_currentNodeBuffer->view);
@@ -1065,7 +1324,7 @@ bool EptReader::processOne(PointRef& point)
             sourceView.getPoint(m_pointId) + layout.dimOffset(id));
     }
 
-    if (++m_pointId == sourceView.size()) m_currentNodeBuffer.reset();
+    ++m_pointId;
 
     return true;
 }
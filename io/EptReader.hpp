@@ -35,6 +35,7 @@
 #pragma once
 
 #include <array>
+#include <chrono>
 #include <condition_variable>
 #include <list>
 #include <map>
@@ -60,6 +61,7 @@ namespace arbiter
 }
 
 class Addon;
+class EptCache;
 class EptInfo;
 class FixedPointLayout;
 class Key;
@@ -100,14 +102,36 @@ private:
     void overlaps(const arbiter::Endpoint& ep, std::map<Key, uint64_t>& target,
             const NL::json& current, const Key& key);
 
-    PointId readLaszip(PointView& view, const Key& key, uint64_t nodeId) const;
-    PointId readBinary(PointView& view, const Key& key, uint64_t nodeId) const;
-    PointId readZstandard(PointView& view, const Key& key, uint64_t nodeId)
-        const;
-    PointId processPackedData(PointView& view, uint64_t nodeId, char* data,
+    // Decide the order in which overlapping nodes are read, and drop those
+    // beyond the point budget.
+    void orderNodes();
+
+    // Whether the time budget, if any, has been used up.
+    bool expired() const;
+
+    // Fetch and parse the hierarchy file for a key, using the local cache
+    // for the EPT resource if one was requested.
+    std::shared_ptr<const NL::json> fetchHierarchy(
+        const arbiter::Endpoint& ep, const Key& key) const;
+
+    // The points of a node are decoded into a range of the view reserved
+    // for them, starting at 'startId', so that nodes can be decoded
+    // concurrently without locking.  Each point's entry in 'keep' is set
+    // if it passes the query.
+    void reserve(PointView& view, point_count_t count) const;
+    void readNode(PointView& view, const Key& key, uint64_t nodeId,
+        PointId startId, char *keep) const;
+    void readLaszip(PointView& view, const Key& key, uint64_t nodeId,
+        PointId startId, char *keep) const;
+    void readBinary(PointView& view, const Key& key, uint64_t nodeId,
+        PointId startId, char *keep) const;
+    void readZstandard(PointView& view, const Key& key, uint64_t nodeId,
+        PointId startId, char *keep) const;
+    void processPackedData(PointView& view, const Key& key, uint64_t nodeId,
+        PointId startId, char *keep, PointLayout& layout, char* data,
         uint64_t size) const;
-    void process(PointView& view, PointRef& pr, uint64_t nodeId,
-        PointId pointId) const;
+    bool process(PointView& view, PointRef& pr, uint64_t nodeId,
+        PointId pointId, PointId dstId) const;
 
     void readAddon(PointView& dst, const Key& key, const Addon& addon,
         PointId startId = 0) const;
@@ -146,6 +170,8 @@ private:
     int64_t m_queryOriginId = -1;
     std::unique_ptr<Pool> m_pool;
     std::vector<std::unique_ptr<Addon>> m_addons;
+    std::shared_ptr<EptCache> m_cache;
+    std::string m_cacheDataset;
 
     using StringMap = std::map<std::string, std::string>;
     StringMap m_headers;
@@ -156,10 +182,20 @@ private:
 
     using Overlaps = std::map<Key, uint64_t>;
     Overlaps m_overlaps;
+
+    // Overlapping nodes in the order they're read, with their node IDs.
+    // Node IDs are assigned in key order, which is what the EPT writers
+    // expect.
+    using Node = std::pair<Overlaps::const_iterator, uint64_t>;
+    std::vector<Node> m_nodes;
+    std::chrono::steady_clock::time_point m_deadline;
+
     uint64_t m_depthEnd = 0;    // Zero indicates selection of all depths.
     uint64_t m_hierarchyStep = 0;
 
     std::unique_ptr<FixedPointLayout> m_remoteLayout;
+    // Layout of decoded LAZ nodes stored in the cache.
+    std::unique_ptr<FixedPointLayout> m_lasCacheLayout;
     DimTypeList m_dimTypes;
     std::array<XForm, 3> m_xyzTransforms;
 
@@ -181,8 +217,7 @@ private:
 
     // The below represent our current state in streaming operation - in normal
     // mode we use local variables for these.
-    Overlaps::const_iterator m_overlapIt;
-    uint64_t m_nodeId = 1;
+    std::size_t m_nodeIndex = 0;
     PointId m_pointId = 0;
 };
 
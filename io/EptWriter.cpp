@@ -0,0 +1,750 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "EptWriter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+
+#include <arbiter/arbiter.hpp>
+#include <nlohmann/json.hpp>
+
+#include <pdal/PointView.hpp>
+#include <pdal/compression/ZstdCompression.hpp>
+#include <pdal/util/FileUtils.hpp>
+
+#include "BufferReader.hpp"
+#include "LasWriter.hpp"
+#include "private/EptSupport.hpp"
+
+namespace pdal
+{
+
+namespace
+{
+    const StaticPluginInfo s_info
+    {
+        "writers.ept",
+        "EPT Writer",
+        "http://pdal.io/stages/writers.ept.html",
+        {}
+    };
+
+    // Nodes at this depth are leaves no matter how many points they hold,
+    // which stops a stack of coincident points from growing the tree
+    // without limit.
+    const uint64_t MaxDepth = 24;
+
+    std::string getTypeString(Dimension::Type t)
+    {
+        const auto base(Dimension::base(t));
+
+        if (base == Dimension::BaseType::Signed)
+            return "signed";
+        else if (base == Dimension::BaseType::Unsigned)
+            return "unsigned";
+        return "float";
+    }
+}
+
+CREATE_STATIC_STAGE(EptWriter, s_info)
+
+
+// Points waiting to be placed in the tree.  They're held in memory until
+// the writer's memory limit is reached, after which a buffer being added
+// to moves its points to a temporary file.
+class EptWriter::PointBuffer
+{
+public:
+    PointBuffer(const std::string& path, std::size_t pointSize,
+            std::atomic<point_count_t>& buffered, point_count_t limit) :
+        m_path(path), m_pointSize(pointSize), m_buffered(buffered),
+        m_limit(limit)
+    {}
+
+    ~PointBuffer()
+    {
+        release();
+    }
+
+    point_count_t count() const
+        { return m_count; }
+    bool spilled() const
+        { return m_spilled; }
+
+    void append(const char *pos)
+    {
+        m_data.insert(m_data.end(), pos, pos + m_pointSize);
+        ++m_count;
+        if (m_spilled)
+        {
+            if (m_data.size() >= WriteSize)
+                flush();
+        }
+        // Account for the memory we use in steps to avoid contention.
+        else if (++m_pending == AccountStep)
+        {
+            m_accounted += m_pending;
+            const point_count_t total = (m_buffered += m_pending);
+            m_pending = 0;
+            if (total > m_limit)
+                spill();
+        }
+    }
+
+    // Called when no more points will be added.  A spilled buffer is
+    // finished so that it holds no memory or open file while waiting to be
+    // consumed.  Others are spilled if we're over the memory limit.
+    void close()
+    {
+        if (!m_spilled)
+        {
+            m_accounted += m_pending;
+            const point_count_t total = (m_buffered += m_pending);
+            m_pending = 0;
+            if (total > m_limit)
+                spill();
+        }
+        if (m_out)
+        {
+            flush();
+            m_out.reset();
+            std::vector<char>().swap(m_data);
+        }
+    }
+
+    // Call 'f' with each point, then release the points.
+    template<typename F>
+    void consume(F f)
+    {
+        if (!m_spilled)
+        {
+            const char *end = m_data.data() + m_data.size();
+            for (const char *pos = m_data.data(); pos < end;
+                    pos += m_pointSize)
+                f(pos);
+            release();
+            return;
+        }
+
+        close();
+
+        std::ifstream in(m_path, std::ios::in | std::ios::binary);
+        std::vector<char> block(ReadPoints * m_pointSize);
+        point_count_t remaining(m_count);
+        while (remaining)
+        {
+            const point_count_t count = (std::min)(remaining, ReadPoints);
+            in.read(block.data(), count * m_pointSize);
+            if (!in)
+                throw pdal_error("Error reading temporary file '" +
+                    m_path + "'.");
+            const char *pos = block.data();
+            for (point_count_t i = 0; i < count; ++i, pos += m_pointSize)
+                f(pos);
+            remaining -= count;
+        }
+        in.close();
+        release();
+    }
+
+private:
+    static const std::size_t WriteSize = 1 << 20;
+    static const point_count_t ReadPoints = 1 << 16;
+    static const point_count_t AccountStep = 1 << 12;
+
+    void spill()
+    {
+        m_out.reset(new std::ofstream(m_path,
+            std::ios::out | std::ios::binary | std::ios::trunc));
+        if (!*m_out)
+            throw pdal_error("Unable to create temporary file '" +
+                m_path + "'.");
+        m_spilled = true;
+        flush();
+        std::vector<char>().swap(m_data);
+        m_buffered -= m_accounted;
+        m_accounted = 0;
+    }
+
+    void flush()
+    {
+        m_out->write(m_data.data(), m_data.size());
+        if (!*m_out)
+            throw pdal_error("Error writing temporary file '" +
+                m_path + "'.");
+        m_data.clear();
+    }
+
+    void release()
+    {
+        std::vector<char>().swap(m_data);
+        m_buffered -= m_accounted;
+        m_accounted = 0;
+        m_pending = 0;
+        m_count = 0;
+        if (m_spilled)
+        {
+            m_out.reset();
+            FileUtils::deleteFile(m_path);
+            m_spilled = false;
+        }
+    }
+
+    std::string m_path;
+    std::size_t m_pointSize;
+    std::atomic<point_count_t>& m_buffered;
+    point_count_t m_limit;
+
+    std::vector<char> m_data;
+    std::unique_ptr<std::ofstream> m_out;
+    point_count_t m_count = 0;
+    point_count_t m_pending = 0;
+    point_count_t m_accounted = 0;
+    bool m_spilled = false;
+};
+
+
+struct EptWriter::Args
+{
+    std::string m_filename;
+    std::string m_dataType;
+    uint64_t m_span;
+    point_count_t m_maxNodeSize;
+    double m_scale;
+    uint64_t m_hierarchyStep;
+    uint64_t m_bufferSize;
+    std::string m_tempDir;
+    std::size_t m_threads;
+};
+
+
+EptWriter::EptWriter() : m_args(new Args), m_buffered(0)
+{}
+
+
+EptWriter::~EptWriter()
+{}
+
+
+std::string EptWriter::getName() const { return s_info.name; }
+
+
+void EptWriter::addArgs(ProgramArgs& args)
+{
+    args.add("filename", "Output directory", m_args->m_filename).
+        setPositional();
+    args.add("data_type", "Format of node data: 'laszip', 'binary' or "
+        "'zstandard'", m_args->m_dataType, "binary");
+    args.add("span", "Number of grid cells across each node",
+        m_args->m_span, (uint64_t)128);
+    args.add("max_node_size", "Nodes with at most this many points "
+        "aren't split", m_args->m_maxNodeSize, (point_count_t)65536);
+    args.add("scale", "Scale of X, Y and Z", m_args->m_scale, .01);
+    args.add("hierarchy_step", "Depth interval at which the hierarchy "
+        "is split into separate files", m_args->m_hierarchyStep);
+    args.add("buffer_size", "Megabytes of point data to hold in memory "
+        "before spilling to temporary files", m_args->m_bufferSize,
+        (uint64_t)1024);
+    args.add("temp_dir", "Directory for temporary files",
+        m_args->m_tempDir);
+    args.add("threads", "Number of worker threads", m_args->m_threads);
+}
+
+
+void EptWriter::initialize()
+{
+    const std::string dt(Utils::tolower(m_args->m_dataType));
+    if (dt == "laszip")
+    {
+#if !defined(PDAL_HAVE_LASZIP) && !defined(PDAL_HAVE_LAZPERF)
+        throwError("Can't write 'laszip' data.  PDAL not built with "
+            "LASzip or LAZperf.");
+#endif
+        m_dataType = DataType::Laszip;
+    }
+    else if (dt == "binary")
+        m_dataType = DataType::Binary;
+    else if (dt == "zstandard")
+    {
+#ifndef PDAL_HAVE_ZSTD
+        throwError("Can't write 'zstandard' data.  PDAL must be configured "
+            "with WITH_ZSTD=On.");
+#endif
+        m_dataType = DataType::Zstandard;
+    }
+    else
+        throwError("Invalid 'data_type' '" + m_args->m_dataType + "'.");
+
+    if (m_args->m_span < 2)
+        throwError("Option 'span' must be at least 2.");
+    if (m_args->m_scale <= 0)
+        throwError("Option 'scale' must be positive.");
+
+    m_arbiter.reset(new arbiter::Arbiter());
+    m_ep.reset(new arbiter::Endpoint(m_arbiter->getEndpoint(
+        arbiter::expandTilde(m_args->m_filename))));
+
+    std::string temp(m_args->m_tempDir);
+    if (temp.empty())
+        temp = m_ep->isLocal() ? m_ep->root() : arbiter::getTempPath();
+    m_tempDir = temp + "/ept-build-" +
+        std::to_string(std::hash<std::string>()(m_ep->prefixedRoot()));
+
+    const std::size_t threads(std::max<std::size_t>(m_args->m_threads, 4));
+    if (threads > 100)
+    {
+        log()->get(LogLevel::Warning) << "Using a large thread count: " <<
+            threads << " threads" << std::endl;
+    }
+    // Tasks add more tasks, so the queue mustn't block.
+    m_pool.reset(new Pool(threads,
+        (std::numeric_limits<std::size_t>::max)(), false));
+}
+
+
+void EptWriter::ready(PointTableRef table)
+{
+    using D = Dimension::Id;
+
+    m_layout = table.layout();
+    m_dims = m_layout->dimTypes();
+    m_pointSize = 0;
+    for (DimType& dt : m_dims)
+    {
+        if (dt.m_id == D::X || dt.m_id == D::Y || dt.m_id == D::Z)
+        {
+            dt.m_type = Dimension::Type::Double;
+            m_xyzOffsets[Utils::toNative(dt.m_id) -
+                Utils::toNative(D::X)] = m_pointSize;
+        }
+        m_pointSize += Dimension::size(dt.m_type);
+    }
+    m_packed.resize(m_pointSize);
+
+    auto has = [this](D id) { return m_layout->hasDim(id); };
+    if (has(D::ScanChannel) || has(D::ClassFlags) || has(D::Infrared))
+        m_lasFormat = has(D::Infrared) ? 8 : (has(D::Red) ? 7 : 6);
+    else
+        m_lasFormat = (has(D::GpsTime) ? 1 : 0) + (has(D::Red) ? 2 : 0);
+
+    if (!FileUtils::createDirectories(m_tempDir) &&
+            !FileUtils::directoryExists(m_tempDir))
+        throwError("Unable to create temporary directory '" +
+            m_tempDir + "'.");
+
+    m_bufferLimit = (std::max)(m_args->m_bufferSize * 1024 * 1024 /
+        m_pointSize, (uint64_t)1);
+    m_bounds.clear();
+    m_hierarchy.clear();
+    m_points = makeBuffer(Key());
+}
+
+
+EptWriter::PointBufferPtr EptWriter::makeBuffer(const Key& key)
+{
+    return PointBufferPtr(new PointBuffer(
+        m_tempDir + "/" + key.toString() + ".bin", m_pointSize,
+        m_buffered, m_bufferLimit));
+}
+
+
+bool EptWriter::processOne(PointRef& point)
+{
+    using D = Dimension::Id;
+
+    point.getPackedData(m_dims, m_packed.data());
+    m_points->append(m_packed.data());
+    m_bounds.grow(point.getFieldAs<double>(D::X),
+        point.getFieldAs<double>(D::Y), point.getFieldAs<double>(D::Z));
+    return true;
+}
+
+
+void EptWriter::write(const PointViewPtr view)
+{
+    PointRef point(*view);
+    for (PointId idx = 0; idx < view->size(); ++idx)
+    {
+        point.setPointId(idx);
+        processOne(point);
+    }
+}
+
+
+void EptWriter::done(PointTableRef table)
+{
+    const point_count_t numPoints(m_points->count());
+    if (!numPoints)
+        throwError("No points to write.");
+
+    // The octree's bounds are a cube around the offset, which is the
+    // center of the data rounded to a whole number.
+    double half(0);
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        const double lo = i == 0 ? m_bounds.minx :
+            (i == 1 ? m_bounds.miny : m_bounds.minz);
+        const double hi = i == 0 ? m_bounds.maxx :
+            (i == 1 ? m_bounds.maxy : m_bounds.maxz);
+        m_offsets[i] = std::round(lo + (hi - lo) / 2);
+        half = (std::max)(half,
+            (std::max)(hi - m_offsets[i], m_offsets[i] - lo));
+    }
+    half = std::ceil(half) + 1;
+    if (half / m_args->m_scale > (std::numeric_limits<int32_t>::max)())
+        throwError("Option 'scale' is too small for the extent of the "
+            "data.  Positions must fit in 32-bit integers.");
+
+    Key root;
+    root.b = BOX3D(m_offsets[0] - half, m_offsets[1] - half,
+        m_offsets[2] - half, m_offsets[0] + half, m_offsets[1] + half,
+        m_offsets[2] + half);
+
+    if (m_ep->isLocal())
+    {
+        arbiter::mkdirp(m_ep->fullPath("ept-data"));
+        arbiter::mkdirp(m_ep->fullPath("ept-hierarchy"));
+    }
+
+    log()->get(LogLevel::Debug) << "Building octree for " << numPoints <<
+        " points in " << root.b << std::endl;
+
+    // Distribute the points through the tree.
+    PointBufferPtr points(std::move(m_points));
+    points->close();
+    m_pool->add([this, root, points]() { build(root, points); });
+    m_pool->await();
+    points.reset();
+
+    // Write the hierarchy once all nodes are known.
+    NL::json h;
+    const arbiter::Endpoint hierEp(m_ep->getSubEndpoint("ept-hierarchy"));
+    writeHierarchy(h, root, hierEp);
+    hierEp.put(root.toString() + ".json", h.dump());
+
+    m_pool->join();
+    const std::vector<std::string> errors(m_pool->errors());
+    m_pool->go();
+    FileUtils::deleteDirectory(m_tempDir);
+    if (errors.size())
+        throwError(errors.front());
+
+    log()->get(LogLevel::Debug) << "Wrote " << m_hierarchy.size() <<
+        " nodes" << std::endl;
+
+    // Write ept.json last so that a partial dataset isn't mistaken for a
+    // complete one.
+    NL::json info;
+    info["bounds"] = { root.b.minx, root.b.miny, root.b.minz,
+        root.b.maxx, root.b.maxy, root.b.maxz };
+    info["boundsConforming"] = { m_bounds.minx, m_bounds.miny,
+        m_bounds.minz, m_bounds.maxx, m_bounds.maxy, m_bounds.maxz };
+    info["dataType"] = m_dataType == DataType::Laszip ? "laszip" :
+        (m_dataType == DataType::Binary ? "binary" : "zstandard");
+    info["hierarchyType"] = "json";
+    info["points"] = numPoints;
+    info["schema"] = schema();
+    info["span"] = m_args->m_span;
+    info["version"] = "1.0.0";
+
+    SpatialReference srs(getSpatialReference());
+    if (srs.empty())
+        srs = table.anySpatialReference();
+    info["srs"] = NL::json::object();
+    if (!srs.empty())
+        info["srs"]["wkt"] = srs.getWKT();
+
+    m_ep->put("ept.json", info.dump(2));
+    getMetadata().addList("filename", m_args->m_filename);
+}
+
+
+void EptWriter::build(const Key& key, PointBufferPtr points)
+{
+    std::vector<char> node;
+
+    if (points->count() <= m_args->m_maxNodeSize || key.d >= MaxDepth)
+    {
+        node.reserve(points->count() * m_pointSize);
+        points->consume([&node, this](const char *pos)
+        {
+            node.insert(node.end(), pos, pos + m_pointSize);
+        });
+        writeNode(key, node);
+        return;
+    }
+
+    // Keep the first point to land in each cell of the node's grid and
+    // pass the rest to the child whose octant they fall in.
+    const uint64_t span(m_args->m_span);
+    const BOX3D& b(key.b);
+    const double mid[3] { b.minx + (b.maxx - b.minx) / 2,
+        b.miny + (b.maxy - b.miny) / 2, b.minz + (b.maxz - b.minz) / 2 };
+    const double min[3] { b.minx, b.miny, b.minz };
+    const double cells[3] { span / (b.maxx - b.minx),
+        span / (b.maxy - b.miny), span / (b.maxz - b.minz) };
+
+    std::vector<bool> occupied(span * span * span);
+    std::array<PointBufferPtr, 8> children;
+
+    points->consume([&](const char *pos)
+    {
+        double v[3];
+        uint64_t cell(0);
+        for (int i = 2; i >= 0; --i)
+        {
+            std::memcpy(&v[i], pos + m_xyzOffsets[i], sizeof(double));
+            double c = std::floor((v[i] - min[i]) * cells[i]);
+            c = (std::min)((std::max)(c, 0.0), double(span - 1));
+            cell = cell * span + static_cast<uint64_t>(c);
+        }
+
+        if (!occupied[cell])
+        {
+            occupied[cell] = true;
+            node.insert(node.end(), pos, pos + m_pointSize);
+            return;
+        }
+
+        const int dir = (v[0] >= mid[0] ? 1 : 0) |
+            (v[1] >= mid[1] ? 2 : 0) | (v[2] >= mid[2] ? 4 : 0);
+        PointBufferPtr& child(children[dir]);
+        if (!child)
+            child = makeBuffer(key.bisect(dir));
+        child->append(pos);
+    });
+
+    writeNode(key, node);
+    std::vector<char>().swap(node);
+    std::vector<bool>().swap(occupied);
+
+    for (uint64_t dir = 0; dir < 8; ++dir)
+    {
+        PointBufferPtr child(children[dir]);
+        if (!child)
+            continue;
+        child->close();
+        const Key childKey(key.bisect(dir));
+        m_pool->add([this, childKey, child]() { build(childKey, child); });
+    }
+}
+
+
+void EptWriter::writeNode(const Key& key, const std::vector<char>& points)
+{
+    const std::string name(key.toString());
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hierarchy[key] = points.size() / m_pointSize;
+    }
+
+    if (m_dataType == DataType::Laszip)
+        writeLaszip(name, points);
+    else if (m_dataType == DataType::Binary)
+        m_ep->put("ept-data/" + name + ".bin", toBinary(points));
+#ifdef PDAL_HAVE_ZSTD
+    else
+    {
+        const std::vector<char> data(toBinary(points));
+        std::vector<char> compressed;
+        ZstdCompressor comp([&compressed](char *pos, std::size_t size)
+        {
+            compressed.insert(compressed.end(), pos, pos + size);
+        });
+        comp.compress(data.data(), data.size());
+        comp.done();
+        m_ep->put("ept-data/" + name + ".zst", compressed);
+    }
+#endif
+}
+
+
+// Convert buffered points to the layout of the schema, with XYZ scaled to
+// integers.
+std::vector<char> EptWriter::toBinary(const std::vector<char>& points) const
+{
+    using D = Dimension::Id;
+
+    const point_count_t count(points.size() / m_pointSize);
+    // Each of XYZ shrinks from a double to an int32.
+    std::vector<char> out(count * (m_pointSize - 12));
+
+    const char *src = points.data();
+    char *dst = out.data();
+    for (point_count_t i = 0; i < count; ++i)
+    {
+        for (const DimType& dt : m_dims)
+        {
+            const std::size_t size(Dimension::size(dt.m_type));
+            if (dt.m_id == D::X || dt.m_id == D::Y || dt.m_id == D::Z)
+            {
+                const std::size_t axis(Utils::toNative(dt.m_id) -
+                    Utils::toNative(D::X));
+                double d;
+                std::memcpy(&d, src, sizeof(d));
+                const int32_t v = static_cast<int32_t>(std::llround(
+                    (d - m_offsets[axis]) / m_args->m_scale));
+                std::memcpy(dst, &v, sizeof(v));
+                dst += sizeof(v);
+            }
+            else
+            {
+                std::memcpy(dst, src, size);
+                dst += size;
+            }
+            src += size;
+        }
+    }
+    return out;
+}
+
+
+void EptWriter::writeLaszip(const std::string& name,
+    const std::vector<char>& points) const
+{
+    PointTable table;
+    std::vector<Dimension::Id> ids;
+    for (const DimType& dt : m_dims)
+        ids.push_back(table.layout()->registerOrAssignDim(
+            m_layout->dimName(dt.m_id), dt.m_type));
+
+    PointViewPtr view(new PointView(table));
+    const char *pos = points.data();
+    const point_count_t count(points.size() / m_pointSize);
+    for (PointId idx = 0; idx < count; ++idx)
+        for (std::size_t i = 0; i < m_dims.size(); ++i)
+        {
+            view->setField(ids[i], m_dims[i].m_type, idx, pos);
+            pos += Dimension::size(m_dims[i].m_type);
+        }
+
+    // LAS files can only be written locally.
+    const std::string subpath("ept-data/" + name + ".laz");
+    const std::string filename(m_ep->isLocal() ?
+        m_ep->fullPath(subpath) : m_tempDir + "/" + name + ".laz");
+
+    Options options;
+    options.add("filename", filename);
+    options.add("minor_version", m_lasFormat > 5 ? 4 : 2);
+    options.add("dataformat_id", m_lasFormat);
+    options.add("extra_dims", "all");
+    options.add("scale_x", m_args->m_scale);
+    options.add("scale_y", m_args->m_scale);
+    options.add("scale_z", m_args->m_scale);
+    options.add("offset_x", m_offsets[0]);
+    options.add("offset_y", m_offsets[1]);
+    options.add("offset_z", m_offsets[2]);
+
+    BufferReader reader;
+    reader.addView(view);
+    LasWriter writer;
+    writer.setInput(reader);
+    writer.setOptions(options);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    writer.prepare(table);  // SRS handling is not thread-safe.
+    lock.unlock();
+    writer.execute(table);
+
+    if (!m_ep->isLocal())
+    {
+        m_ep->put(subpath, m_arbiter->getBinary(filename));
+        FileUtils::deleteFile(filename);
+    }
+}
+
+
+void EptWriter::writeHierarchy(NL::json& curr, const Key& key,
+    const arbiter::Endpoint& hierEp) const
+{
+    auto it = m_hierarchy.find(key);
+    if (it == m_hierarchy.end())
+        return;
+
+    const std::string keyName(key.toString());
+    const uint64_t step(m_args->m_hierarchyStep);
+    if (step && key.d && (key.d % step == 0))
+    {
+        curr[keyName] = -1;
+
+        // Create a new hierarchy subtree.
+        NL::json next {{ keyName, it->second }};
+
+        for (uint64_t dir(0); dir < 8; ++dir)
+            writeHierarchy(next, key.bisect(dir), hierEp);
+
+        m_pool->add([&hierEp, keyName, next]()
+        {
+            hierEp.put(keyName + ".json", next.dump());
+        });
+    }
+    else
+    {
+        curr[keyName] = it->second;
+        for (uint64_t dir(0); dir < 8; ++dir)
+            writeHierarchy(curr, key.bisect(dir), hierEp);
+    }
+}
+
+
+NL::json EptWriter::schema() const
+{
+    using D = Dimension::Id;
+
+    NL::json schema = NL::json::array();
+    for (std::size_t i = 0; i < m_dims.size(); ++i)
+    {
+        const DimType& dt(m_dims[i]);
+        NL::json dim;
+        dim["name"] = m_layout->dimName(dt.m_id);
+        if (dt.m_id == D::X || dt.m_id == D::Y || dt.m_id == D::Z)
+        {
+            dim["type"] = "signed";
+            dim["size"] = 4;
+            dim["scale"] = m_args->m_scale;
+            dim["offset"] = m_offsets[Utils::toNative(dt.m_id) -
+                Utils::toNative(D::X)];
+        }
+        else
+        {
+            dim["type"] = getTypeString(dt.m_type);
+            dim["size"] = Dimension::size(dt.m_type);
+        }
+        schema.push_back(dim);
+    }
+    return schema;
+}
+
+} // namespace pdal
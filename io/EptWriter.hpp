@@ -0,0 +1,127 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <pdal/JsonFwd.hpp>
+#include <pdal/Streamable.hpp>
+#include <pdal/Writer.hpp>
+#include <pdal/util/Bounds.hpp>
+
+namespace pdal
+{
+
+namespace arbiter
+{
+    class Arbiter;
+    class Endpoint;
+}
+
+class Key;
+class Pool;
+
+// Builds an EPT dataset from the points written to it.  Points are
+// collected, spilling to temporary files once a memory limit is reached,
+// and then distributed top-down through the octree.  Each node keeps one
+// point per cell of a span^3 grid over its bounds and passes the rest to
+// its children, until few enough points remain to make it a leaf.
+// Subtrees are built in parallel.
+class PDAL_DLL EptWriter : public Writer, public Streamable
+{
+public:
+    EptWriter();
+    virtual ~EptWriter();
+
+    std::string getName() const override;
+
+private:
+    struct Args;
+    class PointBuffer;
+    using PointBufferPtr = std::shared_ptr<PointBuffer>;
+
+    enum class DataType
+    {
+        Laszip,
+        Binary,
+        Zstandard
+    };
+
+    virtual void addArgs(ProgramArgs& args) override;
+    virtual void initialize() override;
+    virtual void ready(PointTableRef table) override;
+    virtual bool processOne(PointRef& point) override;
+    virtual void write(const PointViewPtr view) override;
+    virtual void done(PointTableRef table) override;
+
+    PointBufferPtr makeBuffer(const Key& key);
+    void build(const Key& key, PointBufferPtr points);
+    void writeNode(const Key& key, const std::vector<char>& points);
+    std::vector<char> toBinary(const std::vector<char>& points) const;
+    void writeLaszip(const std::string& name,
+        const std::vector<char>& points) const;
+    void writeHierarchy(NL::json& curr, const Key& key,
+        const arbiter::Endpoint& hierEp) const;
+    NL::json schema() const;
+
+    std::unique_ptr<Args> m_args;
+    DataType m_dataType;
+
+    std::unique_ptr<arbiter::Arbiter> m_arbiter;
+    std::unique_ptr<arbiter::Endpoint> m_ep;
+    std::unique_ptr<Pool> m_pool;
+    std::string m_tempDir;
+
+    // Points are buffered packed with these dimensions, XYZ as doubles.
+    PointLayoutPtr m_layout;
+    DimTypeList m_dims;
+    std::size_t m_pointSize;
+    std::array<std::size_t, 3> m_xyzOffsets;
+    int m_lasFormat;
+
+    PointBufferPtr m_points;
+    std::vector<char> m_packed;
+    std::atomic<point_count_t> m_buffered;
+    point_count_t m_bufferLimit;
+    BOX3D m_bounds;
+    std::array<double, 3> m_offsets;
+
+    mutable std::mutex m_mutex;
+    std::map<Key, uint64_t> m_hierarchy;
+};
+
+} // namespace pdal
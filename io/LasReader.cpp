@@ -77,6 +77,30 @@ LasReader::~LasReader()
 }
 
 
+LasReader::Fields::Fields(PointLayoutPtr layout) :
+    m_x(layout, Dimension::Id::X),
+    m_y(layout, Dimension::Id::Y),
+    m_z(layout, Dimension::Id::Z),
+    m_intensity(layout, Dimension::Id::Intensity),
+    m_returnNumber(layout, Dimension::Id::ReturnNumber),
+    m_numberOfReturns(layout, Dimension::Id::NumberOfReturns),
+    m_classFlags(layout, Dimension::Id::ClassFlags),
+    m_scanChannel(layout, Dimension::Id::ScanChannel),
+    m_scanDirectionFlag(layout, Dimension::Id::ScanDirectionFlag),
+    m_edgeOfFlightLine(layout, Dimension::Id::EdgeOfFlightLine),
+    m_classification(layout, Dimension::Id::Classification),
+    m_scanAngleRank(layout, Dimension::Id::ScanAngleRank),
+    m_scanAngle(layout, Dimension::Id::ScanAngleRank),
+    m_userData(layout, Dimension::Id::UserData),
+    m_pointSourceId(layout, Dimension::Id::PointSourceId),
+    m_gpsTime(layout, Dimension::Id::GpsTime),
+    m_red(layout, Dimension::Id::Red),
+    m_green(layout, Dimension::Id::Green),
+    m_blue(layout, Dimension::Id::Blue),
+    m_infrared(layout, Dimension::Id::Infrared)
+{}
+
+
 void LasReader::addArgs(ProgramArgs& args)
 {
     args.add("extra_dims", "Dimensions to assign to extra byte data",
@@ -239,6 +263,7 @@ void LasReader::handleLaszip(int result)
 
 void LasReader::ready(PointTableRef table)
 {
+    m_fields = Fields(table.layout());
     createStream();
     std::istream *stream(m_streamIf->m_istream);
 
@@ -728,29 +753,30 @@ void LasReader::loadPointV10(PointRef& point, laszip_point& p)
     double y = p.Y * h.scaleY() + h.offsetY();
     double z = p.Z * h.scaleZ() + h.offsetZ();
 
-    point.setField(Dimension::Id::X, x);
-    point.setField(Dimension::Id::Y, y);
-    point.setField(Dimension::Id::Z, z);
-    point.setField(Dimension::Id::Intensity, p.intensity);
-    point.setField(Dimension::Id::ReturnNumber, p.return_number);
-    point.setField(Dimension::Id::NumberOfReturns, p.number_of_returns);
-    point.setField(Dimension::Id::ScanDirectionFlag, p.scan_direction_flag);
-    point.setField(Dimension::Id::EdgeOfFlightLine, p.edge_of_flight_line);
+    char *data = point.data();
+    m_fields.m_x.set(point, data, x);
+    m_fields.m_y.set(point, data, y);
+    m_fields.m_z.set(point, data, z);
+    m_fields.m_intensity.set(point, data, p.intensity);
+    m_fields.m_returnNumber.set(point, data, p.return_number);
+    m_fields.m_numberOfReturns.set(point, data, p.number_of_returns);
+    m_fields.m_scanDirectionFlag.set(point, data, p.scan_direction_flag);
+    m_fields.m_edgeOfFlightLine.set(point, data, p.edge_of_flight_line);
     uint8_t classification = p.classification | (p.synthetic_flag << 5) |
         (p.keypoint_flag << 6) | (p.withheld_flag << 7);
-    point.setField(Dimension::Id::Classification, classification);
-    point.setField(Dimension::Id::ScanAngleRank, p.scan_angle_rank);
-    point.setField(Dimension::Id::UserData, p.user_data);
-    point.setField(Dimension::Id::PointSourceId, p.point_source_ID);
+    m_fields.m_classification.set(point, data, classification);
+    m_fields.m_scanAngleRank.set(point, data, p.scan_angle_rank);
+    m_fields.m_userData.set(point, data, p.user_data);
+    m_fields.m_pointSourceId.set(point, data, p.point_source_ID);
 
     if (h.hasTime())
-        point.setField(Dimension::Id::GpsTime, p.gps_time);
+        m_fields.m_gpsTime.set(point, data, p.gps_time);
 
     if (h.hasColor())
     {
-        point.setField(Dimension::Id::Red, p.rgb[0]);
-        point.setField(Dimension::Id::Green, p.rgb[1]);
-        point.setField(Dimension::Id::Blue, p.rgb[2]);
+        m_fields.m_red.set(point, data, p.rgb[0]);
+        m_fields.m_green.set(point, data, p.rgb[1]);
+        m_fields.m_blue.set(point, data, p.rgb[2]);
     }
 
     if (m_extraDims.size())
@@ -789,33 +815,34 @@ void LasReader::loadPointV10(PointRef& point, char *buf, size_t bufsize)
     uint8_t scanDirFlag = (flags >> 6) & 0x01;
     uint8_t flight = (flags >> 7) & 0x01;
 
-    point.setField(Dimension::Id::X, x);
-    point.setField(Dimension::Id::Y, y);
-    point.setField(Dimension::Id::Z, z);
-    point.setField(Dimension::Id::Intensity, intensity);
-    point.setField(Dimension::Id::ReturnNumber, returnNum);
-    point.setField(Dimension::Id::NumberOfReturns, numReturns);
-    point.setField(Dimension::Id::ScanDirectionFlag, scanDirFlag);
-    point.setField(Dimension::Id::EdgeOfFlightLine, flight);
-    point.setField(Dimension::Id::Classification, classification);
-    point.setField(Dimension::Id::ScanAngleRank, scanAngleRank);
-    point.setField(Dimension::Id::UserData, user);
-    point.setField(Dimension::Id::PointSourceId, pointSourceId);
+    char *data = point.data();
+    m_fields.m_x.set(point, data, x);
+    m_fields.m_y.set(point, data, y);
+    m_fields.m_z.set(point, data, z);
+    m_fields.m_intensity.set(point, data, intensity);
+    m_fields.m_returnNumber.set(point, data, returnNum);
+    m_fields.m_numberOfReturns.set(point, data, numReturns);
+    m_fields.m_scanDirectionFlag.set(point, data, scanDirFlag);
+    m_fields.m_edgeOfFlightLine.set(point, data, flight);
+    m_fields.m_classification.set(point, data, classification);
+    m_fields.m_scanAngleRank.set(point, data, scanAngleRank);
+    m_fields.m_userData.set(point, data, user);
+    m_fields.m_pointSourceId.set(point, data, pointSourceId);
 
     if (h.hasTime())
     {
         double time;
         istream >> time;
-        point.setField(Dimension::Id::GpsTime, time);
+        m_fields.m_gpsTime.set(point, data, time);
     }
 
     if (h.hasColor())
     {
         uint16_t red, green, blue;
         istream >> red >> green >> blue;
-        point.setField(Dimension::Id::Red, red);
-        point.setField(Dimension::Id::Green, green);
-        point.setField(Dimension::Id::Blue, blue);
+        m_fields.m_red.set(point, data, red);
+        m_fields.m_green.set(point, data, green);
+        m_fields.m_blue.set(point, data, blue);
     }
 
     if (m_extraDims.size())
@@ -832,33 +859,33 @@ void LasReader::loadPointV14(PointRef& point, laszip_point& p)
     double y = p.Y * h.scaleY() + h.offsetY();
     double z = p.Z * h.scaleZ() + h.offsetZ();
 
-    point.setField(Dimension::Id::X, x);
-    point.setField(Dimension::Id::Y, y);
-    point.setField(Dimension::Id::Z, z);
-    point.setField(Dimension::Id::Intensity, p.intensity);
-    point.setField(Dimension::Id::ReturnNumber, p.extended_return_number);
-    point.setField(Dimension::Id::NumberOfReturns,
-        p.extended_number_of_returns);
-    point.setField(Dimension::Id::ClassFlags, p.extended_classification_flags);
-    point.setField(Dimension::Id::ScanChannel, p.extended_scanner_channel);
-    point.setField(Dimension::Id::ScanDirectionFlag, p.scan_direction_flag);
-    point.setField(Dimension::Id::EdgeOfFlightLine, p.edge_of_flight_line);
-    point.setField(Dimension::Id::Classification, p.extended_classification);
-    point.setField(Dimension::Id::ScanAngleRank, p.extended_scan_angle * .006);
-    point.setField(Dimension::Id::UserData, p.user_data);
-    point.setField(Dimension::Id::PointSourceId, p.point_source_ID);
-    point.setField(Dimension::Id::GpsTime, p.gps_time);
+    char *data = point.data();
+    m_fields.m_x.set(point, data, x);
+    m_fields.m_y.set(point, data, y);
+    m_fields.m_z.set(point, data, z);
+    m_fields.m_intensity.set(point, data, p.intensity);
+    m_fields.m_returnNumber.set(point, data, p.extended_return_number);
+    m_fields.m_numberOfReturns.set(point, data, p.extended_number_of_returns);
+    m_fields.m_classFlags.set(point, data, p.extended_classification_flags);
+    m_fields.m_scanChannel.set(point, data, p.extended_scanner_channel);
+    m_fields.m_scanDirectionFlag.set(point, data, p.scan_direction_flag);
+    m_fields.m_edgeOfFlightLine.set(point, data, p.edge_of_flight_line);
+    m_fields.m_classification.set(point, data, p.extended_classification);
+    m_fields.m_scanAngle.set(point, data, p.extended_scan_angle * .006);
+    m_fields.m_userData.set(point, data, p.user_data);
+    m_fields.m_pointSourceId.set(point, data, p.point_source_ID);
+    m_fields.m_gpsTime.set(point, data, p.gps_time);
 
     if (h.hasColor())
     {
-        point.setField(Dimension::Id::Red, p.rgb[0]);
-        point.setField(Dimension::Id::Green, p.rgb[1]);
-        point.setField(Dimension::Id::Blue, p.rgb[2]);
+        m_fields.m_red.set(point, data, p.rgb[0]);
+        m_fields.m_green.set(point, data, p.rgb[1]);
+        m_fields.m_blue.set(point, data, p.rgb[2]);
     }
 
     if (h.hasInfrared())
     {
-        point.setField(Dimension::Id::Infrared, p.rgb[3]);
+        m_fields.m_infrared.set(point, data, p.rgb[3]);
     }
 
     if (m_extraDims.size())
@@ -902,29 +929,30 @@ void LasReader::loadPointV14(PointRef& point, char *buf, size_t bufsize)
     uint8_t scanDirFlag = (flags >> 6) & 0x01;
     uint8_t flight = (flags >> 7) & 0x01;
 
-    point.setField(Dimension::Id::X, x);
-    point.setField(Dimension::Id::Y, y);
-    point.setField(Dimension::Id::Z, z);
-    point.setField(Dimension::Id::Intensity, intensity);
-    point.setField(Dimension::Id::ReturnNumber, returnNum);
-    point.setField(Dimension::Id::NumberOfReturns, numReturns);
-    point.setField(Dimension::Id::ClassFlags, classFlags);
-    point.setField(Dimension::Id::ScanChannel, scanChannel);
-    point.setField(Dimension::Id::ScanDirectionFlag, scanDirFlag);
-    point.setField(Dimension::Id::EdgeOfFlightLine, flight);
-    point.setField(Dimension::Id::Classification, classification);
-    point.setField(Dimension::Id::ScanAngleRank, scanAngle * .006);
-    point.setField(Dimension::Id::UserData, user);
-    point.setField(Dimension::Id::PointSourceId, pointSourceId);
-    point.setField(Dimension::Id::GpsTime, gpsTime);
+    char *data = point.data();
+    m_fields.m_x.set(point, data, x);
+    m_fields.m_y.set(point, data, y);
+    m_fields.m_z.set(point, data, z);
+    m_fields.m_intensity.set(point, data, intensity);
+    m_fields.m_returnNumber.set(point, data, returnNum);
+    m_fields.m_numberOfReturns.set(point, data, numReturns);
+    m_fields.m_classFlags.set(point, data, classFlags);
+    m_fields.m_scanChannel.set(point, data, scanChannel);
+    m_fields.m_scanDirectionFlag.set(point, data, scanDirFlag);
+    m_fields.m_edgeOfFlightLine.set(point, data, flight);
+    m_fields.m_classification.set(point, data, classification);
+    m_fields.m_scanAngle.set(point, data, scanAngle * .006);
+    m_fields.m_userData.set(point, data, user);
+    m_fields.m_pointSourceId.set(point, data, pointSourceId);
+    m_fields.m_gpsTime.set(point, data, gpsTime);
 
     if (h.hasColor())
     {
         uint16_t red, green, blue;
         istream >> red >> green >> blue;
-        point.setField(Dimension::Id::Red, red);
-        point.setField(Dimension::Id::Green, green);
-        point.setField(Dimension::Id::Blue, blue);
+        m_fields.m_red.set(point, data, red);
+        m_fields.m_green.set(point, data, green);
+        m_fields.m_blue.set(point, data, blue);
     }
 
     if (h.hasInfrared())
@@ -932,7 +960,7 @@ void LasReader::loadPointV14(PointRef& point, char *buf, size_t bufsize)
         uint16_t nearInfraRed;
 
         istream >> nearInfraRed;
-        point.setField(Dimension::Id::Infrared, nearInfraRed);
+        m_fields.m_infrared.set(point, data, nearInfraRed);
     }
 
     if (m_extraDims.size())
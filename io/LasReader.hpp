@@ -36,6 +36,7 @@
 
 #include <pdal/pdal_export.hpp>
 #include <pdal/pdal_features.hpp>
+#include <pdal/FieldAccessor.hpp>
 #include <pdal/PDALUtils.hpp>
 #include <pdal/Reader.hpp>
 #include <pdal/Streamable.hpp>
@@ -115,6 +116,36 @@ protected:
 private:
     typedef std::vector<LasUtils::IgnoreVLR> IgnoreVLRList;
 
+    // Accessors for the standard dimensions, typed as the values are
+    // read from the file.
+    struct Fields
+    {
+        Fields()
+        {}
+        Fields(PointLayoutPtr layout);
+
+        FieldAccessor<double> m_x;
+        FieldAccessor<double> m_y;
+        FieldAccessor<double> m_z;
+        FieldAccessor<uint16_t> m_intensity;
+        FieldAccessor<uint8_t> m_returnNumber;
+        FieldAccessor<uint8_t> m_numberOfReturns;
+        FieldAccessor<uint8_t> m_classFlags;
+        FieldAccessor<uint8_t> m_scanChannel;
+        FieldAccessor<uint8_t> m_scanDirectionFlag;
+        FieldAccessor<uint8_t> m_edgeOfFlightLine;
+        FieldAccessor<uint8_t> m_classification;
+        FieldAccessor<int8_t> m_scanAngleRank;
+        FieldAccessor<double> m_scanAngle;
+        FieldAccessor<uint8_t> m_userData;
+        FieldAccessor<uint16_t> m_pointSourceId;
+        FieldAccessor<double> m_gpsTime;
+        FieldAccessor<uint16_t> m_red;
+        FieldAccessor<uint16_t> m_green;
+        FieldAccessor<uint16_t> m_blue;
+        FieldAccessor<uint16_t> m_infrared;
+    };
+
     LasHeader m_header;
     laszip_POINTER m_laszip;
     laszip_point_struct *m_laszipPoint;
@@ -128,6 +159,7 @@ private:
     std::string m_compression;
     StringList m_ignoreVLROption;
     bool m_useEbVlr;
+    Fields m_fields;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void initialize(PointTableRef table)
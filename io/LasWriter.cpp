@@ -289,6 +289,7 @@ void LasWriter::fillForwardList()
 void LasWriter::readyTable(PointTableRef table)
 {
     m_firstPoint = true;
+    m_fields = Fields(table.layout());
     m_forwardMetadata = table.privateMetadata("lasforward");
     if(m_writePDALMetadata)
     {
@@ -302,6 +303,30 @@ void LasWriter::readyTable(PointTableRef table)
 }
 
 
+LasWriter::Fields::Fields(PointLayoutPtr layout) :
+    m_x(layout, Dimension::Id::X),
+    m_y(layout, Dimension::Id::Y),
+    m_z(layout, Dimension::Id::Z),
+    m_intensity(layout, Dimension::Id::Intensity),
+    m_returnNumber(layout, Dimension::Id::ReturnNumber),
+    m_numberOfReturns(layout, Dimension::Id::NumberOfReturns),
+    m_classFlags(layout, Dimension::Id::ClassFlags),
+    m_scanChannel(layout, Dimension::Id::ScanChannel),
+    m_scanDirectionFlag(layout, Dimension::Id::ScanDirectionFlag),
+    m_edgeOfFlightLine(layout, Dimension::Id::EdgeOfFlightLine),
+    m_classification(layout, Dimension::Id::Classification),
+    m_scanAngleRank(layout, Dimension::Id::ScanAngleRank),
+    m_scanAngle(layout, Dimension::Id::ScanAngleRank),
+    m_userData(layout, Dimension::Id::UserData),
+    m_pointSourceId(layout, Dimension::Id::PointSourceId),
+    m_gpsTime(layout, Dimension::Id::GpsTime),
+    m_red(layout, Dimension::Id::Red),
+    m_green(layout, Dimension::Id::Green),
+    m_blue(layout, Dimension::Id::Blue),
+    m_infrared(layout, Dimension::Id::Infrared)
+{}
+
+
 void LasWriter::readyFile(const std::string& filename,
     const SpatialReference& srs)
 {
@@ -867,13 +892,14 @@ bool LasWriter::writeLasZipBuf(PointRef& point)
     // we always write the base fields
     using namespace Dimension;
 
+    const char *data = point.constData();
     uint8_t returnNumber(1);
     uint8_t numberOfReturns(1);
 
     if (point.hasDim(Id::ReturnNumber))
-        returnNumber = point.getFieldAs<uint8_t>(Id::ReturnNumber);
+        returnNumber = m_fields.m_returnNumber.get(point, data);
     if (point.hasDim(Id::NumberOfReturns))
-        numberOfReturns = point.getFieldAs<uint8_t>(Id::NumberOfReturns);
+        numberOfReturns = m_fields.m_numberOfReturns.get(point, data);
     if (numberOfReturns > maxReturnCount)
     {
         if (m_discardHighReturnNumbers)
@@ -897,22 +923,22 @@ bool LasWriter::writeLasZipBuf(PointRef& point)
         return i;
     };
 
-    double xOrig = point.getFieldAs<double>(Id::X);
-    double yOrig = point.getFieldAs<double>(Id::Y);
-    double zOrig = point.getFieldAs<double>(Id::Z);
+    double xOrig = m_fields.m_x.get(point, data);
+    double yOrig = m_fields.m_y.get(point, data);
+    double zOrig = m_fields.m_z.get(point, data);
     double x = m_scaling.m_xXform.toScaled(xOrig);
     double y = m_scaling.m_yXform.toScaled(yOrig);
     double z = m_scaling.m_zXform.toScaled(zOrig);
 
-    uint8_t scanChannel = point.getFieldAs<uint8_t>(Id::ScanChannel);
+    uint8_t scanChannel = m_fields.m_scanChannel.get(point, data);
     uint8_t scanDirectionFlag =
-        point.getFieldAs<uint8_t>(Id::ScanDirectionFlag);
+        m_fields.m_scanDirectionFlag.get(point, data);
     uint8_t edgeOfFlightLine =
-        point.getFieldAs<uint8_t>(Id::EdgeOfFlightLine);
-    uint8_t classification = point.getFieldAs<uint8_t>(Id::Classification);
+        m_fields.m_edgeOfFlightLine.get(point, data);
+    uint8_t classification = m_fields.m_classification.get(point, data);
     uint8_t classFlags = 0;
     if (point.hasDim(Id::ClassFlags))
-        classFlags = point.getFieldAs<uint8_t>(Id::ClassFlags);
+        classFlags = m_fields.m_classFlags.get(point, data);
     else
         classFlags = classification >> 5;
 
@@ -920,25 +946,25 @@ bool LasWriter::writeLasZipBuf(PointRef& point)
     p.X = converter(x, Id::X);
     p.Y = converter(y, Id::Y);
     p.Z = converter(z, Id::Z);
-    p.intensity = point.getFieldAs<uint16_t>(Id::Intensity);
+    p.intensity = m_fields.m_intensity.get(point, data);
     p.scan_direction_flag = scanDirectionFlag;
     p.edge_of_flight_line = edgeOfFlightLine;
     p.synthetic_flag = classFlags & 0x1;
     p.keypoint_flag = (classFlags >> 1) & 0x1;
     p.withheld_flag = (classFlags >> 2) & 0x1;
-    p.user_data = point.getFieldAs<uint8_t>(Id::UserData);
-    p.point_source_ID = point.getFieldAs<uint16_t>(Id::PointSourceId);
+    p.user_data = m_fields.m_userData.get(point, data);
+    p.point_source_ID = m_fields.m_pointSourceId.get(point, data);
 
     if (has14Format)
     {
         p.classification = (classification & 0x1F) | (classFlags << 5);
-        p.scan_angle_rank = point.getFieldAs<int8_t>(Id::ScanAngleRank);
+        p.scan_angle_rank = m_fields.m_scanAngleRank.get(point, data);
         p.number_of_returns = (std::min)((uint8_t)7, numberOfReturns);
         p.return_number = (std::min)((uint8_t)7, returnNumber);
 
         // This should always work if ScanAngleRank isn't wonky.
         p.extended_scan_angle = static_cast<laszip_I16>(
-            std::round(point.getFieldAs<float>(Id::ScanAngleRank) / .006f));
+            std::round(m_fields.m_scanAngle.get(point, data) / .006f));
         p.extended_point_type = 1;
         p.extended_scanner_channel = scanChannel;
         p.extended_classification_flags = classFlags;
@@ -950,23 +976,23 @@ bool LasWriter::writeLasZipBuf(PointRef& point)
     {
         p.return_number = returnNumber;
         p.number_of_returns = numberOfReturns;
-        p.scan_angle_rank = point.getFieldAs<int8_t>(Id::ScanAngleRank);
+        p.scan_angle_rank = m_fields.m_scanAngleRank.get(point, data);
         p.classification = classification;
         p.extended_point_type = 0;
     }
 
     if (m_lasHeader.hasTime())
-        p.gps_time = point.getFieldAs<double>(Id::GpsTime);
+        p.gps_time = m_fields.m_gpsTime.get(point, data);
 
     if (m_lasHeader.hasColor())
     {
-        p.rgb[0] = point.getFieldAs<uint16_t>(Id::Red);
-        p.rgb[1] = point.getFieldAs<uint16_t>(Id::Green);
-        p.rgb[2] = point.getFieldAs<uint16_t>(Id::Blue);
+        p.rgb[0] = m_fields.m_red.get(point, data);
+        p.rgb[1] = m_fields.m_green.get(point, data);
+        p.rgb[2] = m_fields.m_blue.get(point, data);
     }
 
     if (m_lasHeader.hasInfrared())
-        p.rgb[3] = point.getFieldAs<uint16_t>(Id::Infrared);
+        p.rgb[3] = m_fields.m_infrared.get(point, data);
 
     if (m_extraDims.size())
     {
@@ -1013,12 +1039,13 @@ bool LasWriter::fillPointBuf(PointRef& point, LeInserter& ostream)
     // we always write the base fields
     using namespace Dimension;
 
+    const char *data = point.constData();
     uint8_t returnNumber(1);
     uint8_t numberOfReturns(1);
     if (point.hasDim(Id::ReturnNumber))
-        returnNumber = point.getFieldAs<uint8_t>(Id::ReturnNumber);
+        returnNumber = m_fields.m_returnNumber.get(point, data);
     if (point.hasDim(Id::NumberOfReturns))
-        numberOfReturns = point.getFieldAs<uint8_t>(Id::NumberOfReturns);
+        numberOfReturns = m_fields.m_numberOfReturns.get(point, data);
     if (numberOfReturns > maxReturnCount)
     {
         if (m_discardHighReturnNumbers)
@@ -1042,9 +1069,9 @@ bool LasWriter::fillPointBuf(PointRef& point, LeInserter& ostream)
         return i;
     };
 
-    double xOrig = point.getFieldAs<double>(Id::X);
-    double yOrig = point.getFieldAs<double>(Id::Y);
-    double zOrig = point.getFieldAs<double>(Id::Z);
+    double xOrig = m_fields.m_x.get(point, data);
+    double yOrig = m_fields.m_y.get(point, data);
+    double zOrig = m_fields.m_z.get(point, data);
     double x = m_scaling.m_xXform.toScaled(xOrig);
     double y = m_scaling.m_yXform.toScaled(yOrig);
     double z = m_scaling.m_zXform.toScaled(zOrig);
@@ -1053,20 +1080,20 @@ bool LasWriter::fillPointBuf(PointRef& point, LeInserter& ostream)
     ostream << converter(y, Id::Y);
     ostream << converter(z, Id::Z);
 
-    ostream << point.getFieldAs<uint16_t>(Id::Intensity);
+    ostream << m_fields.m_intensity.get(point, data);
 
-    uint8_t scanChannel = point.getFieldAs<uint8_t>(Id::ScanChannel);
+    uint8_t scanChannel = m_fields.m_scanChannel.get(point, data);
     uint8_t scanDirectionFlag =
-        point.getFieldAs<uint8_t>(Id::ScanDirectionFlag);
+        m_fields.m_scanDirectionFlag.get(point, data);
     uint8_t edgeOfFlightLine =
-        point.getFieldAs<uint8_t>(Id::EdgeOfFlightLine);
+        m_fields.m_edgeOfFlightLine.get(point, data);
 
     if (has14Format)
     {
         uint8_t bits = returnNumber | (numberOfReturns << 4);
         ostream << bits;
 
-        uint8_t classFlags = point.getFieldAs<uint8_t>(Id::ClassFlags);
+        uint8_t classFlags = m_fields.m_classFlags.get(point, data);
         bits = (classFlags & 0x0F) |
             ((scanChannel & 0x03) << 4) |
             ((scanDirectionFlag & 0x01) << 6) |
@@ -1080,37 +1107,37 @@ bool LasWriter::fillPointBuf(PointRef& point, LeInserter& ostream)
         ostream << bits;
     }
 
-    ostream << point.getFieldAs<uint8_t>(Id::Classification);
+    ostream << m_fields.m_classification.get(point, data);
 
-    uint8_t userData = point.getFieldAs<uint8_t>(Id::UserData);
+    uint8_t userData = m_fields.m_userData.get(point, data);
     if (has14Format)
     {
          // Guaranteed to fit if scan angle rank isn't wonky.
         int16_t scanAngleRank =
             static_cast<int16_t>(std::round(
-                point.getFieldAs<float>(Id::ScanAngleRank) / .006f));
+                m_fields.m_scanAngle.get(point, data) / .006f));
         ostream << userData << scanAngleRank;
     }
     else
     {
-        int8_t scanAngleRank = point.getFieldAs<int8_t>(Id::ScanAngleRank);
+        int8_t scanAngleRank = m_fields.m_scanAngleRank.get(point, data);
         ostream << scanAngleRank << userData;
     }
 
-    ostream << point.getFieldAs<uint16_t>(Id::PointSourceId);
+    ostream << m_fields.m_pointSourceId.get(point, data);
 
     if (m_lasHeader.hasTime())
-        ostream << point.getFieldAs<double>(Id::GpsTime);
+        ostream << m_fields.m_gpsTime.get(point, data);
 
     if (m_lasHeader.hasColor())
     {
-        ostream << point.getFieldAs<uint16_t>(Id::Red);
-        ostream << point.getFieldAs<uint16_t>(Id::Green);
-        ostream << point.getFieldAs<uint16_t>(Id::Blue);
+        ostream << m_fields.m_red.get(point, data);
+        ostream << m_fields.m_green.get(point, data);
+        ostream << m_fields.m_blue.get(point, data);
     }
 
     if (m_lasHeader.hasInfrared())
-        ostream << point.getFieldAs<uint16_t>(Id::Infrared);
+        ostream << m_fields.m_infrared.get(point, data);
 
     Everything e;
     for (auto& dim : m_extraDims)
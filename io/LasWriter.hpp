@@ -35,6 +35,7 @@
 #pragma once
 
 #include <pdal/pdal_features.hpp>
+#include <pdal/FieldAccessor.hpp>
 #include <pdal/FlexWriter.hpp>
 #include <pdal/Streamable.hpp>
 
@@ -82,6 +83,36 @@ protected:
     void finishOutput();
 
 private:
+    // Accessors for the standard dimensions, typed as the values are
+    // written to the file.
+    struct Fields
+    {
+        Fields()
+        {}
+        Fields(PointLayoutPtr layout);
+
+        FieldAccessor<double> m_x;
+        FieldAccessor<double> m_y;
+        FieldAccessor<double> m_z;
+        FieldAccessor<uint16_t> m_intensity;
+        FieldAccessor<uint8_t> m_returnNumber;
+        FieldAccessor<uint8_t> m_numberOfReturns;
+        FieldAccessor<uint8_t> m_classFlags;
+        FieldAccessor<uint8_t> m_scanChannel;
+        FieldAccessor<uint8_t> m_scanDirectionFlag;
+        FieldAccessor<uint8_t> m_edgeOfFlightLine;
+        FieldAccessor<uint8_t> m_classification;
+        FieldAccessor<int8_t> m_scanAngleRank;
+        FieldAccessor<float> m_scanAngle;
+        FieldAccessor<uint8_t> m_userData;
+        FieldAccessor<uint16_t> m_pointSourceId;
+        FieldAccessor<double> m_gpsTime;
+        FieldAccessor<uint16_t> m_red;
+        FieldAccessor<uint16_t> m_green;
+        FieldAccessor<uint16_t> m_blue;
+        FieldAccessor<uint16_t> m_infrared;
+    };
+
     LasHeader m_lasHeader;
     std::unique_ptr<LasSummaryData> m_summaryData;
     laszip_POINTER m_laszip;
@@ -129,6 +160,7 @@ private:
     bool m_writePDALMetadata;
     std::vector<ExtLasVLR> m_userVLRs;
     bool m_firstPoint;
+    Fields m_fields;
 
     virtual void addArgs(ProgramArgs& args);
     virtual void initialize();
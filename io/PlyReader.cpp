@@ -33,12 +33,17 @@
 ****************************************************************************/
 
 #include "PlyReader.hpp"
+#include "private/TextParser.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
 #include <pdal/PDALUtils.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/util/IStream.hpp>
+#include <pdal/util/portable_endian.hpp>
+#include <pdal/util/ProgramArgs.hpp>
 
 namespace pdal
 {
@@ -58,6 +63,17 @@ PlyReader::PlyReader() : m_vertexElt(nullptr)
 {}
 
 
+PlyReader::~PlyReader()
+{}
+
+
+void PlyReader::addArgs(ProgramArgs& args)
+{
+    args.add("threads", "Number of threads used to parse ASCII vertex data "
+        "in standard mode", m_threads, 1);
+}
+
+
 std::string PlyReader::readLine()
 {
     m_line.clear();
@@ -281,6 +297,8 @@ void PlyReader::extractHeader()
             m_vertexElt = &elt;
     if (!m_vertexElt)
         throwError("Can't read PLY file without a 'vertex' element.");
+    if (m_vertexElt->m_properties.empty())
+        throwError("The 'vertex' element has no properties.");
 }
 
 
@@ -415,31 +433,229 @@ void PlyReader::ready(PointTableRef table)
     m_stream = Utils::openFile(m_filename, true);
     if (m_stream)
         m_stream->seekg(m_dataPos);
-    for (Element& elt : m_elements)
+    if (m_format == Format::Ascii)
     {
-        if (&elt == m_vertexElt)
-            break;
+        // Each element is on its own line in ASCII files, so we just skip
+        // lines to get to the vertex element.
+        m_lineReader.reset(new text::LineReader(*m_stream));
+        m_tokenizer.reset(new text::Tokenizer(' '));
+        for (Element& elt : m_elements)
+        {
+            if (&elt == m_vertexElt)
+                break;
+            for (PointId idx = 0; idx < elt.m_count; ++idx)
+                if (!nextLine())
+                    throwError("Error reading data for element '" +
+                        elt.m_name + "'.");
+        }
+    }
+    else
+    {
+        for (Element& elt : m_elements)
+        {
+            if (&elt == m_vertexElt)
+                break;
+
+            // We read an element into point 0.  Since the element's
+            // properties weren't registered as dimensions, we'll try to
+            // write the data to a NULL dimension, which is a noop.
+            // This essentially just gets us to the vertex element.
+            PointRef point(table, 0);
+            for (PointId idx = 0; idx < elt.m_count; ++idx)
+                readElement(elt, point);
+        }
 
-        // We read an element into point 0.  Since the element's properties
-        // weren't registered as dimensions, we'll try to write the data
-        // to a NULL dimension, which is a noop.
-        // This essentially just gets us to the vertex element.
-        // In binary mode, this is all silliness, since we should be able
-        // to seek right where we want to go, but in text mode, you've got
-        // to go through the data.
-        PointRef point(table, 0);
-        for (PointId idx = 0; idx < elt.m_count; ++idx)
-            readElement(elt, point);
+        // Vertex elements only have simple properties, so every record is
+        // the same size and each property is at a fixed offset.
+        m_vertexFields.clear();
+        m_recordSize = 0;
+        for (auto& prop : m_vertexElt->m_properties)
+        {
+            auto vprop = static_cast<SimpleProperty *>(prop.get());
+            size_t size = Dimension::size(vprop->m_type);
+            m_vertexFields.push_back(
+                { vprop->m_dim, vprop->m_type, m_recordSize, size });
+            m_recordSize += size;
+        }
+        const size_t blockSize = 1 << 20;
+        m_buf.resize((std::max)(m_recordSize, blockSize / m_recordSize *
+            m_recordSize));
+        m_bufPos = 0;
+        m_bufEnd = 0;
     }
     m_index = 0;
 }
 
 
+// Get the next non-empty line of ASCII data.
+const char *PlyReader::nextLine()
+{
+    const char *begin;
+    const char *end;
+    while (m_lineReader->line(begin, end))
+    {
+        const auto& fields = m_tokenizer->split(begin, end);
+        if (fields.size())
+            return begin;
+    }
+    return nullptr;
+}
+
+
+// Get a pointer to the next binary vertex record, reading a new block
+// of records as necessary.
+const char *PlyReader::nextRecord()
+{
+    if (m_bufEnd - m_bufPos < m_recordSize)
+    {
+        size_t remain = m_bufEnd - m_bufPos;
+        std::memmove(m_buf.data(), m_buf.data() + m_bufPos, remain);
+        m_bufPos = 0;
+        m_bufEnd = remain;
+        if (m_stream->good())
+        {
+            m_stream->read(m_buf.data() + remain, m_buf.size() - remain);
+            m_bufEnd += m_stream->gcount();
+        }
+        if (m_bufEnd < m_recordSize)
+            return nullptr;
+    }
+    const char *pos = m_buf.data() + m_bufPos;
+    m_bufPos += m_recordSize;
+    return pos;
+}
+
+
+void PlyReader::readBinaryVertex(PointRef& point)
+{
+    const char *pos = nextRecord();
+    if (!pos)
+        throwError("Error reading data for point/element " +
+            std::to_string(m_index) + ".");
+
+    const bool bigEndian = (m_format == Format::BinaryBe);
+    for (const VertexField& f : m_vertexFields)
+    {
+        const char *src = pos + f.m_offset;
+        Everything e;
+        switch (f.m_size)
+        {
+        case 1:
+            e.u8 = (uint8_t)*src;
+            break;
+        case 2:
+            std::memcpy(&e.u16, src, 2);
+            e.u16 = bigEndian ? be16toh(e.u16) : le16toh(e.u16);
+            break;
+        case 4:
+            std::memcpy(&e.u32, src, 4);
+            e.u32 = bigEndian ? be32toh(e.u32) : le32toh(e.u32);
+            break;
+        case 8:
+            std::memcpy(&e.u64, src, 8);
+            e.u64 = bigEndian ? be64toh(e.u64) : le64toh(e.u64);
+            break;
+        }
+        point.setField(f.m_dim, f.m_type, &e);
+    }
+}
+
+
+void PlyReader::readTextVertex(PointRef& point)
+{
+    const char *begin;
+    const char *end;
+    const size_t numProps = m_vertexElt->m_properties.size();
+    while (true)
+    {
+        if (!m_lineReader->line(begin, end))
+            throwError("Error reading data for point/element " +
+                std::to_string(m_index) + ".");
+        if (m_tokenizer->split(begin, end).size())
+            break;
+    }
+    const std::vector<text::Field>& fields = m_tokenizer->split(begin, end);
+    if (fields.size() != numProps)
+        throwError("Error reading data for point/element " +
+            std::to_string(m_index) + ".");
+    for (size_t i = 0; i < numProps; ++i)
+    {
+        double d;
+        if (!text::parseDouble(fields[i], d))
+            throwError("Error reading data for point/element " +
+                std::to_string(m_index) + ".");
+        auto prop = static_cast<SimpleProperty *>(
+            m_vertexElt->m_properties[i].get());
+        point.setField(prop->m_dim, d);
+    }
+}
+
+
+// Parse ASCII vertex lines in blocks, possibly on several threads.
+point_count_t PlyReader::readTextVertices(PointViewPtr view,
+    point_count_t count)
+{
+    const size_t numProps = m_vertexElt->m_properties.size();
+    std::vector<text::Block> blocks;
+    PointRef point(view->point(0));
+    PointId idx = 0;
+    const char *begin;
+    const char *end;
+    while (idx < count && m_lineReader->block(begin, end))
+    {
+        // Only parse the lines belonging to the vertex element.  What
+        // follows is data for other elements, which we don't read.
+        point_count_t lines = 0;
+        const char *pos = begin;
+        while (pos != end && idx + lines < count)
+        {
+            const char *eol = (const char *)std::memchr(pos, '\n', end - pos);
+            const char *next = eol ? eol + 1 : end;
+            // Count the lines that have fields, as the tokenizer sees them.
+            if (std::any_of(pos, next, [](char c)
+                    { return c != ' ' && c != '\r' && c != '\n'; }))
+                lines++;
+            pos = next;
+        }
+        end = pos;
+
+        text::parseLines(begin, end, ' ', numProps, m_threads, blocks);
+        for (const text::Block& b : blocks)
+        {
+            // Lines of only whitespace have no fields.  Skip them, as
+            // readTextVertex() does.
+            for (const text::LineError& e : b.errors)
+                if (e.fieldCount)
+                    throwError("Error reading data for point/element " +
+                        std::to_string(idx + e.line) + ".");
+            for (size_t i = 0; i < b.values.size(); i += numProps)
+            {
+                point.setPointId(idx++);
+                for (size_t p = 0; p < numProps; ++p)
+                {
+                    auto prop = static_cast<SimpleProperty *>(
+                        m_vertexElt->m_properties[p].get());
+                    point.setField(prop->m_dim, b.values[i + p]);
+                }
+            }
+        }
+    }
+    if (idx < count)
+        throwError("Error reading data for point/element " +
+            std::to_string(idx) + ".");
+    m_index += idx;
+    return idx;
+}
+
+
 bool PlyReader::processOne(PointRef& point)
 {
     if (m_index < m_vertexElt->m_count)
     {
-        readElement(*m_vertexElt, point);
+        if (m_format == Format::Ascii)
+            readTextVertex(point);
+        else
+            readBinaryVertex(point);
         m_index++;
         return true;
     }
@@ -450,21 +666,26 @@ bool PlyReader::processOne(PointRef& point)
 // We're just reading the vertex element here.
 point_count_t PlyReader::read(PointViewPtr view, point_count_t num)
 {
-    point_count_t cnt(0);
+    point_count_t count = (std::min)(num,
+        (point_count_t)(m_vertexElt->m_count - m_index));
+    if (m_format == Format::Ascii)
+        return readTextVertices(view, count);
 
     PointRef point(view->point(0));
-    for (PointId idx = 0; idx < m_vertexElt->m_count && idx < num; ++idx)
+    for (PointId idx = 0; idx < count; ++idx)
     {
         point.setPointId(idx);
         processOne(point);
-        cnt++;
     }
-    return cnt;
+    return count;
 }
 
 
 void PlyReader::done(PointTableRef table)
 {
+    m_lineReader.reset();
+    m_tokenizer.reset();
+    m_buf.clear();
     Utils::closeFile(m_stream);
 }
 
@@ -45,6 +45,12 @@
 namespace pdal
 {
 
+namespace text
+{
+    class LineReader;
+    class Tokenizer;
+}
+
 class PDAL_DLL PlyReader : public Reader, public Streamable
 {
 public:
@@ -53,6 +59,7 @@ public:
     typedef std::map<std::string, Dimension::Id> DimensionMap;
 
     PlyReader();
+    ~PlyReader();
 
 private:
     enum class Format
@@ -106,6 +113,15 @@ private:
             PointRef& point) override;
     };
 
+    // Where to find a vertex property in a binary vertex record.
+    struct VertexField
+    {
+        Dimension::Id m_dim;
+        Dimension::Type m_type;
+        size_t m_offset;
+        size_t m_size;
+    };
+
     struct Element
     {
         Element(const std::string name, size_t count) :
@@ -126,7 +142,21 @@ private:
     std::vector<Element> m_elements;
     PointId m_index;
     Element *m_vertexElt;
+    int m_threads;
+
+    // Binary vertex data is read into m_buf in blocks and decoded
+    // according to m_vertexFields.
+    std::vector<VertexField> m_vertexFields;
+    size_t m_recordSize;
+    std::vector<char> m_buf;
+    size_t m_bufPos;
+    size_t m_bufEnd;
+
+    // ASCII data is read by line.
+    std::unique_ptr<text::LineReader> m_lineReader;
+    std::unique_ptr<text::Tokenizer> m_tokenizer;
 
+    virtual void addArgs(ProgramArgs& args);
     virtual void initialize();
     virtual void addDimensions(PointLayoutPtr layout);
     virtual void ready(PointTableRef table);
@@ -147,6 +177,11 @@ private:
     void extractHeader();
     void readElement(Element& elt, PointRef& point);
     bool readProperty(Property *prop, PointRef& point);
+    const char *nextLine();
+    const char *nextRecord();
+    void readTextVertex(PointRef& point);
+    void readBinaryVertex(PointRef& point);
+    point_count_t readTextVertices(PointViewPtr view, point_count_t count);
 };
 
 } // namespace pdal
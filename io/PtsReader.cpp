@@ -36,6 +36,7 @@
 #include <pdal/util/Algorithm.hpp>
 
 #include "PtsReader.hpp"
+#include "private/TextParser.hpp"
 
 namespace pdal
 {
@@ -52,6 +53,12 @@ CREATE_STATIC_STAGE(PtsReader, s_info)
 
 std::string PtsReader::getName() const { return s_info.name; }
 
+void PtsReader::addArgs(ProgramArgs& args)
+{
+    args.add("threads", "Number of threads used to parse points", m_threads,
+        1);
+}
+
 void PtsReader::initialize(PointTableRef table)
 {
     m_istream = Utils::openFile(m_filename);
@@ -129,47 +136,52 @@ point_count_t PtsReader::read(PointViewPtr view, point_count_t numPts)
     point_count_t cnt = 0;
     size_t line = 1;
 
-    // Continue reading while count less than max points and count less than 
+    // Continue reading while count less than max points and count less than
     // the expected point count.
-    while (m_istream->good() && cnt < numPts && cnt < m_PointCount)
+    numPts = (std::min)(numPts, m_PointCount);
+    text::LineReader reader(*m_istream);
+    std::vector<text::Block> blocks;
+    const char *begin;
+    const char *end;
+    while (cnt < numPts && reader.block(begin, end))
     {
-        std::string buf;
-        StringList fields;
-
-        std::getline(*m_istream, buf);
-        line++;
-        if (buf.empty())
-            continue;
-
-        fields = Utils::split2(buf, m_separator);
-        if (fields.size() != m_dims.size())
+        text::parseLines(begin, end, m_separator, m_dims.size(), m_threads,
+            blocks);
+        for (const text::Block& block : blocks)
         {
-            log()->get(LogLevel::Error) << "Line " << line <<
-               " in '" << m_filename << "' contains " << fields.size() <<
-               " fields when " << m_dims.size() << " were expected.  "
-               "Ignoring." << std::endl;
-            continue;
-        }
-
-        double d;
-        for (size_t i = 0; i < fields.size(); ++i)
-        {
-            if (!Utils::fromString(fields[i], d))
+            for (const text::LineError& error : block.errors)
             {
-                log()->get(LogLevel::Error) << "Can't convert "
-                    "field '" << fields[i] << "' to numeric value on line " <<
-                    line << " in '" << m_filename << "'.  Setting to 0." <<
-                    std::endl;
-                d = 0;
+                if (error.fieldCount != m_dims.size())
+                    log()->get(LogLevel::Error) << "Line " <<
+                       line + error.line + 1 << " in '" << m_filename <<
+                       "' contains " << error.fieldCount << " fields when " <<
+                       m_dims.size() << " were expected.  Ignoring." <<
+                       std::endl;
+                else
+                    log()->get(LogLevel::Error) << "Can't convert "
+                        "field '" << error.field << "' to numeric value on "
+                        "line " << line + error.line + 1 << " in '" <<
+                        m_filename << "'.  Setting to 0." << std::endl;
             }
-            if (i == 3) // Intensity field in PTS is -2048 to 2047, we map to 0 4095
+            line += block.lines;
+
+            const double *v = block.values.data();
+            const double *vEnd = v + block.values.size();
+            while (v != vEnd && cnt < numPts)
             {
-                d += 2048;
+                for (size_t i = 0; i < m_dims.size(); ++i)
+                {
+                    double d = *v++;
+                    if (i == 3) // Intensity field in PTS is -2048 to 2047, we map to 0 4095
+                    {
+                        d += 2048;
+                    }
+                    view->setField(m_dims[i], idx, d);
+                }
+                cnt++;
+                idx++;
             }
-            view->setField(m_dims[i], idx, d);
         }
-        cnt++;
-        idx++;
     }
 
     if(cnt < m_PointCount)
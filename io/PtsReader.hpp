@@ -49,6 +49,12 @@ public:
     std::string getName() const;
 
 private:
+    /**
+      Add arguments to those accepted at the command line.
+      \param args  Argument list to modify.
+    */
+    virtual void addArgs(ProgramArgs& args);
+
     /**
       Initialize the reader by opening the file and reading the header line
       for the point count.
@@ -95,6 +101,7 @@ private:
     std::istream *m_istream;
     StringList m_dimNames;
     Dimension::IdList m_dims;
+    int m_threads;
 };
 
 } // namespace pdal
@@ -33,12 +33,58 @@
 ****************************************************************************/
 
 #include "TIndexReader.hpp"
+
+#include <cstring>
+
 #include <pdal/GDALUtils.hpp>
+#include <pdal/SrsBounds.hpp>
+#include <pdal/StageWrapper.hpp>
+#include <pdal/private/ThreadRange.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
 namespace pdal
 {
 
+namespace
+{
+
+// Point storage for running the stages of a single file in standard mode.
+// The table shares the (finalized) layout of the table being filled by the
+// tile index reader, so points can be copied to the output as raw bytes.
+class ChainTable : public SimplePointTable
+{
+public:
+    ChainTable(PointLayout& layout) : SimplePointTable(layout), m_numPts(0)
+        {}
+
+    virtual bool supportsView() const
+        { return true; }
+    // The layout is shared and already finalized.
+    virtual void finalize()
+        {}
+
+protected:
+    virtual char *getPoint(PointId idx)
+    {
+        char *buf = m_blocks[idx / BlockPtCnt].get();
+        return buf + pointsToBytes(idx % BlockPtCnt);
+    }
+
+private:
+    virtual PointId addPoint()
+    {
+        if (m_numPts % BlockPtCnt == 0)
+            m_blocks.emplace_back(new char[pointsToBytes(BlockPtCnt)]());
+        return m_numPts++;
+    }
+
+    static const point_count_t BlockPtCnt = 65536;
+    std::vector<std::unique_ptr<char[]>> m_blocks;
+    point_count_t m_numPts;
+};
+
+} // unnamed namespace
+
 static StaticPluginInfo const s_info
 {
     "readers.tindex",
@@ -125,6 +171,8 @@ void TIndexReader::addArgs(ProgramArgs& args)
         "with lyr_name", m_attributeFilter);
     args.add("dialect", "OGR SQL dialect to use when querying tile "
         "index layer", m_dialect, "OGRSQL");
+    args.add("threads", "Number of files to read concurrently", m_threads,
+        (size_t)4);
 }
 
 
@@ -208,13 +256,25 @@ void TIndexReader::initialize()
     }
 
     Options cropOptions;
+    std::string queryBounds;
     if (m_wkt.size())
+    {
         cropOptions.add("polygon", m_wkt);
 
+        // Readers that can limit what they read to a region get the
+        // extent of the query.  The crop filter still trims to the
+        // exact geometry.
+        OGREnvelope env;
+        OGR_G_GetEnvelope(wkt_g->get(), &env);
+        SrsBounds b(BOX2D(env.MinX, env.MinY, env.MaxX, env.MaxY),
+            SpatialReference(m_out_ref->wkt()));
+        queryBounds = Utils::toString(b);
+    }
+
     for (auto f : getFiles())
     {
         log()->get(LogLevel::Debug) << "Adding file " << f.m_filename <<
-            " to merge filter" << std::endl;
+            " to tile index reader" << std::endl;
 
         std::string driver = m_factory.inferReaderDriver(f.m_filename);
         Stage *reader = m_factory.createStage(driver);
@@ -223,9 +283,15 @@ void TIndexReader::initialize()
                 "'.");
         Options readerOptions;
         readerOptions.add("filename", f.m_filename);
+        if (queryBounds.size() && driver == "readers.ept")
+            readerOptions.add("bounds", queryBounds);
         reader->setOptions(readerOptions);
         Stage *premerge = reader;
 
+        Chain chain;
+        chain.m_filename = f.m_filename;
+        chain.m_stages.push_back(reader);
+
         if (m_tgtSrsString != f.m_srs &&
             (m_tgtSrsString.size() && f.m_srs.size()))
         {
@@ -239,6 +305,7 @@ void TIndexReader::initialize()
                                          << f.m_srs << "!\n";
             repro->setOptions(reproOptions);
             premerge = repro;
+            chain.m_stages.push_back(repro);
         }
 
         // WKT is set even if we're using a bounding box for filtering, so
@@ -251,9 +318,10 @@ void TIndexReader::initialize()
             log()->get(LogLevel::Debug3) << "Cropping data with wkt '"
                                          << m_wkt << "'" << std::endl;
             premerge = crop;
+            chain.m_stages.push_back(crop);
         }
 
-        m_merge.setInput(*premerge);
+        m_chains.push_back(chain);
     }
 
     if (m_sql.size())
@@ -270,21 +338,136 @@ void TIndexReader::initialize()
     m_dataset = 0;
 }
 
+
+bool TIndexReader::pipelineStreamable() const
+{
+    for (const Chain& chain : m_chains)
+        for (Stage *s : chain.m_stages)
+            if (!dynamic_cast<Streamable *>(s))
+                return false;
+    return Streamable::pipelineStreamable();
+}
+
+
 void TIndexReader::prepared(PointTableRef table)
 {
-    m_merge.prepare(table);
+    // Preparing registers the dimensions of every file in our layout.
+    for (Chain& chain : m_chains)
+        chain.m_stages.back()->prepare(table);
 }
 
+
 void TIndexReader::ready(PointTableRef table)
 {
-    m_pvSet = m_merge.execute(table);
+    m_table = &table;
+    m_current = 0;
+    m_active.clear();
+}
+
+
+PointViewSet TIndexReader::run(PointViewPtr view)
+{
+    PointLayout& layout = *view->table().layout();
+    const size_t pointSize = layout.pointSize();
+    const size_t threads = (std::max)(m_threads, size_t(1));
+
+    // Files are read in batches of 'threads', each into its own table.
+    // The points are then appended to the output in index order.
+    for (size_t first = 0; first < m_chains.size(); first += threads)
+    {
+        const size_t count = (std::min)(threads, m_chains.size() - first);
+
+        std::vector<std::unique_ptr<ChainTable>> tables;
+        std::vector<PointViewSet> results(count);
+        for (size_t i = 0; i < count; ++i)
+            tables.emplace_back(new ChainTable(layout));
+        forEachIndex(count, (int)count, [&](PointId i)
+        {
+            Stage *last = m_chains[first + i].m_stages.back();
+            results[i] = last->execute(*tables[i]);
+        });
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            log()->get(LogLevel::Debug) << "Read file " <<
+                m_chains[first + i].m_filename << std::endl;
+            for (PointViewPtr v : results[i])
+                for (PointId idx = 0; idx < v->size(); ++idx)
+                    std::memcpy(view->getOrAddPoint(view->size()),
+                        v->getPoint(idx), pointSize);
+        }
+    }
+
+    PointViewSet viewSet;
+    viewSet.insert(view);
+    return viewSet;
+}
+
+
+void TIndexReader::startChain(const Chain& chain)
+{
+    for (Stage *s : chain.m_stages)
+    {
+        Streamable *ss = dynamic_cast<Streamable *>(s);
+        if (!ss)
+            throwError("Stage '" + s->getName() + "' used to read '" +
+                chain.m_filename + "' does not support streaming.");
+        m_active.push_back(ss);
+    }
+
+    // Let each filter know the SRS of the points arriving from upstream.
+    SpatialReference srs;
+    for (Streamable *s : m_active)
+    {
+        StreamableWrapper::ready(*s, *m_table);
+        if (s != m_active.front())
+            StreamableWrapper::spatialReferenceChanged(*s, srs);
+        if (!s->getSpatialReference().empty())
+            srs = s->getSpatialReference();
+    }
 }
 
 
-PointViewSet TIndexReader::run(PointViewPtr)
+void TIndexReader::finishChain()
 {
-    return m_pvSet;
+    for (Streamable *s : m_active)
+        StreamableWrapper::done(*s, *m_table);
+    m_active.clear();
 }
 
-} // namespace pdal
 
+bool TIndexReader::processOne(PointRef& point)
+{
+    while (m_current < m_chains.size())
+    {
+        if (m_active.empty())
+        {
+            log()->get(LogLevel::Debug) << "Streaming file " <<
+                m_chains[m_current].m_filename << std::endl;
+            startChain(m_chains[m_current]);
+        }
+
+        Streamable& reader = *m_active.front();
+        while (StreamableWrapper::processOne(reader, point))
+        {
+            bool keep(true);
+            for (size_t i = 1; keep && i < m_active.size(); ++i)
+                keep = StreamableWrapper::processOne(*m_active[i], point);
+            if (keep)
+                return true;
+        }
+        finishChain();
+        m_current++;
+    }
+    return false;
+}
+
+
+void TIndexReader::done(PointTableRef)
+{
+    // Only set if streaming stopped before all the files were read.
+    if (m_active.size())
+        finishChain();
+}
+
+} // namespace pdal
@@ -37,14 +37,14 @@
 #include <pdal/PointView.hpp>
 #include <pdal/Reader.hpp>
 #include <pdal/StageFactory.hpp>
-#include <filters/MergeFilter.hpp>
+#include <pdal/Streamable.hpp>
 
 namespace pdal
 {
 
 namespace gdal { class SpatialRef; }
 
-class PDAL_DLL TIndexReader : public Reader
+class PDAL_DLL TIndexReader : public Reader, public Streamable
 {
     struct FileInfo
     {
@@ -63,11 +63,21 @@ class PDAL_DLL TIndexReader : public Reader
         int m_mtime;
     };
 
+    // Stages that read a single file of the index: the reader, followed by
+    // any reprojection and crop filters.
+    struct Chain
+    {
+        std::string m_filename;
+        std::vector<Stage *> m_stages;
+    };
+
 public:
-    TIndexReader() : m_dataset(NULL) , m_layer(NULL)
+    TIndexReader() : m_dataset(NULL) , m_layer(NULL), m_table(NULL),
+        m_current(0)
         {}
 
     std::string getName() const;
+    virtual bool pipelineStreamable() const;
 
 private:
     virtual void addDimensions(PointLayoutPtr layout);
@@ -76,6 +86,8 @@ private:
     virtual void prepared(PointTableRef table);
     virtual void ready(PointTableRef table);
     virtual PointViewSet run(PointViewPtr view);
+    virtual bool processOne(PointRef& point);
+    virtual void done(PointTableRef table);
 
     std::string m_layerName;
     std::string m_driverName;
@@ -88,17 +100,24 @@ private:
     std::string m_dialect;
     BOX2D m_bounds;
     std::string m_sql;
+    std::size_t m_threads;
 
     std::unique_ptr<gdal::SpatialRef> m_out_ref;
     void *m_dataset;
     void *m_layer;
 
     StageFactory m_factory;
-    MergeFilter m_merge;
-    PointViewSet m_pvSet;
+    std::vector<Chain> m_chains;
+
+    // Streaming state.
+    BasePointTable *m_table;
+    std::size_t m_current;
+    std::vector<Streamable *> m_active;
 
     std::vector<FileInfo> getFiles();
     FieldIndexes getFields();
+    void startChain(const Chain& chain);
+    void finishChain();
 };
 
 
@@ -36,6 +36,7 @@
 #include <pdal/util/Algorithm.hpp>
 
 #include "TextReader.hpp"
+#include "private/TextParser.hpp"
 #include "../filters/StatsFilter.hpp"
 
 namespace pdal
@@ -53,6 +54,12 @@ CREATE_STATIC_STAGE(TextReader, s_info)
 
 std::string TextReader::getName() const { return s_info.name; }
 
+TextReader::TextReader() : m_istream(NULL)
+{}
+
+TextReader::~TextReader()
+{}
+
 // NOTE: - Forces reading of the entire file.
 QuickInfo TextReader::inspect()
 {
@@ -217,6 +224,8 @@ void TextReader::addArgs(ProgramArgs& args)
     args.add("header", "Use this string as the header line.", m_header);
     args.add("skip", "Skip this number of lines before attempting to "
         "read the header.", m_skip);
+    args.add("threads", "Number of threads used to parse points in "
+        "standard mode", m_threads, 1);
 }
 
 
@@ -245,6 +254,9 @@ void TextReader::ready(PointTableRef table)
     std::string dummy;
     for (size_t i = 0; i < m_line; ++i)
 	std::getline(*m_istream, dummy);
+
+    m_lineReader.reset(new text::LineReader(*m_istream));
+    m_tokenizer.reset(new text::Tokenizer(m_separator));
 }
 
 
@@ -252,76 +264,91 @@ point_count_t TextReader::read(PointViewPtr view, point_count_t numPts)
 {
     PointId idx = view->size();
     point_count_t cnt = 0;
-    PointRef point(*view, idx);
-    while (cnt < numPts)
-    {
-        point.setPointId(idx);
-        if (!processOne(point))
-            break;
-        cnt++;
-        idx++;
-    }
-    return cnt;
-}
 
-
-bool TextReader::processOne(PointRef& point)
-{
-    if (!fillFields())
-        return false;
-
-    double d;
-    for (size_t i = 0; i < m_fields.size(); ++i)
+    // Parse large runs of lines at once, possibly on several threads, and
+    // then copy the values into the view.
+    std::vector<text::Block> blocks;
+    const char *begin;
+    const char *end;
+    while (cnt < numPts && m_lineReader->block(begin, end))
     {
-        if (!Utils::fromString(m_fields[i], d))
+        text::parseLines(begin, end, m_separator, m_dims.size(), m_threads,
+            blocks);
+        for (const text::Block& block : blocks)
         {
-            log()->get(LogLevel::Error) << "Can't convert "
-                "field '" << m_fields[i] << "' to numeric value on line " <<
-                m_line << " in '" << m_filename << "'.  Setting to 0." <<
-                std::endl;
-            d = 0;
+            for (const text::LineError& error : block.errors)
+                logError(error, m_line + error.line + 1);
+            m_line += block.lines;
+
+            const double *v = block.values.data();
+            const double *vEnd = v + block.values.size();
+            while (v != vEnd && cnt < numPts)
+            {
+                for (Dimension::Id id : m_dims)
+                    view->setField(id, idx, *v++);
+                cnt++;
+                idx++;
+            }
         }
-        point.setField(m_dims[i], d);
     }
-    return true;
+    return cnt;
 }
 
 
-bool TextReader::fillFields()
+bool TextReader::processOne(PointRef& point)
 {
+    const char *begin;
+    const char *end;
     while (true)
     {
-        if (!m_istream->good())
+        if (!m_lineReader->line(begin, end))
             return false;
-
-        std::string buf;
-
-        std::getline(*m_istream, buf);
         m_line++;
-        if (buf.empty())
+        if (begin == end)
             continue;
-        if (m_separator != ' ')
+
+        const std::vector<text::Field>& fields =
+            m_tokenizer->split(begin, end);
+        if (fields.size() != m_dims.size())
         {
-            Utils::remove(buf, ' ');
-            m_fields = Utils::split(buf, m_separator);
+            logError({ 0, fields.size(), "" }, m_line);
+            continue;
         }
-        else
-            m_fields = Utils::split2(buf, m_separator);
-        if (m_fields.size() != m_dims.size())
+
+        double d;
+        for (size_t i = 0; i < fields.size(); ++i)
         {
-            log()->get(LogLevel::Error) << "Line " << m_line <<
-                " in '" << m_filename << "' contains " << m_fields.size() <<
-                " fields when " << m_dims.size() << " were expected.  "
-                "Ignoring." << std::endl;
-            continue;
+            if (!text::parseDouble(fields[i], d))
+            {
+                logError({ 0, fields.size(), text::fieldString(fields[i]) },
+                    m_line);
+                d = 0;
+            }
+            point.setField(m_dims[i], d);
         }
         return true;
     }
 }
 
 
+void TextReader::logError(const text::LineError& error, size_t line)
+{
+    if (error.fieldCount != m_dims.size())
+        log()->get(LogLevel::Error) << "Line " << line <<
+            " in '" << m_filename << "' contains " << error.fieldCount <<
+            " fields when " << m_dims.size() << " were expected.  "
+            "Ignoring." << std::endl;
+    else
+        log()->get(LogLevel::Error) << "Can't convert "
+            "field '" << error.field << "' to numeric value on line " <<
+            line << " in '" << m_filename << "'.  Setting to 0." <<
+            std::endl;
+}
+
+
 void TextReader::done(PointTableRef table)
 {
+    m_lineReader.reset();
     Utils::closeFile(m_istream);
 }
 
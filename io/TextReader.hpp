@@ -35,6 +35,7 @@
 #pragma once
 
 #include <istream>
+#include <memory>
 
 #include <pdal/Reader.hpp>
 #include <pdal/Streamable.hpp>
@@ -42,13 +43,20 @@
 namespace pdal
 {
 
+namespace text
+{
+    class LineReader;
+    class Tokenizer;
+    struct LineError;
+}
+
 class PDAL_DLL TextReader : public Reader, public Streamable
 {
 public:
     std::string getName() const;
 
-    TextReader() : m_istream(NULL)
-    {}
+    TextReader();
+    ~TextReader();
 
 private:
     /**
@@ -111,7 +119,13 @@ private:
     */
     virtual bool processOne(PointRef& point);
 
-    bool fillFields();
+    /**
+      Log a problem found while parsing a line.
+
+      \param error  Description of the problem.
+      \param line  Line number in the file.
+    */
+    void logError(const text::LineError& error, size_t line);
 
     /**
       Parse a header line into a list of dimension names.
@@ -146,12 +160,14 @@ private:
     char m_separator;
     Arg *m_separatorArg;
     std::istream *m_istream;
+    std::unique_ptr<text::LineReader> m_lineReader;
+    std::unique_ptr<text::Tokenizer> m_tokenizer;
     StringList m_dimNames;
     Dimension::IdList m_dims;
-    StringList m_fields;
     size_t m_line;
     std::string m_header;
     size_t m_skip;
+    int m_threads;
 };
 
 } // namespace pdal
@@ -33,10 +33,12 @@
 ****************************************************************************/
 
 #include "TextWriter.hpp"
+#include "private/TextFormat.hpp"
 
 #include <pdal/pdal_export.hpp>
 #include <pdal/PDALUtils.hpp>
 #include <pdal/PointView.hpp>
+#include <pdal/private/ThreadRange.hpp>
 #include <pdal/util/Algorithm.hpp>
 #include <pdal/util/ProgramArgs.hpp>
 
@@ -45,6 +47,18 @@
 namespace pdal
 {
 
+namespace
+{
+
+// Formatted points are collected in memory and written in pieces of about
+// this size.
+const size_t BufferSize = 1 << 20;
+
+// Number of points formatted as a unit when formatting in parallel.
+const point_count_t ChunkSize = 50000;
+
+} // unnamed namespace
+
 static StaticPluginInfo const s_info
 {
     "writers.text",
@@ -110,6 +124,8 @@ void TextWriter::addArgs(ProgramArgs& args)
     args.add("quote_header", "Whether a header should be quoted",
         m_quoteHeader, true);
     args.add("precision", "Output precision", m_precision, 3);
+    args.add("threads", "Number of threads used to format points in "
+        "standard mode", m_threads, 1);
 }
 
 
@@ -168,8 +184,6 @@ bool TextWriter::findDim(Dimension::Id id, DimSpec& ds)
 
 void TextWriter::ready(PointTableRef table)
 {
-    *m_stream << std::fixed;
-
     m_xDim = { Dimension::Id::X, static_cast<size_t>(m_precision),
         table.layout()->dimName(Dimension::Id::X) };
     m_yDim = { Dimension::Id::Y, static_cast<size_t>(m_precision),
@@ -226,6 +240,7 @@ void TextWriter::writeHeader(PointTableRef table)
 
 void TextWriter::writeFooter()
 {
+    flushBuffer();
     if (m_outputType == OutputType::GEOJSON)
     {
         *m_stream << "]}";
@@ -241,7 +256,6 @@ void TextWriter::writeGeoJSONHeader()
     if (m_callback.size())
         *m_stream << m_callback <<"(";
     *m_stream << "{ \"type\": \"FeatureCollection\", \"features\": [";
-    *m_stream << ",";
 }
 
 
@@ -262,77 +276,111 @@ void TextWriter::writeCSVHeader(PointTableRef table)
 }
 
 
-void TextWriter::processOneCSV(PointRef& point)
+void TextWriter::formatCSV(PointRef& point, std::string& out) const
 {
     for (auto di = m_dims.begin(); di != m_dims.end(); ++di)
     {
         if (di != m_dims.begin())
-            *m_stream << m_delimiter;
-        m_stream->precision(di->precision);
-        *m_stream << point.getFieldAs<double>(di->id);
+            out += m_delimiter;
+        text::appendFixed(out, point.getFieldAs<double>(di->id),
+            di->precision);
     }
-    *m_stream << m_newline;
+    out += m_newline;
 }
 
-void TextWriter::processOneGeoJSON(PointRef& point)
+
+void TextWriter::formatGeoJSON(PointRef& point, bool first,
+    std::string& out) const
 {
-    if (m_idx)
-        *m_stream << ",";
-    *m_stream << "{ \"type\":\"Feature\",\"geometry\": "
+    if (!first)
+        out += ",";
+    out += "{ \"type\":\"Feature\",\"geometry\": "
         "{ \"type\": \"Point\", \"coordinates\": [";
 
-    m_stream->precision(m_xDim.precision);
-    *m_stream << point.getFieldAs<double>(Dimension::Id::X) << ",";
-    m_stream->precision(m_yDim.precision);
-    *m_stream << point.getFieldAs<double>(Dimension::Id::Y) << ",";
-    m_stream->precision(m_zDim.precision);
-    *m_stream << point.getFieldAs<double>(Dimension::Id::Z) << "]},";
+    text::appendFixed(out, point.getFieldAs<double>(Dimension::Id::X),
+        m_xDim.precision);
+    out += ",";
+    text::appendFixed(out, point.getFieldAs<double>(Dimension::Id::Y),
+        m_yDim.precision);
+    out += ",";
+    text::appendFixed(out, point.getFieldAs<double>(Dimension::Id::Z),
+        m_zDim.precision);
+    out += "]},";
 
-    *m_stream << "\"properties\": {";
+    out += "\"properties\": {";
 
     for (auto di = m_dims.begin(); di != m_dims.end(); ++di)
     {
         if (di != m_dims.begin())
-            *m_stream << ",";
-
-        *m_stream << "\"" << di->name << "\":";
-        *m_stream << "\"";
-        m_stream->precision(di->precision);
-        *m_stream << point.getFieldAs<double>(di->id);
-        *m_stream <<"\"";
+            out += ",";
+
+        out += "\"";
+        out += di->name;
+        out += "\":\"";
+        text::appendFixed(out, point.getFieldAs<double>(di->id),
+            di->precision);
+        out += "\"";
     }
-    *m_stream << "}"; // end properties
-    *m_stream << "}"; // end feature
+    out += "}"; // end properties
+    out += "}"; // end feature
+}
+
+
+void TextWriter::flushBuffer()
+{
+    if (m_buf.size())
+        m_stream->write(m_buf.data(), m_buf.size());
+    m_buf.clear();
 }
 
 
 bool TextWriter::processOne(PointRef& point)
 {
     if (m_outputType == OutputType::CSV)
-        processOneCSV(point);
+        formatCSV(point, m_buf);
     else
-        processOneGeoJSON(point);
+        formatGeoJSON(point, m_idx == 0, m_buf);
     m_idx++;
+    if (m_buf.size() >= BufferSize)
+        flushBuffer();
     return true;
 }
 
 
 void TextWriter::write(const PointViewPtr view)
 {
-    PointRef point(*view, 0);
+    // Points are formatted in chunks, several at a time when we have
+    // threads, and the chunks are written in order.
+    const point_count_t numChunks = (view->size() + ChunkSize - 1) / ChunkSize;
+    const point_count_t batchSize = (std::max)(m_threads, 1);
+    std::vector<std::string> chunks(batchSize);
 
-    if (m_outputType == OutputType::CSV)
-        for (PointId idx = 0; idx < view->size(); ++idx)
-        {
-            point.setPointId(idx);
-            processOneCSV(point);
-        }
-    else if (m_outputType == OutputType::GEOJSON)
-        for (PointId idx = 0; idx < view->size(); ++idx)
+    for (point_count_t batch = 0; batch < numChunks; batch += batchSize)
+    {
+        const point_count_t count = (std::min)(batchSize, numChunks - batch);
+        forEachIndex(count, m_threads, [&](point_count_t i)
         {
-            point.setPointId(idx);
-            processOneGeoJSON(point);
-        }
+            std::string& out = chunks[i];
+            out.clear();
+
+            const PointId begin = (batch + i) * ChunkSize;
+            const PointId end = (std::min)(begin + ChunkSize, view->size());
+            PointRef point(*view, begin);
+            for (PointId idx = begin; idx < end; ++idx)
+            {
+                point.setPointId(idx);
+                if (m_outputType == OutputType::CSV)
+                    formatCSV(point, out);
+                else
+                    formatGeoJSON(point, m_idx + idx == 0, out);
+            }
+        });
+
+        flushBuffer();
+        for (point_count_t i = 0; i < count; ++i)
+            m_stream->write(chunks[i].data(), chunks[i].size());
+    }
+    m_idx += view->size();
 }
 
 
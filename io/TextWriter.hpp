@@ -79,8 +79,9 @@ private:
     void writeFooter();
     void writeGeoJSONHeader();
     void writeCSVHeader(PointTableRef table);
-    void processOneCSV(PointRef& point);
-    void processOneGeoJSON(PointRef& point);
+    void formatCSV(PointRef& point, std::string& out) const;
+    void formatGeoJSON(PointRef& point, bool first, std::string& out) const;
+    void flushBuffer();
 
     DimSpec extractDim(std::string dim, PointTableRef table);
     bool findDim(Dimension::Id id, DimSpec& ds);
@@ -96,9 +97,11 @@ private:
     bool m_quoteHeader;
     bool m_packRgb;
     int m_precision;
+    int m_threads;
     PointId m_idx;
 
     FileStreamPtr m_stream;
+    std::string m_buf;
     std::vector<DimSpec> m_dims;
     DimSpec m_xDim;
     DimSpec m_yDim;
@@ -0,0 +1,342 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "EptCache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/Utils.hpp>
+
+namespace pdal
+{
+
+namespace
+{
+
+// Number of parsed hierarchy files kept in memory.
+const size_t MaxJsonEntries = 256;
+
+const std::string TempSuffix = ".tmp";
+
+// Determine if a file is left from a write that never completed.  Such
+// files are named for the entry, followed by TempSuffix and a number.
+bool isTempFile(const std::string& file)
+{
+    const std::string name(FileUtils::getFilename(file));
+    const size_t pos = name.rfind(TempSuffix);
+    if (pos == std::string::npos)
+        return false;
+    auto begin = name.begin() + pos + TempSuffix.size();
+    return begin != name.end() &&
+        std::all_of(begin, name.end(), [](char c){ return std::isdigit(c); });
+}
+
+} // unnamed namespace
+
+
+std::shared_ptr<EptCache> EptCache::open(const std::string& dir,
+    uint64_t maxSize)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<EptCache>> caches;
+
+    const std::string path(FileUtils::toAbsolutePath(dir));
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<EptCache> cache = caches[path].lock();
+    if (cache)
+        cache->setMaxSize(maxSize);
+    else
+    {
+        cache.reset(new EptCache(path, maxSize));
+        caches[path] = cache;
+    }
+    return cache;
+}
+
+
+std::string EptCache::datasetId(const std::string& root,
+    const std::string& info)
+{
+    // FNV-1a, which unlike std::hash is the same everywhere.
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const std::string& s)
+    {
+        for (unsigned char c : s)
+        {
+            hash ^= c;
+            hash *= 1099511628211ULL;
+        }
+    };
+    add(root);
+    add("\n");
+    add(info);
+
+    std::ostringstream oss;
+    oss << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return oss.str();
+}
+
+
+EptCache::EptCache(const std::string& dir, uint64_t maxSize) :
+    m_dir(dir), m_maxSize(maxSize), m_size(0)
+{
+    if (!FileUtils::directoryExists(m_dir) &&
+            !FileUtils::createDirectories(m_dir))
+        throw pdal_error("Unable to create EPT cache directory '" +
+            m_dir + "'.");
+    scan();
+    evict();
+}
+
+
+void EptCache::setMaxSize(uint64_t maxSize)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_maxSize = maxSize;
+    evict();
+}
+
+
+// Find the entries left by earlier runs.
+void EptCache::scan()
+{
+    struct Found
+    {
+        std::string path;
+        uint64_t size;
+        std::time_t time;
+    };
+    std::vector<Found> found;
+
+    for (const std::string& sub : FileUtils::directoryList(m_dir))
+    {
+        if (!FileUtils::isDirectory(sub))
+            continue;
+        for (const std::string& file : FileUtils::directoryList(sub))
+        {
+            // Remove files from writes that never completed.
+            if (isTempFile(file))
+            {
+                FileUtils::deleteFile(file);
+                continue;
+            }
+            struct tm modTime;
+            FileUtils::fileTimes(file, nullptr, &modTime);
+            found.push_back({ file, FileUtils::fileSize(file),
+                std::mktime(&modTime) });
+        }
+    }
+
+    std::sort(found.begin(), found.end(),
+        [](const Found& a, const Found& b){ return a.time > b.time; });
+    for (Found& f : found)
+    {
+        m_lru.push_back({ f.path, f.size });
+        m_entries[f.path] = std::prev(m_lru.end());
+        m_size += f.size;
+    }
+}
+
+
+std::string EptCache::path(const std::string& dataset,
+    const std::string& name) const
+{
+    return m_dir + "/" + dataset + "/" + name;
+}
+
+
+// Mark an entry as most recently used.  Returns false if there's no
+// such entry.  Call with the mutex held.
+bool EptCache::touch(const std::string& path)
+{
+    auto it = m_entries.find(path);
+    if (it == m_entries.end())
+        return false;
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+    return true;
+}
+
+
+// Remove least recently used entries until we're within the size limit.
+// The most recent entry is always kept.  Call with the mutex held.
+void EptCache::evict()
+{
+    while (m_size > m_maxSize && m_lru.size() > 1)
+    {
+        Entry& e = m_lru.back();
+        FileUtils::deleteFile(e.path);
+        m_size -= e.size;
+        m_entries.erase(e.path);
+        m_lru.pop_back();
+    }
+}
+
+
+void EptCache::write(const std::string& path, const char *data, size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (touch(path))
+            return;
+    }
+
+    const std::string dir(FileUtils::getDirectory(path));
+    if (!FileUtils::directoryExists(dir))
+        FileUtils::createDirectories(dir);
+
+    // Write to a temporary file and rename it so that no one sees a
+    // partial entry.
+    std::ostringstream tempName;
+    tempName << path << TempSuffix <<
+        std::hash<std::thread::id>()(std::this_thread::get_id());
+    const std::string temp(tempName.str());
+    {
+        std::ofstream out(temp, std::ios::out | std::ios::binary);
+        out.write(data, size);
+        if (!out)
+        {
+            out.close();
+            FileUtils::deleteFile(temp);
+            return;
+        }
+    }
+    FileUtils::renameFile(path, temp);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (touch(path))
+        return;
+    m_lru.push_front({ path, size });
+    m_entries[path] = m_lru.begin();
+    m_size += size;
+    evict();
+}
+
+
+EptCache::JsonPtr EptCache::hierarchy(const std::string& dataset,
+    const std::string& name)
+{
+    const std::string p(path(dataset, name));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find_if(m_json.begin(), m_json.end(),
+            [&p](const std::pair<std::string, JsonPtr>& e)
+            { return e.first == p; });
+        if (it != m_json.end())
+        {
+            m_json.splice(m_json.begin(), m_json, it);
+            touch(p);
+            return it->second;
+        }
+    }
+
+    std::vector<char> text;
+    if (!data(dataset, name, text))
+        return JsonPtr();
+
+    JsonPtr json;
+    try
+    {
+        json.reset(new NL::json(NL::json::parse(text.begin(), text.end())));
+    }
+    catch (NL::json::parse_error&)
+    {
+        return JsonPtr();
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_json.emplace_front(p, json);
+    if (m_json.size() > MaxJsonEntries)
+        m_json.pop_back();
+    return json;
+}
+
+
+void EptCache::putHierarchy(const std::string& dataset,
+    const std::string& name, const std::string& text, JsonPtr json)
+{
+    const std::string p(path(dataset, name));
+    write(p, text.data(), text.size());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_json.emplace_front(p, json);
+    if (m_json.size() > MaxJsonEntries)
+        m_json.pop_back();
+}
+
+
+bool EptCache::data(const std::string& dataset, const std::string& name,
+    std::vector<char>& data)
+{
+    const std::string p(path(dataset, name));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!touch(p))
+            return false;
+    }
+
+    std::ifstream in(p, std::ios::in | std::ios::binary | std::ios::ate);
+    if (in)
+    {
+        data.resize(static_cast<size_t>(in.tellg()));
+        in.seekg(0);
+        in.read(data.data(), data.size());
+        if (in)
+            return true;
+    }
+
+    // The file was removed out from under us.
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_entries.find(p);
+    if (it != m_entries.end())
+    {
+        m_size -= it->second->size;
+        m_lru.erase(it->second);
+        m_entries.erase(it);
+    }
+    return false;
+}
+
+
+void EptCache::putData(const std::string& dataset, const std::string& name,
+    const char *data, size_t size)
+{
+    write(path(dataset, name), data, size);
+}
+
+} // namespace pdal
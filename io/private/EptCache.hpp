@@ -0,0 +1,114 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <pdal/pdal_internal.hpp>
+
+namespace pdal
+{
+
+// A size-bounded cache of EPT hierarchy files and decoded node data in a
+// local directory.  Entries for a dataset are stored in a subdirectory
+// named for a hash of the dataset's location and the content of its
+// ept.json, so a changed dataset never sees stale entries.  When the
+// cache grows past its size limit, the least recently used entries are
+// removed.  Entries found in the directory when the cache is opened are
+// ordered by modification time.
+//
+// Caches are shared by all readers in a process that use the same
+// directory.  All functions are thread-safe.
+class PDAL_DLL EptCache
+{
+public:
+    using JsonPtr = std::shared_ptr<const NL::json>;
+
+    // Get the cache for 'dir', creating the directory if necessary.
+    static std::shared_ptr<EptCache> open(const std::string& dir,
+        uint64_t maxSize);
+
+    // Name of the subdirectory for a dataset.
+    static std::string datasetId(const std::string& root,
+        const std::string& info);
+
+    // Get a cached hierarchy file.  Returns null if it isn't cached.
+    JsonPtr hierarchy(const std::string& dataset, const std::string& name);
+    void putHierarchy(const std::string& dataset, const std::string& name,
+        const std::string& text, JsonPtr json);
+
+    // Get cached node data.  Returns false if it isn't cached.
+    bool data(const std::string& dataset, const std::string& name,
+        std::vector<char>& data);
+    void putData(const std::string& dataset, const std::string& name,
+        const char *data, size_t size);
+
+    void setMaxSize(uint64_t maxSize);
+
+private:
+    struct Entry
+    {
+        std::string path;
+        uint64_t size;
+    };
+    using EntryList = std::list<Entry>;
+
+    EptCache(const std::string& dir, uint64_t maxSize);
+
+    void scan();
+    std::string path(const std::string& dataset,
+        const std::string& name) const;
+    bool touch(const std::string& path);
+    void write(const std::string& path, const char *data, size_t size);
+    void evict();
+
+    std::string m_dir;
+    uint64_t m_maxSize;
+    uint64_t m_size;
+    std::mutex m_mutex;
+
+    // Most recently used entries are at the front.
+    EntryList m_lru;
+    std::map<std::string, EntryList::iterator> m_entries;
+
+    // Recently used hierarchy files, already parsed.
+    std::list<std::pair<std::string, JsonPtr>> m_json;
+};
+
+} // namespace pdal
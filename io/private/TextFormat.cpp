@@ -0,0 +1,126 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include "TextFormat.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace pdal
+{
+namespace text
+{
+
+namespace
+{
+
+const double s_pow10[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Scaled values must stay well below 2^53 so that the rounding error of
+// the scaling multiply is a small fraction of a unit.
+const double s_maxScaled = 1099511627776.0; // 2^40
+
+void appendSlow(std::string& out, double v, size_t precision)
+{
+    char buf[64];
+    int len = snprintf(buf, sizeof(buf), "%.*f", (int)precision, v);
+    if (len >= 0 && (size_t)len < sizeof(buf))
+    {
+        out.append(buf, len);
+        return;
+    }
+
+    // Very large values or precisions.
+    std::string s(len + 1, '\0');
+    snprintf(&s[0], s.size(), "%.*f", (int)precision, v);
+    s.resize(len);
+    out += s;
+}
+
+} // unnamed namespace
+
+
+void appendFixed(std::string& out, double v, size_t precision)
+{
+    if (precision >= sizeof(s_pow10) / sizeof(s_pow10[0]) ||
+        !std::isfinite(v))
+    {
+        appendSlow(out, v, precision);
+        return;
+    }
+
+    const bool negative = std::signbit(v);
+    const double scaled = std::fabs(v) * s_pow10[precision];
+    if (!(scaled < s_maxScaled))
+    {
+        appendSlow(out, v, precision);
+        return;
+    }
+
+    // The multiply rounds, so the exact product can lie on the other side
+    // of a halfway point than 'scaled' does.  Those values (and exact
+    // ties, which printf rounds to even) go the slow way.
+    double whole = std::floor(scaled);
+    const double frac = scaled - whole;
+    if (std::fabs(frac - .5) < 1e-3)
+    {
+        appendSlow(out, v, precision);
+        return;
+    }
+    if (frac > .5)
+        whole += 1;
+    uint64_t digits = (uint64_t)whole;
+
+    char buf[32];
+    char *end = buf + sizeof(buf);
+    char *p = end;
+    for (size_t i = 0; i < precision; ++i)
+    {
+        *--p = (char)('0' + digits % 10);
+        digits /= 10;
+    }
+    if (precision)
+        *--p = '.';
+    do
+    {
+        *--p = (char)('0' + digits % 10);
+        digits /= 10;
+    } while (digits);
+    if (negative)
+        *--p = '-';
+    out.append(p, end);
+}
+
+} // namespace text
+} // namespace pdal
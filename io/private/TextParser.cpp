@@ -0,0 +1,369 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+#include <pdal/private/ThreadRange.hpp>
+#include <pdal/util/Utils.hpp>
+
+#include "TextParser.hpp"
+
+namespace pdal
+{
+namespace text
+{
+
+LineReader::LineReader(std::istream& in, size_t blockSize) :
+    m_in(in), m_blockSize(blockSize), m_buf(blockSize), m_pos(0), m_end(0),
+    m_eof(false)
+{}
+
+
+// Move unconsumed data to the front of the buffer (growing the buffer if
+// it's full) and read more behind it.
+bool LineReader::fill()
+{
+    if (m_eof)
+        return false;
+
+    if (m_pos)
+    {
+        std::memmove(m_buf.data(), m_buf.data() + m_pos, m_end - m_pos);
+        m_end -= m_pos;
+        m_pos = 0;
+    }
+    if (m_end == m_buf.size())
+        m_buf.resize(m_buf.size() * 2);
+
+    m_in.read(m_buf.data() + m_end, m_buf.size() - m_end);
+    size_t count = (size_t)m_in.gcount();
+    m_end += count;
+    if (count == 0)
+        m_eof = true;
+    return count != 0;
+}
+
+
+bool LineReader::line(const char*& begin, const char*& end)
+{
+    size_t searched = 0;
+    while (true)
+    {
+        const char *start = m_buf.data() + m_pos;
+        const char *nl = (const char *)std::memchr(start + searched, '\n',
+            m_end - m_pos - searched);
+        if (nl)
+        {
+            begin = start;
+            end = nl;
+            m_pos = nl - m_buf.data() + 1;
+            break;
+        }
+        searched = m_end - m_pos;
+        if (!fill())
+        {
+            // Last line without a terminator.
+            if (m_pos == m_end)
+                return false;
+            begin = m_buf.data() + m_pos;
+            end = m_buf.data() + m_end;
+            m_pos = m_end;
+            break;
+        }
+    }
+    if (end != begin && *(end - 1) == '\r')
+        end--;
+    return true;
+}
+
+
+bool LineReader::block(const char*& begin, const char*& end)
+{
+    while (m_end - m_pos < m_blockSize && fill())
+        ;
+
+    while (true)
+    {
+        const char *start = m_buf.data() + m_pos;
+        const char *last = m_buf.data() + m_end;
+        while (last != start && *(last - 1) != '\n')
+            last--;
+        if (last != start)
+        {
+            begin = start;
+            end = last;
+            m_pos = last - m_buf.data();
+            return true;
+        }
+        // No complete line in the buffer.
+        if (!fill())
+        {
+            if (m_pos == m_end)
+                return false;
+            begin = m_buf.data() + m_pos;
+            end = m_buf.data() + m_end;
+            m_pos = m_end;
+            return true;
+        }
+    }
+}
+
+
+const std::vector<Field>& Tokenizer::split(const char *begin,
+    const char *end)
+{
+    m_fields.clear();
+    if (m_separator == ' ')
+    {
+        const char *p = begin;
+        while (p != end)
+        {
+            while (p != end && *p == ' ')
+                p++;
+            if (p == end)
+                break;
+            const char *start = p;
+            while (p != end && *p != ' ')
+                p++;
+            m_fields.push_back({ start, p });
+        }
+    }
+    else
+    {
+        // A line of nothing but spaces has no fields.
+        if (std::all_of(begin, end, [](char c){ return c == ' '; }))
+            return m_fields;
+
+        const char *start = begin;
+        for (const char *p = begin; p != end; ++p)
+            if (*p == m_separator)
+            {
+                m_fields.push_back({ start, p });
+                start = p + 1;
+            }
+        m_fields.push_back({ start, end });
+    }
+    return m_fields;
+}
+
+
+std::string fieldString(const Field& field)
+{
+    std::string s;
+    for (const char *p = field.begin; p != field.end; ++p)
+        if (*p != ' ')
+            s += *p;
+    return s;
+}
+
+
+namespace
+{
+
+const double powersOf10[] =
+{
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+inline bool isSpace(char c)
+{
+    return std::isspace((unsigned char)c);
+}
+
+// Convert a plain decimal number whose result is exactly representable
+// by a single multiplication or division of exact doubles (mantissa no
+// larger than 2^53 and a power of ten no larger than 10^22), which gives
+// a correctly rounded result.  Anything else is left to the caller.
+bool fastParse(const char *p, const char *end, double& d)
+{
+    while (p != end && isSpace(*p))
+        p++;
+
+    bool negative = false;
+    if (p != end && (*p == '-' || *p == '+'))
+        negative = (*p++ == '-');
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int significant = 0;
+    int exponent = 0;
+    for (; p != end && isDigit(*p); ++p, ++digits)
+    {
+        if (significant || *p != '0')
+        {
+            if (++significant > 19)
+                return false;
+            mantissa = mantissa * 10 + (*p - '0');
+        }
+    }
+    if (p != end && *p == '.')
+    {
+        for (++p; p != end && isDigit(*p); ++p, ++digits)
+        {
+            if (significant || *p != '0')
+            {
+                if (++significant > 19)
+                    return false;
+                mantissa = mantissa * 10 + (*p - '0');
+            }
+            exponent--;
+        }
+    }
+    if (digits == 0)
+        return false;
+
+    if (p != end && (*p == 'e' || *p == 'E'))
+    {
+        p++;
+        bool negExp = false;
+        if (p != end && (*p == '-' || *p == '+'))
+            negExp = (*p++ == '-');
+        if (p == end || !isDigit(*p))
+            return false;
+        int e = 0;
+        for (; p != end && isDigit(*p); ++p)
+        {
+            e = e * 10 + (*p - '0');
+            if (e > 1000)
+                return false;
+        }
+        exponent += negExp ? -e : e;
+    }
+
+    while (p != end && isSpace(*p))
+        p++;
+    if (p != end)
+        return false;
+
+    if (mantissa == 0)
+    {
+        d = negative ? -0.0 : 0.0;
+        return true;
+    }
+    if (mantissa > (uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+        return false;
+
+    d = (double)mantissa;
+    if (exponent < 0)
+        d /= powersOf10[-exponent];
+    else
+        d *= powersOf10[exponent];
+    if (negative)
+        d = -d;
+    return true;
+}
+
+void parseBlock(const char *begin, const char *end, char separator,
+    size_t numFields, Block& block)
+{
+    Tokenizer tokenizer(separator);
+    block.values.clear();
+    block.errors.clear();
+    block.lines = 0;
+
+    const char *pos = begin;
+    while (pos != end)
+    {
+        const char *nl = (const char *)std::memchr(pos, '\n', end - pos);
+        const char *lineEnd = nl ? nl : end;
+        const char *next = nl ? nl + 1 : end;
+        if (lineEnd != pos && *(lineEnd - 1) == '\r')
+            lineEnd--;
+
+        size_t line = block.lines++;
+        if (lineEnd != pos)
+        {
+            const std::vector<Field>& fields = tokenizer.split(pos, lineEnd);
+            if (fields.size() != numFields)
+                block.errors.push_back({ line, fields.size(), "" });
+            else
+            {
+                for (const Field& f : fields)
+                {
+                    double d;
+                    if (!parseDouble(f, d))
+                    {
+                        block.errors.push_back(
+                            { line, fields.size(), fieldString(f) });
+                        d = 0;
+                    }
+                    block.values.push_back(d);
+                }
+            }
+        }
+        pos = next;
+    }
+}
+
+} // unnamed namespace
+
+
+bool parseDouble(const Field& field, double& d)
+{
+    if (fastParse(field.begin, field.end, d))
+        return true;
+    return Utils::fromString(fieldString(field), d);
+}
+
+
+void parseLines(const char *begin, const char *end, char separator,
+    size_t numFields, int threads, std::vector<Block>& blocks)
+{
+    // Split on line boundaries.
+    size_t count = (size_t)(std::max)(threads, 1);
+    std::vector<const char *> bounds { begin };
+    for (size_t i = 1; i < count; ++i)
+    {
+        const char *p = begin + (end - begin) * i / count;
+        p = (std::max)(p, bounds.back());
+        const char *nl = (const char *)std::memchr(p, '\n', end - p);
+        bounds.push_back(nl ? nl + 1 : end);
+    }
+    bounds.push_back(end);
+
+    blocks.resize(count);
+    forEachRange(count, threads, [&](PointId first, PointId last)
+    {
+        for (PointId i = first; i < last; ++i)
+            parseBlock(bounds[i], bounds[i + 1], separator, numFields,
+                blocks[i]);
+    });
+}
+
+} // namespace text
+} // namespace pdal
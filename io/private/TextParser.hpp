@@ -0,0 +1,121 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <pdal/pdal_internal.hpp>
+
+namespace pdal
+{
+namespace text
+{
+
+// Reads a stream in large blocks and hands out complete lines as ranges
+// in its buffer.  Ranges are valid until the next call.
+class PDAL_DLL LineReader
+{
+public:
+    LineReader(std::istream& in, size_t blockSize = 4 << 20);
+
+    // Get the next line, without its terminator ("\n" or "\r\n").
+    // Returns false at the end of input.
+    bool line(const char*& begin, const char*& end);
+
+    // Get a run of complete lines of roughly the block size (less at the
+    // end of input).  Returns false at the end of input.
+    bool block(const char*& begin, const char*& end);
+
+private:
+    bool fill();
+
+    std::istream& m_in;
+    size_t m_blockSize;
+    std::vector<char> m_buf;
+    size_t m_pos;
+    size_t m_end;
+    bool m_eof;
+};
+
+struct Field
+{
+    const char *begin;
+    const char *end;
+};
+
+// Splits a line into fields.  A space separator splits on runs of spaces.
+// Any other separator splits on each occurrence, and spaces are ignored.
+class PDAL_DLL Tokenizer
+{
+public:
+    Tokenizer(char separator) : m_separator(separator)
+    {}
+
+    const std::vector<Field>& split(const char *begin, const char *end);
+
+private:
+    char m_separator;
+    std::vector<Field> m_fields;
+};
+
+// Convert a field to a double.  Accepts what Utils::fromString() accepts;
+// plain decimal numbers are converted without allocating.
+PDAL_DLL bool parseDouble(const Field& field, double& d);
+
+// The field as reported in messages (spaces removed).
+PDAL_DLL std::string fieldString(const Field& field);
+
+struct LineError
+{
+    size_t line;         // Zero-based index of the line in its block.
+    size_t fieldCount;   // Number of fields found on the line.
+    std::string field;   // Field that couldn't be converted, if any.
+};
+
+struct Block
+{
+    std::vector<double> values;      // Values of each accepted line.
+    std::vector<LineError> errors;
+    size_t lines;                    // Number of lines, including empty.
+};
+
+// Parse the lines in [begin, end) into rows of 'numFields' values.  The
+// range is split into up to 'threads' newline-aligned blocks that are
+// parsed concurrently.  Empty lines are skipped.  Lines with the wrong
+// number of fields are skipped and reported.  Fields that can't be
+// converted are set to 0 and reported.
+PDAL_DLL void parseLines(const char *begin, const char *end, char separator,
+    size_t numFields, int threads, std::vector<Block>& blocks);
+
+} // namespace text
+} // namespace pdal
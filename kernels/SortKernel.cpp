@@ -54,7 +54,8 @@ std::string SortKernel::getName() const
 }
 
 
-SortKernel::SortKernel() : m_bCompress(false), m_bForwardMetadata(false)
+SortKernel::SortKernel() : m_bCompress(false), m_bForwardMetadata(false),
+    m_bufferSize(1024)
 {}
 
 
@@ -67,20 +68,45 @@ void SortKernel::addSwitches(ProgramArgs& args)
     args.add("metadata,m",
         "Forward metadata (VLRs, header entries, etc) from previous stages",
         m_bForwardMetadata);
+    args.add("dimension", "Sort by this dimension instead of XY Morton order",
+        m_dimension);
+    args.add("order", "Sort order ASC(ending) or DESC(ending), with "
+        "'dimension'", m_order, "ASC");
+    args.add("buffer_size", "Megabytes of points to sort in memory before "
+        "spilling to temporary files, with 'dimension'", m_bufferSize,
+        (uint64_t)1024);
 }
 
 
 int SortKernel::execute()
 {
     Stage& readerStage = makeReader(m_inputFile, m_driverOverride);
-    Stage& sortStage = makeFilter("filters.mortonorder", readerStage);
+    Stage *sortStage;
+    if (m_dimension.empty())
+        sortStage = &makeFilter("filters.mortonorder", readerStage);
+    else
+    {
+        Options sortOptions;
+        sortOptions.add("dimension", m_dimension);
+        sortOptions.add("order", m_order);
+        sortOptions.add("buffer_size", m_bufferSize);
+        sortStage = &makeFilter("filters.sort", readerStage, sortOptions);
+    }
 
     Options writerOptions;
     if (m_bCompress)
         writerOptions.add("compression", true);
     if (m_bForwardMetadata)
         writerOptions.add("forward_metadata", true);
-    Stage& writer = makeWriter(m_outputFile, sortStage, "", writerOptions);
+    Stage& writer = makeWriter(m_outputFile, *sortStage, "", writerOptions);
+
+    // Sorting on a dimension can be done out of core if the reader and
+    // writer can stream.
+    if (m_dimension.size())
+    {
+        m_manager.execute(ExecMode::PreferStream);
+        return 0;
+    }
 
     PointTable table;
     writer.prepare(table);
@@ -53,6 +53,9 @@ private:
     std::string m_outputFile;
     bool m_bCompress;
     bool m_bForwardMetadata;
+    std::string m_dimension;
+    std::string m_order;
+    uint64_t m_bufferSize;
 };
 
 } // namespace pdal
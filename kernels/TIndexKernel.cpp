@@ -34,7 +34,12 @@
 
 #include "TIndexKernel.hpp"
 
+#include <atomic>
+#include <condition_variable>
+#include <exception>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include <pdal/GDALUtils.hpp>
@@ -57,6 +62,29 @@ void setDate(OGRFeatureH feature, const tm& tyme, int fieldNumber)
 }
 
 
+// Seconds since the epoch of a UTC date and time.
+int64_t epochSeconds(int year, int month, int day, int hour, int minute,
+    int second)
+{
+    // Days since 1970-01-01 in the proleptic Gregorian calendar.
+    const int64_t y = year - (month <= 2);
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const int64_t yoe = y - era * 400;
+    const int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 +
+        day - 1;
+    const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    const int64_t days = era * 146097 + doe - 719468;
+    return days * 86400 + hour * 3600 + minute * 60 + second;
+}
+
+
+int64_t epochSeconds(const tm& tyme)
+{
+    return epochSeconds(tyme.tm_year + 1900, tyme.tm_mon + 1, tyme.tm_mday,
+        tyme.tm_hour, tyme.tm_min, tyme.tm_sec);
+}
+
+
 } // anonymous namespace
 
 
@@ -114,6 +142,8 @@ void TIndexKernel::addSubSwitches(ProgramArgs& args,
             "Write absolute rather than relative file paths", m_absPath);
         args.add("stdin,s", "Read filespec pattern from standard input",
             m_usestdin);
+        args.add("threads", "Number of files to process concurrently",
+            m_threads, (size_t)4);
     }
     else if (subcommand == "merge")
     {
@@ -193,34 +223,95 @@ StringList readSTDIN()
 }
 
 
-bool TIndexKernel::isFileIndexed(const FieldIndexes& indexes,
-    const FileInfo& fileInfo)
+std::map<std::string, TIndexKernel::IndexedFile>
+TIndexKernel::getIndexedFiles(const FieldIndexes& indexes)
 {
-    std::ostringstream qstring;
+    std::map<std::string, IndexedFile> files;
 
-    qstring << Utils::toupper(m_tileIndexColumnName) << "=" <<
-        "'" << fileInfo.m_filename << "'";
-    std::string query = qstring.str();
-    OGRErr err = OGR_L_SetAttributeFilter(m_layer, query.c_str());
-    if (err != OGRERR_NONE)
+    bool mtimeIsDate(false);
+    if (indexes.m_mtime >= 0)
     {
-        std::ostringstream oss;
-        oss << "Unable to set attribute filter for file '" <<
-             fileInfo.m_filename << "'";
-        throw pdal_error(oss.str());
+        OGRFieldDefnH defn = OGR_FD_GetFieldDefn(
+            OGR_L_GetLayerDefn(m_layer), indexes.m_mtime);
+        mtimeIsDate = (OGR_Fld_GetType(defn) == OFTDate);
     }
 
-    bool output(false);
     OGR_L_ResetReading(m_layer);
-    auto hFeat = OGR_L_GetNextFeature(m_layer);
-    if( hFeat )
+    while (true)
     {
-        OGR_F_Destroy(hFeat);
-        output = true;
+        OGRFeatureH feature = OGR_L_GetNextFeature(m_layer);
+        if (!feature)
+            break;
+
+        IndexedFile f;
+        f.m_fid = OGR_F_GetFID(feature);
+        f.m_mtimePrecision = IndexedFile::Precision::None;
+        if (indexes.m_mtimeSeconds >= 0 &&
+            OGR_F_IsFieldSet(feature, indexes.m_mtimeSeconds))
+        {
+            f.m_mtime = OGR_F_GetFieldAsInteger64(feature,
+                indexes.m_mtimeSeconds);
+            f.m_mtimePrecision = IndexedFile::Precision::Second;
+        }
+        else if (indexes.m_mtime >= 0 &&
+            OGR_F_IsFieldSet(feature, indexes.m_mtime))
+        {
+            // Some drivers (notably ESRI Shapefile) store date-time fields
+            // as dates, so compare only as much as was stored.
+            int year, month, day, hour, minute, tz;
+            float second;
+            if (OGR_F_GetFieldAsDateTimeEx(feature, indexes.m_mtime, &year,
+                &month, &day, &hour, &minute, &second, &tz))
+            {
+                f.m_mtime = epochSeconds(year, month, day, hour, minute,
+                    (int)second);
+                f.m_mtimePrecision = mtimeIsDate ?
+                    IndexedFile::Precision::Day :
+                    IndexedFile::Precision::Second;
+            }
+            else
+                f.m_mtimePrecision = IndexedFile::Precision::Invalid;
+        }
+        f.m_hasSize = (indexes.m_size >= 0 &&
+            OGR_F_IsFieldSet(feature, indexes.m_size));
+        if (f.m_hasSize)
+            f.m_size = (uintmax_t)OGR_F_GetFieldAsInteger64(feature,
+                indexes.m_size);
+        files[OGR_F_GetFieldAsString(feature, indexes.m_filename)] = f;
+
+        OGR_F_Destroy(feature);
     }
     OGR_L_ResetReading(m_layer);
-    OGR_L_SetAttributeFilter(m_layer, NULL);
-    return output;
+    return files;
+}
+
+
+// A file is considered unchanged if its modification time and size match
+// those in the index.  Entries written without a modification time are
+// never replaced.
+bool TIndexKernel::isFileUnchanged(const IndexedFile& indexed,
+    const std::string& filename)
+{
+    using Precision = IndexedFile::Precision;
+
+    if (indexed.m_mtimePrecision == Precision::None)
+        return true;
+    if (indexed.m_mtimePrecision == Precision::Invalid)
+        return false;
+
+    struct tm tyme;
+    FileUtils::fileTimes(filename, nullptr, &tyme);
+    int64_t mtime = epochSeconds(tyme);
+    int64_t indexedMtime = indexed.m_mtime;
+    if (indexed.m_mtimePrecision == Precision::Day)
+    {
+        mtime -= mtime % 86400;
+        indexedMtime -= indexedMtime % 86400;
+    }
+    if (mtime != indexedMtime)
+        return false;
+    return !indexed.m_hasSize ||
+        indexed.m_size == FileUtils::fileSize(filename);
 }
 
 
@@ -268,28 +359,123 @@ void TIndexKernel::createFile()
         }
 
     FieldIndexes indexes = getFields();
+    std::map<std::string, IndexedFile> indexed = getIndexedFiles(indexes);
+
+    // Files that need their boundary computed.  Workers fill in the info
+    // and this thread writes the features, in file order, since OGR
+    // layers can't be written from several threads.
+    struct Task
+    {
+        std::string m_filename;
+        long long m_fid;
+        FileInfo m_info;
+        bool m_valid;
+        bool m_done;
+        std::exception_ptr m_error;
+    };
+    std::vector<Task> tasks;
 
     size_t filecount(0);
-    StageFactory factory(false);
     for (auto f : m_files)
     {
         //ABELL - Not sure why we need to get absolute path here.
         f = FileUtils::toAbsolutePath(f);
-        FileInfo info;
-        if (getFileInfo(factory, f, info))
+        Task t;
+        t.m_filename = f;
+        t.m_fid = OGRNullFID;
+        t.m_valid = false;
+        t.m_done = false;
+
+        auto it = indexed.find(f);
+        if (it != indexed.end())
+        {
+            if (isFileUnchanged(it->second, f))
+            {
+                filecount++;
+                m_log->get(LogLevel::Debug) << "Skipping unchanged file " <<
+                    f << std::endl;
+                continue;
+            }
+            t.m_fid = it->second.m_fid;
+        }
+        tasks.push_back(t);
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<size_t> next(0);
+    std::atomic<bool> stop(false);
+    auto work = [&]()
+    {
+        StageFactory factory(false);
+        size_t i;
+        while (!stop && (i = next++) < tasks.size())
         {
+            Task& t = tasks[i];
+            bool valid(false);
+            std::exception_ptr error;
+            try
+            {
+                valid = getFileInfo(factory, t.m_filename, t.m_info);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            t.m_valid = valid;
+            t.m_error = error;
+            t.m_done = true;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    const size_t threads =
+        (std::min)((std::max)(m_threads, (size_t)1), tasks.size());
+    for (size_t i = 0; i < threads; ++i)
+        workers.emplace_back(work);
+
+    try
+    {
+        for (Task& t : tasks)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [&t]{ return t.m_done; });
+            }
+            if (t.m_error)
+                std::rethrow_exception(t.m_error);
+            if (!t.m_valid)
+                continue;
+
             filecount++;
-            if (!isFileIndexed(indexes, info))
+            if (t.m_fid != OGRNullFID)
             {
-                if (createFeature(indexes, info))
-                    m_log->get(LogLevel::Info) << "Indexed file " << f <<
-                    std::endl;
-                else
-                    m_log->get(LogLevel::Error) << "Failed to create feature "
-                        "for file '" << f << "'" << std::endl;
+                if (OGR_L_DeleteFeature(m_layer, t.m_fid) != OGRERR_NONE)
+                    m_log->get(LogLevel::Warning) << "Unable to remove "
+                        "previous entry for changed file '" << t.m_filename <<
+                        "'" << std::endl;
             }
+            if (createFeature(indexes, t.m_info))
+                m_log->get(LogLevel::Info) << "Indexed file " <<
+                    t.m_filename << std::endl;
+            else
+                m_log->get(LogLevel::Error) << "Failed to create feature "
+                    "for file '" << t.m_filename << "'" << std::endl;
         }
     }
+    catch (...)
+    {
+        stop = true;
+        for (std::thread& w : workers)
+            w.join();
+        throw;
+    }
+    for (std::thread& w : workers)
+        w.join();
+
     if (!filecount)
         throw pdal_error("Couldn't index any files.");
     OGR_DS_Destroy(m_dataset);
@@ -426,6 +612,16 @@ bool TIndexKernel::createFeature(const FieldIndexes& indexes,
     // Set the file mod time into the feature.
     setDate(hFeature, fileInfo.m_mtime, indexes.m_mtime);
 
+    // Set the file mod time in seconds and the file size into the
+    // feature.  Indexes created before these were recorded don't have
+    // the fields.
+    if (indexes.m_mtimeSeconds >= 0)
+        OGR_F_SetFieldInteger64(hFeature, indexes.m_mtimeSeconds,
+            (GIntBig)epochSeconds(fileInfo.m_mtime));
+    if (indexes.m_size >= 0)
+        OGR_F_SetFieldInteger64(hFeature, indexes.m_size,
+            (GIntBig)fileInfo.m_size);
+
     // Set the filename into the feature.
     OGR_F_SetFieldString(hFeature, indexes.m_filename,
         fileInfo.m_filename.c_str());
@@ -561,6 +757,7 @@ bool TIndexKernel::getFileInfo(StageFactory& factory,
         return false;
     }
     FileUtils::fileTimes(filename, &fileInfo.m_ctime, &fileInfo.m_mtime);
+    fileInfo.m_size = FileUtils::fileSize(filename);
     fileInfo.m_filename = filename;
 
     return true;
@@ -647,6 +844,14 @@ void TIndexKernel::createFields()
     hFieldDefn = OGR_Fld_Create("created", OFTDateTime);
     OGR_L_CreateField(m_layer, hFieldDefn, TRUE);
     OGR_Fld_Destroy(hFieldDefn);
+
+    hFieldDefn = OGR_Fld_Create("mtime", OFTInteger64);
+    OGR_L_CreateField(m_layer, hFieldDefn, TRUE);
+    OGR_Fld_Destroy(hFieldDefn);
+
+    hFieldDefn = OGR_Fld_Create("size", OFTInteger64);
+    OGR_L_CreateField(m_layer, hFieldDefn, TRUE);
+    OGR_Fld_Destroy(hFieldDefn);
 }
 
 
@@ -678,6 +883,8 @@ TIndexKernel::FieldIndexes TIndexKernel::getFields()
 
     indexes.m_ctime = OGR_FD_GetFieldIndex(fDefn, "created");
     indexes.m_mtime = OGR_FD_GetFieldIndex(fDefn, "modified");
+    indexes.m_mtimeSeconds = OGR_FD_GetFieldIndex(fDefn, "mtime");
+    indexes.m_size = OGR_FD_GetFieldIndex(fDefn, "size");
 
 //     /* Load in memory existing file names in SHP */
 //     int nExistingFiles = (int)OGR_L_GetFeatureCount(m_layer, FALSE);
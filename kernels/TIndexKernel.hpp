@@ -34,6 +34,8 @@
 
 #pragma once
 
+#include <map>
+
 #include <pdal/Stage.hpp>
 #include <pdal/SubcommandKernel.hpp>
 #include <pdal/util/FileUtils.hpp>
@@ -58,6 +60,7 @@ class PDAL_DLL TIndexKernel : public SubcommandKernel
         std::string m_boundary;
         struct tm m_ctime;
         struct tm m_mtime;
+        uintmax_t m_size;
     };
 
     struct FieldIndexes
@@ -66,6 +69,27 @@ class PDAL_DLL TIndexKernel : public SubcommandKernel
         int m_srs;
         int m_ctime;
         int m_mtime;
+        int m_mtimeSeconds;
+        int m_size;
+    };
+
+    // A file already present in the index.  The modification time is in
+    // seconds since the epoch, with the precision in which it was stored.
+    struct IndexedFile
+    {
+        enum class Precision
+        {
+            None,       // No modification time was recorded.
+            Invalid,    // The recorded time couldn't be read.
+            Day,
+            Second
+        };
+
+        long long m_fid;
+        Precision m_mtimePrecision;
+        int64_t m_mtime;
+        bool m_hasSize;
+        uintmax_t m_size;
     };
 
 public:
@@ -96,7 +120,10 @@ private:
     bool fastBoundary(Stage& reader, FileInfo& fileInfo);
     bool slowBoundary(Stage& hexer, FileInfo& fileInfo);
 
-    bool isFileIndexed( const FieldIndexes& indexes, const FileInfo& fileInfo);
+    std::map<std::string, IndexedFile> getIndexedFiles(
+        const FieldIndexes& indexes);
+    bool isFileUnchanged(const IndexedFile& indexed,
+        const std::string& filename);
 
     std::string m_idxFilename;
     std::string m_filespec;
@@ -116,6 +143,7 @@ private:
     bool m_fastBoundary;
     bool m_usestdin;
     bool m_overrideASrs;
+    size_t m_threads;
 };
 
 } // namespace pdal
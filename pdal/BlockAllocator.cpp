@@ -0,0 +1,199 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <pdal/BlockAllocator.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace pdal
+{
+
+BlockAllocator::BlockAllocator(size_t maxCachedBytes, bool hugePages) :
+    m_maxCachedBytes(maxCachedBytes), m_hugePages(hugePages)
+{}
+
+
+BlockAllocator::~BlockAllocator()
+{
+    // Can't call the virtual systemRelease() from here, since a derived
+    // object is gone, so derived allocators that cache blocks should
+    // call trim() in their destructors.
+    if (m_free.size())
+        BlockAllocator::trim();
+}
+
+
+BlockAllocator& BlockAllocator::heap()
+{
+    static BlockAllocator allocator;
+
+    return allocator;
+}
+
+
+char *BlockAllocator::allocate(size_t size)
+{
+    char *block = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_free.find(size);
+        if (it != m_free.end())
+        {
+            block = it->second.back();
+            it->second.pop_back();
+            if (it->second.empty())
+                m_free.erase(it);
+            m_stats.m_bytesCached -= size;
+            m_stats.m_reuses++;
+        }
+        else
+            m_stats.m_systemAllocs++;
+        m_stats.m_bytesInUse += size;
+        m_stats.m_peakBytesInUse =
+            (std::max)(m_stats.m_peakBytesInUse, m_stats.m_bytesInUse);
+    }
+
+    if (block)
+        memset(block, 0, size);
+    else
+    {
+        try
+        {
+            block = systemAllocate(size);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.m_systemAllocs--;
+            m_stats.m_bytesInUse -= size;
+            throw;
+        }
+    }
+    return block;
+}
+
+
+void BlockAllocator::release(char *block, size_t size)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stats.m_bytesInUse -= size;
+        if (m_stats.m_bytesCached + size <= m_maxCachedBytes)
+        {
+            m_free[size].push_back(block);
+            m_stats.m_bytesCached += size;
+            return;
+        }
+    }
+    systemRelease(block, size);
+}
+
+
+void BlockAllocator::setMaxCachedBytes(size_t maxCachedBytes)
+{
+    std::vector<std::pair<size_t, char *>> excess;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxCachedBytes = maxCachedBytes;
+        while (m_stats.m_bytesCached > m_maxCachedBytes)
+        {
+            auto it = m_free.begin();
+            excess.push_back(std::make_pair(it->first, it->second.back()));
+            it->second.pop_back();
+            if (it->second.empty())
+                m_free.erase(it);
+            m_stats.m_bytesCached -= excess.back().first;
+        }
+    }
+    for (auto& b : excess)
+        systemRelease(b.second, b.first);
+}
+
+
+void BlockAllocator::trim()
+{
+    std::map<size_t, std::vector<char *>> blocks;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        blocks.swap(m_free);
+        m_stats.m_bytesCached = 0;
+    }
+    for (auto& b : blocks)
+        for (char *block : b.second)
+            systemRelease(block, b.first);
+}
+
+
+BlockAllocator::Stats BlockAllocator::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+
+char *BlockAllocator::systemAllocate(size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    // Anonymous maps are zero-filled.
+    if (m_hugePages)
+    {
+        void *p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+            throw std::bad_alloc();
+        madvise(p, size, MADV_HUGEPAGE);
+        return (char *)p;
+    }
+#endif
+    char *block = new char[size];
+    memset(block, 0, size);
+    return block;
+}
+
+
+void BlockAllocator::systemRelease(char *block, size_t size)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (m_hugePages)
+    {
+        munmap(block, size);
+        return;
+    }
+#endif
+    delete [] block;
+}
+
+} // namespace pdal
@@ -0,0 +1,154 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <pdal/pdal_internal.hpp>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace pdal
+{
+
+/**
+  Allocator for the blocks of point memory used by PointTable.
+
+  Blocks released by a table can be kept on a free list and handed to the
+  next table that asks for a block of the same size, so that processes
+  that create many tables (or tables that are cleared and reused) don't
+  repeatedly return memory to the system and allocate it again.  By
+  default no blocks are kept.  Tables that aren't given an allocator use
+  heap(), whose free list can be enabled with setMaxCachedBytes().
+
+  Where supported, blocks can be allocated as anonymous memory maps that
+  are marked as eligible for transparent huge pages.
+
+  Memory is obtained with systemAllocate() and returned with
+  systemRelease(), which can be overridden to use another source of memory,
+  such as a NUMA-local pool.  The allocator is thread-safe.
+*/
+class PDAL_DLL BlockAllocator
+{
+public:
+    struct Stats
+    {
+        Stats() : m_systemAllocs(0), m_reuses(0), m_bytesInUse(0),
+            m_peakBytesInUse(0), m_bytesCached(0)
+        {}
+
+        /// Number of blocks obtained from the system.
+        uint64_t m_systemAllocs;
+        /// Number of blocks provided from the free list.
+        uint64_t m_reuses;
+        /// Bytes in blocks currently in use by tables.
+        size_t m_bytesInUse;
+        /// Largest value of m_bytesInUse.
+        size_t m_peakBytesInUse;
+        /// Bytes in blocks on the free list.
+        size_t m_bytesCached;
+    };
+
+    /**
+      Create an allocator.
+
+      \param maxCachedBytes  Maximum number of bytes in released blocks to
+        keep for reuse.
+      \param hugePages  Whether to request transparent huge pages for
+        blocks.  Ignored where not supported.
+    */
+    BlockAllocator(size_t maxCachedBytes = 0, bool hugePages = false);
+    virtual ~BlockAllocator();
+
+    /**
+      Get a zero-filled block of memory.
+
+      \param size  Size of the block in bytes.
+      \return  Pointer to the block.
+    */
+    char *allocate(size_t size);
+
+    /**
+      Release a block obtained with allocate().
+
+      \param block  Pointer to the block.
+      \param size  Size of the block as passed to allocate().
+    */
+    void release(char *block, size_t size);
+
+    /**
+      Set the maximum number of bytes in released blocks to keep for reuse.
+      Blocks already on the free list beyond the limit are returned to the
+      system.
+
+      \param maxCachedBytes  Maximum number of bytes to keep.
+    */
+    void setMaxCachedBytes(size_t maxCachedBytes);
+
+    /**
+      Return all blocks on the free list to the system.
+    */
+    void trim();
+
+    /**
+      Get allocation statistics.
+    */
+    Stats stats() const;
+
+    /**
+      The allocator used by tables that aren't given one.
+    */
+    static BlockAllocator& heap();
+
+protected:
+    /**
+      Allocate zero-filled memory from the system.
+    */
+    virtual char *systemAllocate(size_t size);
+
+    /**
+      Return memory obtained with systemAllocate() to the system.
+    */
+    virtual void systemRelease(char *block, size_t size);
+
+private:
+    BlockAllocator(const BlockAllocator&) = delete;
+    BlockAllocator& operator=(const BlockAllocator&) = delete;
+
+    size_t m_maxCachedBytes;
+    bool m_hugePages;
+    std::map<size_t, std::vector<char *>> m_free;
+    Stats m_stats;
+    mutable std::mutex m_mutex;
+};
+
+} // namespace pdal
@@ -211,6 +211,121 @@ Eigen::Matrix3d computeCovariance(const PointView& view,
     return A * A.transpose() / (ids.size()-1);
 }
 
+Eigen::Matrix3d computeCovariance(const double *x, const double *y,
+    const double *z, point_count_t n)
+{
+    using namespace Eigen;
+
+    // Partial sums are kept in separate lanes so that the compiler can map
+    // the loops onto vector registers without reassociating the additions.
+    const size_t Lanes = 4;
+    const size_t nv = n - (n % Lanes);
+
+    double sx[Lanes] = {}, sy[Lanes] = {}, sz[Lanes] = {};
+    size_t i = 0;
+    for (; i < nv; i += Lanes)
+        for (size_t l = 0; l < Lanes; ++l)
+        {
+            sx[l] += x[i + l];
+            sy[l] += y[i + l];
+            sz[l] += z[i + l];
+        }
+    for (; i < n; ++i)
+    {
+        sx[0] += x[i];
+        sy[0] += y[i];
+        sz[0] += z[i];
+    }
+    const double mx = (sx[0] + sx[1] + sx[2] + sx[3]) / n;
+    const double my = (sy[0] + sy[1] + sy[2] + sy[3]) / n;
+    const double mz = (sz[0] + sz[1] + sz[2] + sz[3]) / n;
+
+    // Accumulate the upper triangle of the demeaned outer products.
+    double xx[Lanes] = {}, xy[Lanes] = {}, xz[Lanes] = {};
+    double yy[Lanes] = {}, yz[Lanes] = {}, zz[Lanes] = {};
+    for (i = 0; i < nv; i += Lanes)
+        for (size_t l = 0; l < Lanes; ++l)
+        {
+            const double dx = x[i + l] - mx;
+            const double dy = y[i + l] - my;
+            const double dz = z[i + l] - mz;
+            xx[l] += dx * dx;
+            xy[l] += dx * dy;
+            xz[l] += dx * dz;
+            yy[l] += dy * dy;
+            yz[l] += dy * dz;
+            zz[l] += dz * dz;
+        }
+    for (; i < n; ++i)
+    {
+        const double dx = x[i] - mx;
+        const double dy = y[i] - my;
+        const double dz = z[i] - mz;
+        xx[0] += dx * dx;
+        xy[0] += dx * dy;
+        xz[0] += dx * dz;
+        yy[0] += dy * dy;
+        yz[0] += dy * dz;
+        zz[0] += dz * dz;
+    }
+
+    auto total = [](const double *s)
+    {
+        return (s[0] + s[1]) + (s[2] + s[3]);
+    };
+
+    const double d = static_cast<double>(n - 1);
+    Matrix3d B;
+    B << total(xx), total(xy), total(xz),
+         total(xy), total(yy), total(yz),
+         total(xz), total(yz), total(zz);
+    return B / d;
+}
+
+bool computeEigen3x3(const Eigen::Matrix3d& B, Eigen::Vector3d& eigenvalues,
+    Eigen::Matrix3d& eigenvectors)
+{
+    using namespace Eigen;
+
+    // Axis-aligned neighborhoods produce diagonal matrices, for which the
+    // decomposition is exact and free of the rounding error of the analytic
+    // solution.
+    if (B(0, 1) == 0.0 && B(0, 2) == 0.0 && B(1, 2) == 0.0)
+    {
+        int order[3] = { 0, 1, 2 };
+        std::sort(order, order + 3, [&B](int a, int b)
+        {
+            return B(a, a) < B(b, b) || (B(a, a) == B(b, b) && a < b);
+        });
+
+        eigenvectors.setZero();
+        for (int i = 0; i < 3; ++i)
+        {
+            eigenvalues[i] = B(order[i], order[i]);
+            eigenvectors(order[i], i) = 1.0;
+        }
+        return eigenvalues.allFinite();
+    }
+
+    SelfAdjointEigenSolver<Matrix3d> solver;
+    solver.computeDirect(B);
+    if (solver.info() != Success)
+        return false;
+    eigenvalues = solver.eigenvalues();
+    eigenvectors = solver.eigenvectors();
+
+    // The analytic solution cannot resolve eigenvalues much smaller than
+    // the largest one, so flush those to zero (e.g. perfectly planar
+    // neighborhoods).
+    const double tolerance = eigenvalues.cwiseAbs().maxCoeff() * 16.0 *
+        std::numeric_limits<double>::epsilon();
+    for (int i = 0; i < 3; ++i)
+        if (std::fabs(eigenvalues[i]) <= tolerance)
+            eigenvalues[i] = 0.0;
+
+    return eigenvalues.allFinite() && eigenvectors.allFinite();
+}
+
 uint8_t computeRank(const PointView& view, const PointIdList& ids,
     double threshold)
 {
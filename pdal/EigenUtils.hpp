@@ -127,6 +127,49 @@ PDAL_DLL Eigen::Vector3d computeCentroid(const PointView& view,
 PDAL_DLL Eigen::Matrix3d computeCovariance(const PointView& view,
     const PointIdList& ids);
 
+/**
+  Compute the covariance matrix of a collection of points stored as
+  contiguous coordinate arrays.
+
+  This is the allocation-free counterpart of computeCovariance(view, ids),
+  intended for callers that gather neighborhood coordinates into reusable
+  buffers. Sums are accumulated in four independent lanes, which lets the
+  compiler vectorize the products while adding into each lane in order.
+
+  \param x array of X coordinates.
+  \param y array of Y coordinates.
+  \param z array of Z coordinates.
+  \param n number of points in each array.
+  \return the covariance matrix of the XYZ dimensions.
+*/
+PDAL_DLL Eigen::Matrix3d computeCovariance(const double *x, const double *y,
+    const double *z, point_count_t n);
+
+/**
+  Compute the eigen decomposition of a symmetric 3x3 matrix in closed form.
+
+  Eigenvalues are returned in increasing order, with the corresponding
+  eigenvectors stored column-wise. Diagonal matrices are decomposed exactly.
+  Otherwise the analytic solution is used and eigenvalues that fall within
+  rounding error of zero are reported as zero.
+
+  \code
+  auto B = computeCovariance(view, ids);
+
+  Eigen::Vector3d values;
+  Eigen::Matrix3d vectors;
+  if (!computeEigen3x3(B, values, vectors))
+      throw pdal_error("Cannot perform eigen decomposition.");
+  \endcode
+
+  \param B the symmetric input matrix.
+  \param eigenvalues the computed eigenvalues.
+  \param eigenvectors the computed eigenvectors.
+  \return \c true if the decomposition is valid, \c false otherwise.
+*/
+PDAL_DLL bool computeEigen3x3(const Eigen::Matrix3d& B,
+    Eigen::Vector3d& eigenvalues, Eigen::Matrix3d& eigenvectors);
+
 /**
   Compute the rank of a collection of points.
 
@@ -0,0 +1,293 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <cstring>
+#include <sstream>
+
+#include <pdal/PointRef.hpp>
+#include <pdal/PointView.hpp>
+
+namespace pdal
+{
+
+/**
+  Typed access to a dimension of points.  The offset and the stored type
+  of the dimension are resolved from the layout when the accessor is
+  created, so getting or setting a value is a load or store from the
+  point's memory plus, if the stored type isn't T, a numeric conversion.
+  Conversion failures are handled as they are by PointView and PointRef.
+
+  An accessor must only be used with points of the layout from which it
+  was created.  Adding dimensions to a layout can move the existing ones,
+  so stages should create accessors once the layout is complete, in
+  ready(), rather than in prepared(), which is called before later stages
+  add their dimensions.  As with PointView and PointRef, a dimension that
+  isn't in the layout reads as 0 and ignores values set.  Containers that
+  don't store points in the layout's format are handled through their
+  usual field access functions.
+*/
+template<typename T>
+class FieldAccessor
+{
+public:
+    FieldAccessor() : m_dim(Dimension::Id::Unknown),
+        m_type(Dimension::Type::None), m_offset(0), m_load(&loadNone),
+        m_store(&storeNone)
+    {}
+
+    /**
+      Create an accessor for a dimension.
+
+      \param layout  Layout of the points to be accessed.
+      \param dim  Dimension to access.
+    */
+    FieldAccessor(PointLayoutPtr layout, Dimension::Id dim) :
+        m_dim(dim), m_type(Dimension::Type::None), m_offset(0),
+        m_load(&loadNone), m_store(&storeNone)
+    {
+        if (dim == Dimension::Id::Unknown || !layout->hasDim(dim))
+            return;
+
+        const Dimension::Detail *d = layout->dimDetail(dim);
+        m_type = d->type();
+        m_offset = d->offset();
+        switch (m_type)
+        {
+        case Dimension::Type::Unsigned8:
+            bind<uint8_t>();
+            break;
+        case Dimension::Type::Unsigned16:
+            bind<uint16_t>();
+            break;
+        case Dimension::Type::Unsigned32:
+            bind<uint32_t>();
+            break;
+        case Dimension::Type::Unsigned64:
+            bind<uint64_t>();
+            break;
+        case Dimension::Type::Signed8:
+            bind<int8_t>();
+            break;
+        case Dimension::Type::Signed16:
+            bind<int16_t>();
+            break;
+        case Dimension::Type::Signed32:
+            bind<int32_t>();
+            break;
+        case Dimension::Type::Signed64:
+            bind<int64_t>();
+            break;
+        case Dimension::Type::Float:
+            bind<float>();
+            break;
+        case Dimension::Type::Double:
+            bind<double>();
+            break;
+        case Dimension::Type::None:
+            break;
+        }
+    }
+
+    /**
+      Determine if the accessor refers to a dimension in the layout.
+    */
+    bool valid() const
+        { return m_type != Dimension::Type::None; }
+
+    /**
+      Dimension accessed.
+    */
+    Dimension::Id id() const
+        { return m_dim; }
+
+    /**
+      Get the value of the field from point data.
+
+      \param point  Pointer to the data for a point.
+      \return  Value of the field.
+    */
+    T get(const char *point) const
+        { return m_load(point + m_offset, m_dim, m_type); }
+
+    /**
+      Set the value of the field in point data.
+
+      \param point  Pointer to the data for a point.
+      \param val  Value to set.
+      \return  \c true if the value could be converted to the stored type
+        and was set.
+    */
+    bool set(char *point, T val) const
+        { return m_store(point + m_offset, val); }
+
+    /**
+      Get the value of the field for a point in a view.
+
+      \param view  View containing the point.
+      \param idx  Index of the point in the view.
+      \return  Value of the field.
+    */
+    T get(PointView& view, PointId idx) const
+    {
+        const char *point = view.getPoint(idx);
+        return point ? get(point) : view.getFieldAs<T>(m_dim, idx);
+    }
+
+    /**
+      Set the value of the field for a point in a view.  As with
+      PointView::setField(), a point is appended if the index is the size
+      of the view, and an exception is thrown if the value can't be
+      converted.
+
+      \param view  View containing the point.
+      \param idx  Index of the point in the view.
+      \param val  Value to set.
+    */
+    void set(PointView& view, PointId idx, T val) const
+    {
+        char *point = view.getOrAddPoint(idx);
+        if (!point)
+            view.setField(m_dim, idx, val);
+        else if (!set(point, val))
+        {
+            std::ostringstream oss;
+            oss << "Unable to set data and convert as requested: ";
+            oss << Dimension::name(m_dim) << ":" << Utils::typeidName<T>() <<
+                "(" << (double)val << ") -> " <<
+                Dimension::interpretationName(m_type);
+            throw pdal_error(oss.str());
+        }
+    }
+
+    /**
+      Get the value of the field for a point.
+
+      \param point  Point reference.
+      \return  Value of the field.
+    */
+    T get(const PointRef& point) const
+        { return get(point, point.constData()); }
+
+    /**
+      Get the value of the field for a point whose data has already been
+      fetched with PointRef::constData().  Use this when reading several
+      fields of a point to fetch its data once.
+
+      \param point  Point reference.
+      \param data  Data of the point, or nullptr if not available.
+      \return  Value of the field.
+    */
+    T get(const PointRef& point, const char *data) const
+        { return data ? get(data) : point.getFieldAs<T>(m_dim); }
+
+    /**
+      Set the value of the field for a point.  As with PointRef::setField(),
+      the value is ignored if it can't be converted.
+
+      \param point  Point reference.
+      \param val  Value to set.
+    */
+    void set(PointRef& point, T val) const
+        { set(point, point.data(), val); }
+
+    /**
+      Set the value of the field for a point whose data has already been
+      fetched with PointRef::data().  Use this when writing several
+      fields of a point to fetch its data once.
+
+      \param point  Point reference.
+      \param data  Data of the point, or nullptr if not available.
+      \param val  Value to set.
+    */
+    void set(PointRef& point, char *data, T val) const
+    {
+        if (data)
+            set(data, val);
+        else
+            point.setField(m_dim, val);
+    }
+
+private:
+    typedef T (*LoadFunc)(const char *, Dimension::Id, Dimension::Type);
+    typedef bool (*StoreFunc)(char *, T);
+
+    template<typename N>
+    void bind()
+    {
+        m_load = &load<N>;
+        m_store = &store<N>;
+    }
+
+    template<typename N>
+    static T load(const char *p, Dimension::Id dim, Dimension::Type type)
+    {
+        N n;
+        T val;
+
+        std::memcpy(&n, p, sizeof(N));
+        if (!Utils::numericCast(n, val))
+        {
+            std::ostringstream oss;
+            oss << "Unable to fetch data and convert as requested: ";
+            oss << Dimension::name(dim) << ":" <<
+                Dimension::interpretationName(type) <<
+                "(" << (double)n << ") -> " << Utils::typeidName<T>();
+            throw pdal_error(oss.str());
+        }
+        return val;
+    }
+
+    template<typename N>
+    static bool store(char *p, T val)
+    {
+        N n;
+
+        if (!Utils::numericCast(val, n))
+            return false;
+        std::memcpy(p, &n, sizeof(N));
+        return true;
+    }
+
+    static T loadNone(const char *, Dimension::Id, Dimension::Type)
+        { return T(0); }
+
+    static bool storeNone(char *, T)
+        { return true; }
+
+    Dimension::Id m_dim;
+    Dimension::Type m_type;
+    size_t m_offset;
+    LoadFunc m_load;
+    StoreFunc m_store;
+};
+
+} // namespace pdal
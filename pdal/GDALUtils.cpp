@@ -38,8 +38,12 @@
 #include <pdal/util/Algorithm.hpp>
 #include <pdal/util/Utils.hpp>
 
+#include <cmath>
 #include <functional>
+#include <limits>
+#include <list>
 #include <map>
+#include <tuple>
 
 #include "GDALUtils.hpp"
 
@@ -377,6 +381,255 @@ void ErrorHandler::handle(::CPLErr level, int num, char const* msg)
 }
 
 
+/**
+  Least-recently-used cache of raster blocks, decoded to doubles.  Lookups
+  may be made from several threads.  Reads from the dataset are serialized
+  since a GDAL dataset handle can't be used concurrently.
+*/
+class RasterBlockCache
+{
+public:
+    struct Block
+    {
+        int m_width;
+        std::vector<double> m_data;
+    };
+    typedef std::shared_ptr<const Block> BlockPtr;
+
+    RasterBlockCache(size_t maxBytes) : m_maxBytes(maxBytes), m_bytes(0)
+    {}
+
+    void setMaxBytes(size_t maxBytes)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxBytes = maxBytes;
+        evict();
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_lru.clear();
+        m_index.clear();
+        m_bytes = 0;
+    }
+
+    /**
+      Get a block, reading it from the dataset if it isn't cached.
+      \param ds  Dataset.
+      \param band  Band number (1-indexed).
+      \param bx  Block column.
+      \param by  Block row.
+      \return  The block.
+    */
+    BlockPtr get(GDALDataset *ds, int band, int bx, int by)
+    {
+        const Key key(band, bx, by);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_index.find(key);
+            if (it != m_index.end())
+            {
+                m_lru.splice(m_lru.begin(), m_lru, it->second);
+                return it->second->second;
+            }
+        }
+
+        BlockPtr block = load(ds, band, bx, by);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        // Another thread may have read the block in the meantime.
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+            return it->second->second;
+        m_lru.emplace_front(key, block);
+        m_index[key] = m_lru.begin();
+        m_bytes += block->m_data.size() * sizeof(double);
+        evict();
+        return block;
+    }
+
+private:
+    typedef std::tuple<int, int, int> Key;
+    typedef std::list<std::pair<Key, BlockPtr>> List;
+
+    // The most recently used block is always kept.
+    void evict()
+    {
+        while (m_bytes > m_maxBytes && m_lru.size() > 1)
+        {
+            m_bytes -= m_lru.back().second->m_data.size() * sizeof(double);
+            m_index.erase(m_lru.back().first);
+            m_lru.pop_back();
+        }
+    }
+
+    BlockPtr load(GDALDataset *ds, int band, int bx, int by)
+    {
+        std::lock_guard<std::mutex> lock(m_ioMutex);
+
+        GDALRasterBand *b = ds->GetRasterBand(band);
+        if (!b)
+            throw InvalidBand();
+        int xBlockSize, yBlockSize;
+        b->GetBlockSize(&xBlockSize, &yBlockSize);
+        const int x = bx * xBlockSize;
+        const int y = by * yBlockSize;
+        const int width = (std::min)(xBlockSize, b->GetXSize() - x);
+        const int height = (std::min)(yBlockSize, b->GetYSize() - y);
+
+        std::shared_ptr<Block> block(new Block);
+        block->m_width = width;
+        block->m_data.resize((size_t)width * height);
+        if (GDALRasterIO(b, GF_Read, x, y, width, height,
+                block->m_data.data(), width, height, GDT_Float64,
+                0, 0) != CE_None)
+            throw CantReadBlock();
+        return block;
+    }
+
+    size_t m_maxBytes;
+    size_t m_bytes;
+    List m_lru;
+    std::map<Key, List::iterator> m_index;
+    std::mutex m_mutex;
+    std::mutex m_ioMutex;
+};
+
+namespace
+{
+
+const size_t DefaultBlockCacheSize = 256 * 1024 * 1024;
+
+// Fetches cell values of one band, holding on to the last block used.
+class PixelReader
+{
+public:
+    PixelReader(RasterBlockCache& cache, GDALDataset *ds, int band) :
+        m_cache(cache), m_ds(ds), m_band(band), m_bx(-1), m_by(-1)
+    {
+        GDALRasterBand *b = ds->GetRasterBand(band);
+        if (!b)
+            throw InvalidBand();
+        b->GetBlockSize(&m_xBlockSize, &m_yBlockSize);
+        m_width = b->GetXSize();
+        m_height = b->GetYSize();
+        int hasNoData(0);
+        m_noData = b->GetNoDataValue(&hasNoData);
+        m_hasNoData = (hasNoData != 0);
+    }
+
+    // Value of the cell at col/row.  Positions off the raster are clamped
+    // to its edge.
+    double operator()(int col, int row)
+    {
+        col = Utils::clamp(col, 0, m_width - 1);
+        row = Utils::clamp(row, 0, m_height - 1);
+        const int bx = col / m_xBlockSize;
+        const int by = row / m_yBlockSize;
+        if (bx != m_bx || by != m_by)
+        {
+            m_block = m_cache.get(m_ds, m_band, bx, by);
+            m_bx = bx;
+            m_by = by;
+        }
+        const int x = col - bx * m_xBlockSize;
+        const int y = row - by * m_yBlockSize;
+        return m_block->m_data[(size_t)y * m_block->m_width + x];
+    }
+
+    bool isNoData(double d) const
+        { return m_hasNoData && (d == m_noData ||
+            (std::isnan(d) && std::isnan(m_noData))); }
+
+    // Value at a fractional pixel/line position.  Cell centers are at
+    // half-integer positions.  Falls back to the nearest cell if any cell
+    // that contributes to the value has no data.
+    double sample(double pixel, double line, Resample method)
+    {
+        const int col = (int)std::floor(pixel);
+        const int row = (int)std::floor(line);
+        if (method == Resample::Nearest)
+            return (*this)(col, row);
+
+        const double u = pixel - .5;
+        const double v = line - .5;
+        const int c0 = (int)std::floor(u);
+        const int r0 = (int)std::floor(v);
+        const double s = u - c0;
+        const double t = v - r0;
+
+        double result(0);
+        if (method == Resample::Bilinear)
+        {
+            const double v00 = (*this)(c0, r0);
+            const double v10 = (*this)(c0 + 1, r0);
+            const double v01 = (*this)(c0, r0 + 1);
+            const double v11 = (*this)(c0 + 1, r0 + 1);
+            if (isNoData(v00) || isNoData(v10) || isNoData(v01) ||
+                    isNoData(v11))
+                return (*this)(col, row);
+            result = (1 - t) * ((1 - s) * v00 + s * v10) +
+                t * ((1 - s) * v01 + s * v11);
+        }
+        else
+        {
+            // Catmull-Rom weights for the cells at offsets -1 through 2.
+            auto weights = [](double d, double *w)
+            {
+                w[0] = ((-.5 * d + 1) * d - .5) * d;
+                w[1] = (1.5 * d - 2.5) * d * d + 1;
+                w[2] = ((-1.5 * d + 2) * d + .5) * d;
+                w[3] = (.5 * d - .5) * d * d;
+            };
+            double ws[4];
+            double wt[4];
+            weights(s, ws);
+            weights(t, wt);
+            double lo = (std::numeric_limits<double>::max)();
+            double hi = (std::numeric_limits<double>::lowest)();
+            for (int j = 0; j < 4; ++j)
+                for (int i = 0; i < 4; ++i)
+                {
+                    const double val = (*this)(c0 - 1 + i, r0 - 1 + j);
+                    if (isNoData(val))
+                        return (*this)(col, row);
+                    result += ws[i] * wt[j] * val;
+                    lo = (std::min)(lo, val);
+                    hi = (std::max)(hi, val);
+                }
+            // Don't overshoot the neighboring values, so results stay in
+            // the range of the band's type.
+            result = Utils::clamp(result, lo, hi);
+        }
+        return result;
+    }
+
+    int blockIndex(double pixel, double line) const
+    {
+        const int bx = (int)pixel / m_xBlockSize;
+        const int by = (int)line / m_yBlockSize;
+        return by * ((m_width + m_xBlockSize - 1) / m_xBlockSize) + bx;
+    }
+
+private:
+    RasterBlockCache& m_cache;
+    GDALDataset *m_ds;
+    int m_band;
+    int m_xBlockSize;
+    int m_yBlockSize;
+    int m_width;
+    int m_height;
+    double m_noData;
+    bool m_hasNoData;
+    int m_bx;
+    int m_by;
+    RasterBlockCache::BlockPtr m_block;
+};
+
+} // unnamed namespace
+
+
 /**
   Create a copy of the raster in memory.
   \return  Pointer to the new raster.
@@ -414,6 +667,7 @@ Raster::Raster(const std::string& filename, const std::string& drivername)
     , m_numBands(0)
     , m_drivername(drivername)
     , m_ds(0)
+    , m_cache(new RasterBlockCache(DefaultBlockCacheSize))
 {
     m_forwardTransform.fill(0);
     m_forwardTransform[1] = 1;
@@ -440,9 +694,25 @@ Raster::Raster(const std::string& filename, const std::string& drivername,
     , m_forwardTransform(pixelToPos)
     , m_srs(srs)
     , m_ds(0)
+    , m_cache(new RasterBlockCache(DefaultBlockCacheSize))
 {}
 
 
+/**
+  Constructor for an open dataset.
+  \param ds  GDAL dataset.
+*/
+Raster::Raster(GDALDataset *ds) : m_ds(ds),
+    m_cache(new RasterBlockCache(DefaultBlockCacheSize))
+{}
+
+
+void Raster::setBlockCacheSize(size_t bytes)
+{
+    m_cache->setMaxBytes(bytes);
+}
+
+
 /**
   Open a raster destined for output.
   \param width  Raster width.
@@ -712,6 +982,27 @@ bool Raster::getPixelAndLinePosition(double x, double y,
 }
 
 
+/**
+  Determines the fractional pixel/line position given a coordinate position.
+  \param x  X coordinate of point.
+  \param y  Y coordinate of point.
+  \param[out] pixel  Raster pixel (column) position.
+  \param[out] line  Raster line (row) position.
+*/
+bool Raster::getPixelPosition(double x, double y, double& pixel,
+    double& line)
+{
+    pixel = m_inverseTransform[0] + (m_inverseTransform[1] * x) +
+        (m_inverseTransform[2] * y);
+    line = m_inverseTransform[3] + (m_inverseTransform[4] * x) +
+        (m_inverseTransform[5] * y);
+
+    // Return false if we're out of bounds.
+    return (pixel >= 0 && pixel < m_width &&
+        line >= 0 && line < m_height);
+}
+
+
 /**
   Compute a vector of the PDAL datatypes that are stored in the raster
   bands of a dataset.
@@ -752,7 +1043,8 @@ GDALError Raster::computePDALDimensionTypes()
   \param[out] data  Vector of raster data associated with the provided point.
   \return  Error code or GDALError::None.
 */
-GDALError Raster::read(double x, double y, std::vector<double>& data)
+GDALError Raster::read(double x, double y, std::vector<double>& data,
+    Resample method)
 {
     if (!m_ds)
     {
@@ -760,31 +1052,104 @@ GDALError Raster::read(double x, double y, std::vector<double>& data)
         return GDALError::NotOpen;
     }
 
-    int32_t pixel(0);
-    int32_t line(0);
-    data.resize(m_numBands);
-
-    std::array<double, 2> pix = { {0.0, 0.0} };
-
-    // No data at this x,y if we can't compute a pixel/line location
-    // for it.
-    if (!getPixelAndLinePosition(x, y, pixel, line))
+    double pixel(0);
+    double line(0);
+    if (!getPixelPosition(x, y, pixel, line))
     {
         m_errorMsg = "Requested location is not in the raster.";
         return GDALError::NoData;
     }
 
-    for (int i=0; i < m_numBands; ++i)
+    // This is called for each point, so sample each band directly rather
+    // than through the batch read, and don't reallocate the output.
+    data.resize(m_numBands);
+    try
     {
-        GDALRasterBandH b = GDALGetRasterBand(m_ds, i + 1);
-        if (GDALRasterIO(b, GF_Read, pixel, line, 1, 1,
-            &pix[0], 1, 1, GDT_Float64, 0, 0) == CE_None)
+        for (int b = 0; b < m_numBands; ++b)
         {
-            // we read a pixel put its values in our vector
-            data[i] = pix[0];
+            PixelReader reader(*m_cache, m_ds, b + 1);
+            data[b] = reader.sample(pixel, line, method);
         }
     }
+    catch (InvalidBand)
+    {
+        m_errorMsg = "Unable to get band from raster '" + m_filename + "'.";
+        return GDALError::InvalidBand;
+    }
+    catch (CantReadBlock)
+    {
+        m_errorMsg = "Unable to read block for for raster '" +
+            m_filename + "'.";
+        return GDALError::CantReadBlock;
+    }
+    return GDALError::None;
+}
 
+
+/**
+  Fetch the raster data associated with many positions.
+  \param pos  X/Y positions to fetch raster data for.
+  \param[out] data  Raster data for each band at each position.
+  \param[out] valid  Whether each position falls in the raster.
+  \param method  Resampling method.
+  \return  Error code or GDALError::None.
+*/
+GDALError Raster::read(const std::vector<std::array<double, 2>>& pos,
+    std::vector<double>& data, std::vector<bool>& valid, Resample method)
+{
+    if (!m_ds)
+    {
+        m_errorMsg = "Raster not open.";
+        return GDALError::NotOpen;
+    }
+
+    const size_t numBands = (size_t)m_numBands;
+    data.resize(pos.size() * numBands);
+    valid.assign(pos.size(), false);
+
+    std::vector<std::array<double, 2>> pixels(pos.size());
+    for (size_t i = 0; i < pos.size(); ++i)
+        valid[i] = getPixelPosition(pos[i][0], pos[i][1],
+            pixels[i][0], pixels[i][1]);
+
+    try
+    {
+        std::vector<PixelReader> readers;
+        for (size_t b = 0; b < numBands; ++b)
+            readers.emplace_back(*m_cache, m_ds, (int)b + 1);
+
+        // Visit the positions block by block so that each block is
+        // fetched once per batch.
+        std::vector<size_t> order;
+        order.reserve(pos.size());
+        for (size_t i = 0; i < pos.size(); ++i)
+            if (valid[i])
+                order.push_back(i);
+        if (readers.size())
+        {
+            std::vector<int> blocks(pos.size());
+            for (size_t i : order)
+                blocks[i] = readers[0].blockIndex(pixels[i][0], pixels[i][1]);
+            std::stable_sort(order.begin(), order.end(),
+                [&blocks](size_t a, size_t b){ return blocks[a] < blocks[b]; });
+        }
+
+        for (size_t i : order)
+            for (size_t b = 0; b < numBands; ++b)
+                data[i * numBands + b] =
+                    readers[b].sample(pixels[i][0], pixels[i][1], method);
+    }
+    catch (InvalidBand)
+    {
+        m_errorMsg = "Unable to get band from raster '" + m_filename + "'.";
+        return GDALError::InvalidBand;
+    }
+    catch (CantReadBlock)
+    {
+        m_errorMsg = "Unable to read block for for raster '" +
+            m_filename + "'.";
+        return GDALError::CantReadBlock;
+    }
     return GDALError::None;
 }
 
@@ -820,6 +1185,7 @@ void Raster::close()
     GDALClose(m_ds);
     m_ds = nullptr;
     m_types.clear();
+    m_cache->clear();
 }
 
 
@@ -36,6 +36,7 @@
 
 #include <array>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <sstream>
 #include <vector>
@@ -551,6 +552,19 @@ private:
 };
 
 
+/*
+  Method used to compute the value of a raster at a position between
+  cell centers.
+*/
+enum class Resample
+{
+    Nearest,
+    Bilinear,
+    Cubic
+};
+
+class RasterBlockCache;
+
 class PDAL_DLL Raster
 {
 public:
@@ -589,7 +603,7 @@ public:
       \param pixelToPos  Transformation matrix to convert raster positions to
         geolocations.
     */
-    Raster(GDALDataset *ds) : m_ds (ds) {};
+    Raster(GDALDataset *ds);
 
     /**
       Return a GDAL MEM driver copy of the raster
@@ -741,12 +755,36 @@ public:
     /**
       Read the data for each band at x/y into a vector of doubles.  x and y
       are transformed to the basis of the raster before the data is fetched.
+      Raster blocks are read whole and cached, so reads of nearby positions
+      don't go back to GDAL.
 
       \param x  X position to read
       \param y  Y position to read
       \param data  Vector in which to store data.
+      \param method  Resampling method.
+    */
+    GDALError read(double x, double y, std::vector<double>& data,
+        Resample method = Resample::Nearest);
+
+    /**
+      Read the data for each band at many positions.  Positions are visited
+      in the order of the raster blocks that contain them.
+
+      \param pos  X/Y positions to read.
+      \param data  Filled with bandCount() values for each position.
+      \param valid  Set to whether each position falls in the raster.
+      \param method  Resampling method.
+    */
+    GDALError read(const std::vector<std::array<double, 2>>& pos,
+        std::vector<double>& data, std::vector<bool>& valid,
+        Resample method = Resample::Nearest);
+
+    /**
+      Set the maximum number of bytes of decoded raster blocks to cache.
+
+      \param bytes  Cache size in bytes.
     */
-    GDALError read(double x, double y, std::vector<double>& data);
+    void setBlockCacheSize(size_t bytes);
 
     /**
       Get a vector of dimensions that map to the bands of a raster.
@@ -851,10 +889,12 @@ private:
     std::string m_errorMsg;
     mutable std::vector<pdal::Dimension::Type> m_types;
     std::vector<std::array<double, 2>> m_block_sizes;
+    std::unique_ptr<RasterBlockCache> m_cache;
 
     GDALError validateType(Dimension::Type& type, GDALDriver *driver);
     bool getPixelAndLinePosition(double x, double y,
         int32_t& pixel, int32_t& line);
+    bool getPixelPosition(double x, double y, double& pixel, double& line);
     GDALError computePDALDimensionTypes();
 };
 
@@ -34,6 +34,7 @@
 
 #pragma once
 
+#include <limits>
 #include <memory>
 
 #include <nanoflann/nanoflann.hpp>
@@ -53,6 +54,35 @@ namespace nanoflann
 namespace pdal
 {
 
+// A nanoflann result set that counts the points within a radius without
+// storing them.  Once 'max' points have been counted the reported search
+// radius collapses, which prunes the remainder of the tree traversal.
+template<typename DistanceType, typename IndexType>
+class CountResultSet
+{
+public:
+    CountResultSet(DistanceType radius, std::size_t max) :
+        m_radius(radius), m_max(max), m_count(0)
+    {}
+
+    std::size_t size() const
+        { return m_count; }
+    bool full() const
+        { return true; }
+    void addPoint(DistanceType dist, IndexType)
+    {
+        if (dist < m_radius && m_count < m_max)
+            m_count++;
+    }
+    DistanceType worstDist() const
+        { return m_count < m_max ? m_radius : DistanceType(-1); }
+
+private:
+    DistanceType m_radius;
+    std::size_t m_max;
+    std::size_t m_count;
+};
+
 template<int DIM>
 class PDAL_DLL KDIndex
 {
@@ -81,8 +111,10 @@ public:
 protected:
     const PointView& m_buf;
 
+    // The dimension is fixed at compile time so that nanoflann doesn't
+    // allocate its per-query distance vector on the heap.
     typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Simple_Adaptor<
-        double, KDIndex, double>, KDIndex, -1, std::size_t> my_kd_tree_t;
+        double, KDIndex, double>, KDIndex, DIM, std::size_t> my_kd_tree_t;
 
     std::unique_ptr<my_kd_tree_t> m_index;
 
@@ -129,10 +161,8 @@ public:
 
         resultSet.init(&output[0], &out_dist_sqr[0]);
 
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
-        m_index->findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        const double pt[2] = { x, y };
+        m_index->findNeighbors(resultSet, pt, nanoflann::SearchParams(10));
         return output;
     }
 
@@ -160,10 +190,8 @@ public:
 
         resultSet.init(&indices->front(), &sqr_dists->front());
 
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
-        m_index->findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        const double pt[2] = { x, y };
+        m_index->findNeighbors(resultSet, pt, nanoflann::SearchParams(10));
     }
 
     void knnSearch(PointId idx, point_count_t k, PointIdList *indices,
@@ -316,11 +344,8 @@ public:
 
         resultSet.init(&indices->front(), &sqr_dists->front());
 
-        std::vector<double> pt;
-        pt.push_back(x);
-        pt.push_back(y);
-        pt.push_back(z);
-        m_index->findNeighbors(resultSet, &pt[0], nanoflann::SearchParams(10));
+        const double pt[3] = { x, y, z };
+        m_index->findNeighbors(resultSet, pt, nanoflann::SearchParams(10));
     }
 
     void knnSearch(PointId idx, point_count_t k, PointIdList *indices,
@@ -374,6 +399,36 @@ public:
         return radius(x, y, z, r);
     }
 
+    /**
+      Count the points within a radius of a location, without building a
+      list of them.
+
+      \param x  X coordinate of the query location.
+      \param y  Y coordinate of the query location.
+      \param z  Z coordinate of the query location.
+      \param r  Search radius.
+      \param max  Stop counting once this many points have been found.
+      \return  The number of points found, at most \a max.
+    */
+    point_count_t radiusCount(double x, double y, double z, double r,
+        point_count_t max = (std::numeric_limits<point_count_t>::max)()) const
+    {
+        CountResultSet<double, PointId> resultSet(r * r, max);
+        const double pt[3] = { x, y, z };
+        m_index->findNeighbors(resultSet, pt, nanoflann::SearchParams());
+        return resultSet.size();
+    }
+
+    point_count_t radiusCount(PointId idx, double r,
+        point_count_t max = (std::numeric_limits<point_count_t>::max)()) const
+    {
+        double x = m_buf.getFieldAs<double>(Dimension::Id::X, idx);
+        double y = m_buf.getFieldAs<double>(Dimension::Id::Y, idx);
+        double z = m_buf.getFieldAs<double>(Dimension::Id::Z, idx);
+
+        return radiusCount(x, y, z, r, max);
+    }
+
     PointIdList radius(PointRef &point, double r) const
     {
         double x = point.getFieldAs<double>(Dimension::Id::X);
@@ -34,6 +34,7 @@
 
 #include <pdal/PipelineExecutor.hpp>
 #include <pdal/PDALUtils.hpp>
+#include <pdal/Stage.hpp>
 
 namespace pdal
 {
@@ -41,6 +42,7 @@ namespace pdal
 
 PipelineExecutor::PipelineExecutor(std::string const& json)
     : m_json(json)
+    , m_read(false)
     , m_executed(false)
     , m_logLevel(pdal::LogLevel::Error)
 {
@@ -82,21 +84,49 @@ std::string PipelineExecutor::getSchema() const
 }
 
 
-bool PipelineExecutor::validate()
+void PipelineExecutor::readPipeline()
 {
+    // Stages are only created once.  Later executions reuse them.
+    if (m_read)
+        return;
+
     std::stringstream strm;
     strm << m_json;
     m_manager.readPipeline(strm);
+    m_read = true;
+}
+
+
+bool PipelineExecutor::validate()
+{
+    readPipeline();
     m_manager.prepare();
 
     return true;
 }
 
+
+void PipelineExecutor::setStageOptions(const std::string& name,
+    const Options& options)
+{
+    readPipeline();
+
+    bool found = false;
+    for (Stage *s : m_manager.stages())
+        if (s->tag() == name || s->getName() == name)
+        {
+            s->removeOptions(options);
+            s->addOptions(options);
+            found = true;
+        }
+    if (!found)
+        throw pdal_error("Pipeline has no stage '" + name + "'.");
+}
+
+
 int64_t PipelineExecutor::execute()
 {
-    std::stringstream strm;
-    strm << m_json;
-    m_manager.readPipeline(strm);
+    readPipeline();
     point_count_t count = m_manager.execute();
 
     m_executed = true;
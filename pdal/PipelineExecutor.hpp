@@ -48,7 +48,10 @@ namespace pdal
   An executor hides the management of constructing, executing, and
   fetching data from a PipelineManager.
 
-  It is constructed with JSON defining a pipeline.
+  It is constructed with JSON defining a pipeline.  The pipeline's stages
+  are created once and can be executed any number of times, with stage
+  options changed between executions using setStageOptions().  Point
+  memory is reused from one execution to the next.
 */
 
 class PDAL_DLL PipelineExecutor {
@@ -67,12 +70,23 @@ public:
     ~PipelineExecutor(){};
 
     /**
-      Execute the pipeline
+      Execute the pipeline.  If the pipeline has already been executed,
+      it's run again with the same stages.  Point views from the previous
+      execution become invalid.
 
       \return total number of points produced by the pipeline.
     */
     int64_t execute();
 
+    /**
+      Set options on stages for subsequent executions.  Options replace
+      any existing options with the same names.
+
+      \param name  Tag or name of the stages to which the options apply.
+      \param options  Options to set.
+    */
+    void setStageOptions(const std::string& name, const Options& options);
+
     /**
       Validate the pipeline
 
@@ -132,9 +146,11 @@ public:
 
 private:
     void setLogStream(std::ostream& strm);
+    void readPipeline();
 
     std::string m_json;
     pdal::PipelineManager m_manager;
+    bool m_read;
     bool m_executed;
     std::stringstream m_logStream;
     pdal::LogLevel m_logLevel;
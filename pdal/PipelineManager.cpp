@@ -35,6 +35,7 @@
 #include <pdal/PipelineManager.hpp>
 #include <pdal/StageFactory.hpp>
 #include <pdal/PipelineReaderJSON.hpp>
+#include <pdal/PipelineTemplate.hpp>
 #include <pdal/PDALUtils.hpp>
 #include <pdal/util/Algorithm.hpp>
 #include <pdal/util/FileUtils.hpp>
@@ -66,8 +67,15 @@ void PipelineManager::readPipeline(std::istream& input)
     // Read stream into string.
     std::string s(std::istreambuf_iterator<char>(input), eos);
 
-    std::istringstream ss(s);
-    PipelineReaderJSON(*this).readPipeline(ss);
+    // Pipelines are often run repeatedly, so reuse a parsed template
+    // if the same text has already been read.
+    readPipeline(*PipelineTemplate::cached(s));
+}
+
+
+void PipelineManager::readPipeline(const PipelineTemplate& t)
+{
+    PipelineReaderJSON(*this).buildPipeline(t);
 }
 
 
@@ -256,6 +264,13 @@ PipelineManager::ExecResult PipelineManager::execute(ExecMode mode)
     }
     else if (mode == ExecMode::Standard)
     {
+        // If the pipeline has already been run, reuse the stages and the
+        // table's layout and point memory.
+        if (m_table.layout()->finalized())
+        {
+            m_viewSet.clear();
+            m_tablePtr->clear();
+        }
         s->prepare(m_table);
         m_viewSet = s->execute(m_table);
         point_count_t cnt = 0;
@@ -45,6 +45,7 @@
 namespace pdal
 {
 
+class PipelineTemplate;
 struct QuickInfo;
 class Stage;
 class StageFactory;
@@ -80,8 +81,16 @@ public:
     void setProgressFd(int fd)
         { m_progressFd = fd; }
 
+    // The text of a pipeline read from a stream (or from a file without a
+    // .json extension) is kept, with the parsed pipeline, in a
+    // process-wide cache so that reading the same pipeline again is cheap
+    // (see PipelineTemplate::cached()).  Use
+    // PipelineTemplate::setCacheSize() to limit or disable the cache.
     void readPipeline(std::istream& input);
     void readPipeline(const std::string& filename);
+    // Add the stages described by a parsed pipeline.  Common and stage
+    // options set on the manager are applied as the stages are created.
+    void readPipeline(const PipelineTemplate& t);
 
     // Use these to manually add stages into the pipeline manager.
     Stage& addReader(const std::string& type);
@@ -124,6 +133,11 @@ public:
 
     QuickInfo preview() const;
     void prepare() const;
+    // A pipeline can be executed more than once.  Stages are prepared
+    // again, so options changed on them between runs take effect, but
+    // the point table's layout and memory are reused.  Changes must not
+    // add dimensions to the layout.  Views from a previous standard
+    // execution are invalid once the pipeline is executed again.
     ExecResult execute(ExecMode mode);
     point_count_t execute();
     void executeStream(StreamPointTable& table);
@@ -37,6 +37,7 @@
 #include <pdal/Filter.hpp>
 #include <pdal/PipelineReaderJSON.hpp>
 #include <pdal/PipelineManager.hpp>
+#include <pdal/PipelineTemplate.hpp>
 #include <pdal/PluginManager.hpp>
 #include <pdal/Options.hpp>
 #include <pdal/util/FileUtils.hpp>
@@ -44,6 +45,7 @@
 #include <pdal/util/Utils.hpp>
 
 #include <memory>
+#include <set>
 #include <vector>
 
 namespace pdal
@@ -54,37 +56,58 @@ PipelineReaderJSON::PipelineReaderJSON(PipelineManager& manager) :
 {}
 
 
-void PipelineReaderJSON::parsePipeline(NL::json& tree)
+void PipelineReaderJSON::parsePipeline(NL::json& tree, PipelineTemplate& t)
 {
-    TagMap tags;
-    std::vector<Stage*> inputs;
+    TagSet tags;
 
-    size_t last = tree.size() - 1;
     for (size_t i = 0; i < tree.size(); ++i)
     {
         NL::json& node = tree.at(i);
-
-        std::string filename;
-        std::string tag;
-        std::string type;
-        std::vector<Stage*> specifiedInputs;
-        Options options;
+        PipelineTemplate::StageInfo info;
 
         // strings are assumed to be filenames
         if (node.is_string())
         {
-            filename = node.get<std::string>();
+            info.m_filename = node.get<std::string>();
         }
         else
         {
-            type = extractType(node);
-            filename = extractFilename(node);
-            tag = extractTag(node, tags);
-            specifiedInputs = extractInputs(node, tags);
-            if (!specifiedInputs.empty())
-                inputs = specifiedInputs;
-            options = extractOptions(node);
+            info.m_type = extractType(node);
+            info.m_filename = extractFilename(node);
+            info.m_tag = extractTag(node, tags);
+            info.m_inputs = extractInputs(node, tags);
+            info.m_plugin = extractPlugin(node);
+            info.m_options = extractOptions(node);
         }
+        if (info.m_tag.size())
+            tags.insert(info.m_tag);
+        t.m_stages.push_back(std::move(info));
+    }
+}
+
+
+void PipelineReaderJSON::buildPipeline(const PipelineTemplate& t)
+{
+    TagMap tags;
+    std::vector<Stage*> inputs;
+
+    size_t last = t.m_stages.size() - 1;
+    for (size_t i = 0; i < t.m_stages.size(); ++i)
+    {
+        const PipelineTemplate::StageInfo& info = t.m_stages[i];
+        const std::string& type = info.m_type;
+        const std::string& filename = info.m_filename;
+        const std::string& tag = info.m_tag;
+        Options options(info.m_options);
+
+        std::vector<Stage*> specifiedInputs;
+        for (const std::string& input : info.m_inputs)
+            specifiedInputs.push_back(tags.at(input));
+        if (!specifiedInputs.empty())
+            inputs = specifiedInputs;
+
+        if (info.m_plugin.size())
+            PluginManager<Stage>::loadPlugin(info.m_plugin);
 
         Stage *s = nullptr;
 
@@ -136,7 +159,7 @@ void PipelineReaderJSON::parsePipeline(NL::json& tree)
 }
 
 
-void PipelineReaderJSON::readPipeline(std::istream& input)
+void PipelineReaderJSON::readPipeline(std::istream& input, PipelineTemplate& t)
 {
     NL::json root;
 
@@ -157,14 +180,20 @@ void PipelineReaderJSON::readPipeline(std::istream& input)
 
     auto it = root.find("pipeline");
     if (root.is_object() && it != root.end())
-        parsePipeline(*it);
+        parsePipeline(*it, t);
     else if (root.is_array())
-        parsePipeline(root);
+        parsePipeline(root, t);
     else
         throw pdal_error("Pipeline: root element is not a pipeline.");
 }
 
 
+void PipelineReaderJSON::readPipeline(std::istream& input)
+{
+    buildPipeline(PipelineTemplate(input));
+}
+
+
 void PipelineReaderJSON::readPipeline(const std::string& filename)
 {
     std::istream* input = Utils::openFile(filename);
@@ -232,7 +261,7 @@ std::string PipelineReaderJSON::extractFilename(NL::json& node)
 }
 
 
-std::string PipelineReaderJSON::extractTag(NL::json& node, TagMap& tags)
+std::string PipelineReaderJSON::extractTag(NL::json& node, const TagSet& tags)
 {
     std::string tag;
 
@@ -265,22 +294,20 @@ std::string PipelineReaderJSON::extractTag(NL::json& node, TagMap& tags)
 
 
 void PipelineReaderJSON::handleInputTag(const std::string& tag,
-    const TagMap& tags, std::vector<Stage *>& inputs)
+    const TagSet& tags, StringList& inputs)
 {
-    auto ii = tags.find(tag);
-    if (ii == tags.end())
+    if (tags.find(tag) == tags.end())
         throw pdal_error("JSON pipeline: Invalid pipeline: "
             "undefined stage tag '" + tag + "'.");
     else
-        inputs.push_back(ii->second);
+        inputs.push_back(tag);
 }
 
 
-std::vector<Stage *> PipelineReaderJSON::extractInputs(NL::json& node,
-    TagMap& tags)
+StringList PipelineReaderJSON::extractInputs(NL::json& node,
+    const TagSet& tags)
 {
-    std::vector<Stage *> inputs;
-    std::string filename;
+    StringList inputs;
 
     auto it = node.find("inputs");
     if (it != node.end())
@@ -306,6 +333,26 @@ std::vector<Stage *> PipelineReaderJSON::extractInputs(NL::json& node,
     return inputs;
 }
 
+std::string PipelineReaderJSON::extractPlugin(NL::json& node)
+{
+    std::string plugin;
+
+    // The plugin is loaded when the stage is created.  Don't actually put
+    // a "plugin" option on any stage.
+    auto it = node.find("plugin");
+    if (it != node.end())
+    {
+        NL::json& val = *it;
+        if (val.is_string())
+            plugin = val.get<std::string>();
+        else
+            throw pdal_error("JSON pipeline: 'plugin' must be "
+                "specified as a string.");
+        node.erase(it);
+    }
+    return plugin;
+}
+
 namespace
 {
 
@@ -340,15 +387,6 @@ Options PipelineReaderJSON::extractOptions(NL::json& node)
         NL::json& subnode = it.value();
         const std::string& name = it.key();
 
-        if (name == "plugin")
-        {
-            PluginManager<Stage>::loadPlugin(subnode.get<std::string>());
-
-            // Don't actually put a "plugin" option on
-            // any stage
-            continue;
-        }
-
         if (subnode.is_array())
         {
             for (const NL::json& val : subnode)
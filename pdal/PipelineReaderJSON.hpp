@@ -37,8 +37,9 @@
 #include <pdal/JsonFwd.hpp>
 #include <pdal/StageFactory.hpp>
 
-#include <vector>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <pdal/Options.hpp>
 #include <pdal/StageFactory.hpp>
@@ -48,10 +49,12 @@ namespace pdal
 
 class Stage;
 class PipelineManager;
+class PipelineTemplate;
 
 class PDAL_DLL PipelineReaderJSON
 {
     friend class PipelineManager;
+    friend class PipelineTemplate;
 
 public:
     PipelineReaderJSON(PipelineManager&);
@@ -61,17 +64,23 @@ private:
     PipelineReaderJSON(const PipelineReaderJSON&) = delete;
 
     typedef std::map<std::string, Stage *> TagMap;
+    typedef std::set<std::string> TagSet;
+
+    // Parsing doesn't create any stages, so it doesn't need a manager.
+    static void readPipeline(std::istream& input, PipelineTemplate& t);
+    static void parsePipeline(NL::json&, PipelineTemplate& t);
+    static std::string extractType(NL::json& node);
+    static std::string extractFilename(NL::json& node);
+    static std::string extractTag(NL::json& node, const TagSet& tags);
+    static StringList extractInputs(NL::json& node, const TagSet& tags);
+    static std::string extractPlugin(NL::json& node);
+    static Options extractOptions(NL::json& node);
+    static void handleInputTag(const std::string& tag, const TagSet& tags,
+        StringList& inputs);
 
-    void parsePipeline(NL::json&);
+    void buildPipeline(const PipelineTemplate& t);
     void readPipeline(const std::string& filename);
     void readPipeline(std::istream& input);
-    std::string extractType(NL::json& node);
-    std::string extractFilename(NL::json& node);
-    std::string extractTag(NL::json& node, TagMap& tags);
-    std::vector<Stage *> extractInputs(NL::json& node, TagMap& tags);
-    Options extractOptions(NL::json& node);
-    void handleInputTag(const std::string& tag, const TagMap& tags,
-        std::vector<Stage *>& inputs);
 
     PipelineManager& m_manager;
 };
@@ -0,0 +1,131 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <pdal/PipelineTemplate.hpp>
+#include <pdal/PipelineReaderJSON.hpp>
+
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <sstream>
+
+namespace pdal
+{
+
+namespace
+{
+
+// Templates are keyed by their JSON text.  The most recently used
+// templates are at the front of the list.  When the text held exceeds
+// the size limit, the least recently used templates are dropped.
+using TemplatePtr = std::shared_ptr<const PipelineTemplate>;
+using TemplateList = std::list<std::pair<std::string, TemplatePtr>>;
+using TemplateMap = std::map<std::reference_wrapper<const std::string>,
+    TemplateList::iterator, std::less<const std::string>>;
+
+TemplateList s_lru;
+TemplateMap s_templates;
+size_t s_bytes = 0;
+size_t s_maxBytes = 16 * 1024 * 1024;
+std::mutex s_templateMutex;
+
+// Call with the mutex held.
+void evict()
+{
+    while (s_bytes > s_maxBytes)
+    {
+        const std::string& json = s_lru.back().first;
+        s_bytes -= json.size();
+        s_templates.erase(std::cref(json));
+        s_lru.pop_back();
+    }
+}
+
+} // unnamed namespace
+
+
+PipelineTemplate::PipelineTemplate(std::istream& input)
+{
+    PipelineReaderJSON::readPipeline(input, *this);
+}
+
+
+std::shared_ptr<const PipelineTemplate>
+PipelineTemplate::cached(const std::string& json)
+{
+    {
+        std::lock_guard<std::mutex> lock(s_templateMutex);
+        auto it = s_templates.find(std::cref(json));
+        if (it != s_templates.end())
+        {
+            s_lru.splice(s_lru.begin(), s_lru, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Parse without holding the lock.  If another thread parses the same
+    // pipeline at the same time, the first template stored wins.
+    std::istringstream ss(json);
+    TemplatePtr t(new PipelineTemplate(ss));
+
+    std::lock_guard<std::mutex> lock(s_templateMutex);
+    if (json.size() > s_maxBytes)
+        return t;
+    auto it = s_templates.find(std::cref(json));
+    if (it != s_templates.end())
+        return it->second->second;
+
+    s_lru.emplace_front(json, t);
+    s_templates.insert(std::make_pair(std::cref(s_lru.front().first),
+        s_lru.begin()));
+    s_bytes += json.size();
+    evict();
+    return t;
+}
+
+
+void PipelineTemplate::setCacheSize(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(s_templateMutex);
+    s_maxBytes = bytes;
+    evict();
+}
+
+
+void PipelineTemplate::clearCache()
+{
+    std::lock_guard<std::mutex> lock(s_templateMutex);
+    s_templates.clear();
+    s_lru.clear();
+    s_bytes = 0;
+}
+
+} // namespace pdal
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#pragma once
+
+#include <pdal/pdal_internal.hpp>
+#include <pdal/Options.hpp>
+
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pdal
+{
+
+class PipelineManager;
+class PipelineReaderJSON;
+
+/**
+  A parsed JSON pipeline.  A template can be used to add the stages it
+  describes to any number of pipeline managers without parsing the JSON
+  again (see PipelineManager::readPipeline(const PipelineTemplate&)).
+  Settings that vary between uses, such as filenames, can be provided with
+  the manager's common and stage options, which are applied as each stage
+  is created.
+*/
+class PDAL_DLL PipelineTemplate
+{
+    friend class PipelineReaderJSON;
+
+public:
+    /**
+      Parse a JSON pipeline.
+
+      \param input  Stream from which to read the pipeline.
+    */
+    PipelineTemplate(std::istream& input);
+
+    /**
+      Get a template for a JSON pipeline, parsing the pipeline only if
+      the same text hasn't already been parsed.  Templates are held in a
+      process-wide cache, along with their text, until the total size of
+      the text passes the limit set with setCacheSize(), when the least
+      recently used templates are dropped.
+
+      \param json  Pipeline JSON text.
+      \return  Pipeline template.
+    */
+    static std::shared_ptr<const PipelineTemplate>
+        cached(const std::string& json);
+
+    /**
+      Set the limit on the total size of the pipeline text held by the
+      cache used by cached().  A limit of 0 disables caching.  The default
+      is 16MB.
+
+      \param bytes  Maximum size of the cached pipeline text.
+    */
+    static void setCacheSize(size_t bytes);
+
+    /**
+      Remove all templates from the cache used by cached().
+    */
+    static void clearCache();
+
+private:
+    struct StageInfo
+    {
+        std::string m_type;
+        std::string m_filename;
+        std::string m_tag;
+        StringList m_inputs;
+        std::string m_plugin;
+        Options m_options;
+    };
+
+    std::vector<StageInfo> m_stages;
+};
+
+} // namespace pdal
@@ -363,8 +363,11 @@ T *PluginManager<T>::l_createObject(const std::string& objectType)
 template <typename T>
 DynamicLibrary *PluginManager<T>::libraryLoaded(const std::string& path)
 {
+    // Libraries are stored by absolute path.
+    std::string absPath = FileUtils::toAbsolutePath(path);
+
     std::lock_guard<std::mutex> lock(m_libMutex);
-    auto it = m_dynamicLibraryMap.find(path);
+    auto it = m_dynamicLibraryMap.find(absPath);
     if (it == m_dynamicLibraryMap.end())
         return nullptr;
     return it->second.get();
@@ -381,15 +384,26 @@ DynamicLibrary *PluginManager<T>::loadLibrary(const std::string& path)
     if (d)
         return d;
 
-    d = DynamicLibrary::load(path, errorString);
-    if (d)
+    // Don't retry a library that couldn't be loaded.  Drivers are looked
+    // up each time a stage is created, so a bad library would otherwise
+    // be opened again for every stage.
+    std::string absPath = FileUtils::toAbsolutePath(path);
     {
         std::lock_guard<std::mutex> lock(m_libMutex);
-        m_dynamicLibraryMap[FileUtils::toAbsolutePath(path)] = DynLibPtr(d);
+        if (m_failedLibraries.count(absPath))
+            return nullptr;
     }
+
+    d = DynamicLibrary::load(path, errorString);
+    std::lock_guard<std::mutex> lock(m_libMutex);
+    if (d)
+        m_dynamicLibraryMap[absPath] = DynLibPtr(d);
     else
+    {
+        m_failedLibraries.insert(absPath);
         m_log->get(LogLevel::Error) << "Can't load library " << path <<
             ": " << errorString;
+    }
 
     return d;
 }
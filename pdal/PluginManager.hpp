@@ -46,6 +46,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 #include <functional>
@@ -135,6 +136,7 @@ private:
     void l_loadAll();
 
     DynamicLibraryMap m_dynamicLibraryMap;
+    std::set<std::string> m_failedLibraries;
     RegistrationInfoMap m_plugins;
     std::mutex m_pluginMutex;
     std::mutex m_libMutex;
@@ -61,6 +61,15 @@ private:
         { return id; }
     virtual void freeTemp(PointId id)
         {}
+    // Data for a point, arranged according to the layout, or nullptr if
+    // the container doesn't store points that way.  As with
+    // setFieldInternal(), a container may add the point if it doesn't
+    // exist.
+    virtual char *pointData(PointId id)
+        { return nullptr; }
+    // As pointData(), but for reading: never adds a point.
+    virtual const char *constPointData(PointId id)
+        { return nullptr; }
 public:
     virtual PointLayoutPtr layout() const = 0;
 };
@@ -225,6 +225,12 @@ bool PointLayout::update(Dimension::Detail dd, const std::string& name)
 {
     if (m_finalized)
     {
+        // Registering a dimension that's already in the layout with the
+        // same type doesn't change the layout.  Allow it so that a pipeline
+        // can be prepared again with a table it has already used.
+        const Dimension::Detail& cur = m_detail[Utils::toNative(dd.id())];
+        if (Utils::contains(m_used, dd.id()) && cur.type() == dd.type())
+            return true;
         throw pdal_error("Can't update layout after points have been added.");
     }
 
@@ -224,6 +224,27 @@ public:
     PointId pointId() const
         { return m_idx; }
 
+    /**
+      Get the memory storing the point's data, arranged according to the
+      layout.  See FieldAccessor.
+
+      \return  Pointer to the point's data, or nullptr if the container
+        doesn't store points in the layout's format.
+    */
+    char *data() const
+        { return m_container->pointData(m_idx); }
+
+    /**
+      Get the memory storing the point's data for reading.  Unlike data(),
+      this never adds a point to the container.
+
+      \return  Pointer to the point's data, or nullptr if the container
+        doesn't store points in the layout's format or the point doesn't
+        exist.
+    */
+    const char *constData() const
+        { return m_container->constPointData(m_idx); }
+
     inline void getField(char *val, Dimension::Id d,
         Dimension::Type type) const;
     inline void setField(Dimension::Id dim,
@@ -102,7 +102,7 @@ void SimplePointTable::getFieldInternal(Dimension::Id id, PointId idx,
 PointTable::~PointTable()
 {
     for (auto vi = m_blocks.begin(); vi != m_blocks.end(); ++vi)
-        delete [] *vi;
+        m_allocator.release(*vi, m_blockSize);
 }
 
 PointId PointTable::addPoint()
@@ -110,14 +110,31 @@ PointId PointTable::addPoint()
     if (m_numPts % m_blockPtCnt == 0)
     {
         size_t size = pointsToBytes(m_blockPtCnt);
-        char *buf = new char[size];
-        memset(buf, 0, size);
-        m_blocks.push_back(buf);
+        size_t block = m_numPts / m_blockPtCnt;
+
+        // Blocks are kept when the table is cleared, so reuse one if
+        // it's there.
+        if (block < m_blocks.size())
+            memset(m_blocks[block], 0, size);
+        else
+        {
+            m_blocks.push_back(m_allocator.allocate(size));
+            m_blockSize = size;
+        }
     }
     return m_numPts++;
 }
 
 
+void PointTable::clear()
+{
+    m_numPts = 0;
+    m_metadata.reset(new Metadata());
+    m_spatialRefs.clear();
+    m_artifactManager.reset();
+}
+
+
 char *PointTable::getPoint(PointId idx)
 {
     char *buf = m_blocks[idx / m_blockPtCnt];
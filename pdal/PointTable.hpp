@@ -38,6 +38,7 @@
 #include <list>
 #include <vector>
 
+#include "pdal/BlockAllocator.hpp"
 #include "pdal/SpatialReference.hpp"
 #include "pdal/Dimension.hpp"
 #include "pdal/PointContainer.hpp"
@@ -102,6 +103,12 @@ private:
 protected:
     virtual char *getPoint(PointId idx) = 0;
 
+private:
+    virtual char *pointData(PointId idx)
+        { return getPoint(idx); }
+    virtual const char *constPointData(PointId idx)
+        { return getPoint(idx); }
+
 protected:
     MetadataPtr m_metadata;
     std::list<SpatialReference> m_spatialRefs;
@@ -145,17 +152,38 @@ class PDAL_DLL PointTable : public SimplePointTable
 {
 private:
     // Point storage.
+    BlockAllocator& m_allocator;
     std::vector<char *> m_blocks;
+    size_t m_blockSize;
     point_count_t m_numPts;
     static const point_count_t m_blockPtCnt = 65536;
 
 public:
-    PointTable() : SimplePointTable(m_layout), m_numPts(0)
+    PointTable() : SimplePointTable(m_layout),
+            m_allocator(BlockAllocator::heap()), m_blockSize(0), m_numPts(0)
+        {}
+    /**
+      Create a table whose point memory is provided by an allocator.
+      The allocator must outlive the table.
+
+      \param allocator  Allocator for blocks of points.
+    */
+    PointTable(BlockAllocator& allocator) : SimplePointTable(m_layout),
+            m_allocator(allocator), m_blockSize(0), m_numPts(0)
         {}
     virtual ~PointTable();
     virtual bool supportsView() const
         { return true; }
 
+    /**
+      Remove all points, metadata and spatial references from the table
+      so that it can be used for another execution of the same pipeline.
+      The layout is kept and the memory allocated for points is reused for
+      points added later.  Views of the table's existing points become
+      invalid.
+    */
+    void clear();
+
 protected:
     virtual char *getPoint(PointId idx);
 
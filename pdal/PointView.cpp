@@ -32,6 +32,7 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <algorithm>
 #include <iomanip>
 
 #include <pdal/EigenUtils.hpp>
@@ -76,6 +77,7 @@ PointViewIter PointView::end()
 void PointView::setFieldInternal(Dimension::Id dim, PointId idx,
     const void *buf)
 {
+    resolve();
     PointId rawId = 0;
     if (idx == size())
     {
@@ -98,6 +100,104 @@ void PointView::setFieldInternal(Dimension::Id dim, PointId idx,
 }
 
 
+PointViewPtr PointView::select(PointViewPtr source,
+    const std::vector<uint8_t>& mask)
+{
+    PointViewPtr view(source->makeNew());
+    std::shared_ptr<Selection> sel(new Selection);
+    point_count_t count = 0;
+
+    std::shared_ptr<const Selection> srcSel(source->pendingSelection());
+    if (srcSel)
+    {
+        // Select from the points selected by the source.
+        sel->m_source = srcSel->m_source;
+        sel->m_bits.resize(srcSel->m_bits.size());
+        PointId idx = 0;
+        for (size_t w = 0; w < srcSel->m_bits.size(); ++w)
+        {
+            uint64_t word = srcSel->m_bits[w];
+            for (size_t b = 0; word; ++b, word >>= 1)
+                if ((word & 1) && mask[idx++])
+                {
+                    sel->m_bits[w] |= (uint64_t)1 << b;
+                    count++;
+                }
+        }
+    }
+    else
+    {
+        sel->m_source = source;
+        sel->m_bits.resize((source->size() + 63) / 64);
+        for (PointId idx = 0; idx < source->size(); ++idx)
+            if (mask[idx])
+            {
+                sel->m_bits[idx / 64] |= (uint64_t)1 << (idx % 64);
+                count++;
+            }
+    }
+
+    view->m_size = count;
+    if (count)
+    {
+        PointView& src = *sel->m_source;
+        std::lock_guard<std::mutex> lock(src.m_selectionMutex);
+        auto expired = [](const std::weak_ptr<PointView>& p)
+            { return p.expired(); };
+        src.m_dependents.erase(std::remove_if(src.m_dependents.begin(),
+            src.m_dependents.end(), expired), src.m_dependents.end());
+        src.m_dependents.push_back(view);
+        view->m_selection = sel;
+        view->m_pending = true;
+    }
+    return view;
+}
+
+
+std::shared_ptr<const PointView::Selection> PointView::pendingSelection()
+{
+    if (!m_pending.load(std::memory_order_acquire))
+        return nullptr;
+    std::lock_guard<std::mutex> lock(m_selectionMutex);
+    return m_selection;
+}
+
+
+void PointView::resolveSelection()
+{
+    std::lock_guard<std::mutex> lock(m_selectionMutex);
+    if (!m_pending.load(std::memory_order_relaxed))
+        return;
+
+    const std::deque<PointId>& index = m_selection->m_source->m_index;
+    for (size_t w = 0; w < m_selection->m_bits.size(); ++w)
+    {
+        uint64_t word = m_selection->m_bits[w];
+        for (PointId pos = w * 64; word; ++pos, word >>= 1)
+            if (word & 1)
+                m_index.push_back(index[pos]);
+    }
+    m_selection.reset();
+    m_pending.store(false, std::memory_order_release);
+}
+
+
+void PointView::resolveDependents()
+{
+    std::vector<std::weak_ptr<PointView>> dependents;
+    {
+        std::lock_guard<std::mutex> lock(m_selectionMutex);
+        dependents.swap(m_dependents);
+    }
+    for (auto& d : dependents)
+    {
+        PointViewPtr view(d.lock());
+        if (view)
+            view->resolve();
+    }
+}
+
+
 void PointView::calculateBounds(BOX2D& output) const
 {
     pdal::calculateBounds(*this, output);
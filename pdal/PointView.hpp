@@ -42,10 +42,13 @@
 #include <pdal/PointTable.hpp>
 #include <pdal/PointRef.hpp>
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <deque>
+#include <vector>
 
 //#pragma warning(disable: 4244)  // conversion from 'type1' to 'type2', possible loss of data
 
@@ -96,6 +99,8 @@ public:
     inline void appendPoint(const PointView& buffer, PointId id);
     void append(const PointView& buf)
     {
+        resolve();
+        buf.resolve();
         // We use size() instead of the index end because temp points
         // might have been placed at the end of the buffer.
         // We're essentially ditching temp points.
@@ -113,6 +118,34 @@ public:
         return PointViewPtr(new PointView(m_pointTable, m_spatialReference));
     }
 
+    /**
+      Create a view of the points of a source view whose entries in a mask
+      are nonzero, in the order of the source view.  Rather than copying
+      point IDs, the new view refers to the points of the source through a
+      bitmap and builds its index when a point is first accessed by
+      position.  Selecting from a view that hasn't built its index combines
+      the bitmaps, so chains of selections don't copy IDs until a stage
+      needs them.  Use forEachPoint() to read the points of a view without
+      building its index.
+
+      \param source  View from which to select points.
+      \param mask  Entry for each point of the source view.
+      \return  New view of the selected points.
+    */
+    static PointViewPtr select(PointViewPtr source,
+        const std::vector<uint8_t>& mask);
+
+    /**
+      Call a function for each point of the view, in order, with the
+      position of the point in the view and a pointer to the point's data
+      (null if the table doesn't provide it).  Doesn't build the index of
+      a view created by select().
+
+      \param f  Function to call as f(PointId idx, char *data).
+    */
+    template<typename F>
+    void forEachPoint(F f);
+
     PointRef point(PointId id)
         { return PointRef(*this, id); }
 
@@ -247,12 +280,16 @@ public:
     /// Provides access to the memory storing the point data.  Though this
     /// function is public, other access methods are safer and preferred.
     char *getPoint(PointId id)
-        { return m_pointTable.getPoint(m_index[id]); }
+    {
+        resolve();
+        return m_pointTable.getPoint(m_index[id]);
+    }
 
     /// Provides access to the memory storing the point data.  Though this
     /// function is public, other access methods are safer and preferred.
     char *getOrAddPoint(PointId id)
     {
+        resolve();
         if (id == size())
         {
             m_index.push_back(m_pointTable.addPoint());
@@ -309,7 +346,32 @@ protected:
     std::unique_ptr<KD2Index> m_index2;
 
 private:
+    // Points of a source view selected by select().  The source always
+    // has an index.
+    struct Selection
+    {
+        PointViewPtr m_source;
+        std::vector<uint64_t> m_bits;
+    };
+
     static int m_lastId;
+    // Set while the view's index is described by m_selection.
+    std::atomic<bool> m_pending { false };
+    std::shared_ptr<const Selection> m_selection;
+    std::mutex m_selectionMutex;
+    // Selections that refer to this view and may not have built their
+    // indexes.
+    std::vector<std::weak_ptr<PointView>> m_dependents;
+
+    // Build the index of a selected view if it hasn't been.
+    void resolve() const
+    {
+        if (m_pending.load(std::memory_order_acquire))
+            const_cast<PointView *>(this)->resolveSelection();
+    }
+    void resolveSelection();
+    std::shared_ptr<const Selection> pendingSelection();
+    void resolveDependents();
 
     template<typename T_IN, typename T_OUT>
     bool convertAndSet(Dimension::Id dim, PointId idx, T_IN in);
@@ -318,17 +380,32 @@ private:
         const void *buf);
     virtual void getFieldInternal(Dimension::Id dim, PointId idx,
             void *buf) const
-        { m_pointTable.getFieldInternal(dim, m_index[idx], buf); }
+    {
+        resolve();
+        m_pointTable.getFieldInternal(dim, m_index[idx], buf);
+    }
+    // Reordering points moves them under selections made from this view,
+    // so those build their indexes first.
     virtual void swapItems(PointId id1, PointId id2)
     {
+        resolve();
+        if (!m_dependents.empty())
+            resolveDependents();
         PointId temp = m_index[id2];
         m_index[id2] = m_index[id1];
         m_index[id1] = temp;
     }
     virtual void setItem(PointId dst, PointId src)
     {
+        resolve();
+        if (!m_dependents.empty())
+            resolveDependents();
         m_index[dst] = m_index[src];
     }
+    virtual char *pointData(PointId id)
+        { return getOrAddPoint(id); }
+    virtual const char *constPointData(PointId id)
+        { return id < size() ? getPoint(id) : nullptr; }
 
     template<class T>
     T getFieldInternal(Dimension::Id dim, PointId pointIndex) const;
@@ -340,7 +417,10 @@ private:
 
     // For testing only.
     PointId index(PointId id) const
-        { return m_index[id]; }
+    {
+        resolve();
+        return m_index[id];
+    }
 };
 
 struct PointViewLess
@@ -585,6 +665,8 @@ void PointView::setField(Dimension::Id dim, PointId idx, T val)
 
 inline void PointView::appendPoint(const PointView& buffer, PointId id)
 {
+    resolve();
+    buffer.resolve();
     // Invalid 'id' is a programmer error.
     PointId rawId = buffer.m_index[id];
     m_index.push_back(rawId);
@@ -593,10 +675,35 @@ inline void PointView::appendPoint(const PointView& buffer, PointId id)
 }
 
 
+template<typename F>
+void PointView::forEachPoint(F f)
+{
+    std::shared_ptr<const Selection> sel(pendingSelection());
+    if (!sel)
+    {
+        for (PointId idx = 0; idx < size(); ++idx)
+            f(idx, m_pointTable.getPoint(m_index[idx]));
+        return;
+    }
+
+    const std::deque<PointId>& index = sel->m_source->m_index;
+    PointId idx = 0;
+    for (size_t w = 0; w < sel->m_bits.size(); ++w)
+    {
+        uint64_t word = sel->m_bits[w];
+        for (PointId pos = w * 64; word; ++pos, word >>= 1)
+            if (word & 1)
+                f(idx++, m_pointTable.getPoint(index[pos]));
+    }
+}
+
+
 // Make a temporary copy of a point by adding an entry to the index.
 inline PointId PointView::getTemp(PointId id)
 {
     PointId newid;
+
+    resolve();
     if (m_temps.size())
     {
         newid = m_temps.front();
@@ -279,15 +279,32 @@ bool Polygon::intersects(const Polygon& p) const
     return m_geom->Intersects(p.m_geom.get());
 }
 
+void Polygon::initGrids() const
+{
+    if (m_pd->m_grids.empty())
+        for (const Polygon& p : polygons())
+            m_pd->m_grids.emplace_back(p.exteriorRing(), p.interiorRings());
+}
+
+
+/// Build the lookup structures used to test whether the polygon contains
+/// a point.  Once prepared, contains(x, y) doesn't modify the polygon, so
+/// it can be called from multiple threads at once.
+void Polygon::prepare() const
+{
+    initGrids();
+    for (auto& g : m_pd->m_grids)
+        g.prepare();
+}
+
+
 /// Determine whether this polygon contains a point.
 /// \param x  Point x coordinate.
 /// \param y  Point y coordinate.
 /// \return  Whether the polygon contains the point or not.
 bool Polygon::contains(double x, double y) const
 {
-    if (m_pd->m_grids.empty())
-        for (const Polygon& p : polygons())
-            m_pd->m_grids.emplace_back(p.exteriorRing(), p.interiorRings());
+    initGrids();
     for (auto& g : m_pd->m_grids)
         if (g.inside(x, y))
             return true;
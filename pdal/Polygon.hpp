@@ -69,6 +69,7 @@ public:
         bool preserve_topology = true);
     double area() const;
     std::vector<Polygon> polygons() const;
+    void prepare() const;
 
     bool covers(const PointRef& ref) const;
     bool equal(const Polygon& p) const;
@@ -85,6 +86,7 @@ public:
 
 private:
     void init();
+    void initGrids() const;
     void removeSmallRings(double tolerance);
     void removeSmallHoles(OGRGeometry *g, double tolerance);
 
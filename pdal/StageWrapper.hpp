@@ -49,6 +49,8 @@ class StreamableWrapper : public StageWrapper
 public:
     static bool processOne(Streamable& s, PointRef& point)
         { return s.processOne(point); }
+    static bool flushOne(Streamable& s, PointRef& point)
+        { return s.flushOne(point); }
     static void spatialReferenceChanged(Streamable& s,
             const SpatialReference& srs)
         { s.spatialReferenceChanged(srs); }
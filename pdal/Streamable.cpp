@@ -32,7 +32,9 @@
 * OF SUCH DAMAGE.
 ****************************************************************************/
 
+#include <algorithm>
 #include <iterator>
+#include <vector>
 
 #include <pdal/Streamable.hpp>
 #include <pdal/Reader.hpp>
@@ -119,10 +121,9 @@ void Streamable::execute(StreamPointTable& table)
         nonstreaming->throwError("Attempting to use stream mode with a "
             "stage that doesn't support streaming.");
 
-    SpatialReference srs;
     std::list<StreamableList> lists;
+    std::vector<StreamableList> paths;
     StreamableList stages;
-    StreamableList lastRunStages;
 
     table.finalize();
 
@@ -130,8 +131,8 @@ void Streamable::execute(StreamPointTable& table)
     // the list of stages and push it on a list.  We then pull a list from the
     // back of list and keep going.  Pushing on the front and pulling from the
     // back insures that the stages will be executed in the order that they
-    // were added.  If we hit stage with no previous stages, we execute
-    // the stage list.
+    // were added.  If we hit stage with no previous stages, we've found
+    // a complete path from a reader to the end stage.
     // All this often amounts to a bunch of list copying for
     // no reason, but it's more simple than what we might otherwise do and
     // this should be a nit in the grand scheme of execution time.
@@ -139,21 +140,12 @@ void Streamable::execute(StreamPointTable& table)
     // As an example, if there are four paths from the end stage (writer) to
     // reader stages, there will be four stage lists and execute(table, stages)
     // will be called four times.
-    SrsMap srsMap;
     Streamable *s = this;
     stages.push_front(s);
     while (true)
     {
         if (s->m_inputs.empty())
-        {
-            // Call done on all the stages we ran last time and aren't
-            // using this time.
-            (lastRunStages - stages).done(table);
-            // Call ready on all the stages we didn't run last time.
-            (stages - lastRunStages).ready(table);
-            execute(table, stages, srsMap);
-            lastRunStages = stages;
-        }
+            paths.push_back(stages);
         else
         {
             for (auto bi = s->m_inputs.rbegin(); bi != s->m_inputs.rend(); bi++)
@@ -164,19 +156,39 @@ void Streamable::execute(StreamPointTable& table)
             }
         }
         if (lists.empty())
-        {
-            lastRunStages.done(table);
             break;
-        }
         stages = lists.front();
         lists.pop_front();
         s = stages.front();
     }
+
+    SrsMap srsMap;
+    StreamableList lastRunStages;
+    for (auto pi = paths.begin(); pi != paths.end(); ++pi)
+    {
+        StreamableList& path = *pi;
+
+        // Call done on all the stages we ran last time and aren't
+        // using this time.
+        (lastRunStages - path).done(table);
+        // Call ready on all the stages we didn't run last time.
+        (path - lastRunStages).ready(table);
+
+        // Stages that aren't part of the next path have received all their
+        // input once this path has run, so they can release the points
+        // they hold.
+        auto next = std::next(pi);
+        StreamableList exhausted = (next == paths.end()) ? path : path - *next;
+        execute(table, path, exhausted, srsMap);
+        lastRunStages = path;
+    }
+    lastRunStages.done(table);
 }
 
 
 void Streamable::execute(StreamPointTable& table,
-    std::list<Streamable *>& stages, SrsMap& srsMap)
+    std::list<Streamable *>& stages,
+    const std::list<Streamable *>& exhausted, SrsMap& srsMap)
 {
     std::list<Streamable *> filters;
     SpatialReference srs;
@@ -195,6 +207,41 @@ void Streamable::execute(StreamPointTable& table,
     begin++;
     std::copy(begin, stages.end(), std::back_inserter(filters));
 
+    // When we get a false back from a filter, we're filtering out a
+    // point, so add it to the list of skips so that it doesn't get
+    // processed by subsequent filters.
+    auto runFilters = [&](std::list<Streamable *>::iterator fi,
+        point_count_t pointLimit)
+    {
+        PointRef point(table, 0);
+        for (; fi != filters.end(); ++fi)
+        {
+            Streamable *s = *fi;
+            auto si = srsMap.find(s);
+            if (si == srsMap.end() || si->second != srs)
+            {
+                s->spatialReferenceChanged(srs);
+                srsMap[s] = srs;
+            }
+            s->startLogging();
+            for (PointId idx = 0; idx < pointLimit; idx++)
+            {
+                if (table.skip(idx))
+                    continue;
+                point.setPointId(idx);
+                if (!s->processOne(point))
+                    table.setSkip(idx);
+            }
+            const SpatialReference& tempSrs = s->getSpatialReference();
+            if (!tempSrs.empty())
+            {
+                srs = tempSrs;
+                table.setSpatialReference(srs);
+            }
+            s->stopLogging();
+        }
+    };
+
     // Loop until we're finished.  We handle the number of points up to
     // the capacity of the StreamPointTable that we've been provided.
 
@@ -228,36 +275,37 @@ void Streamable::execute(StreamPointTable& table,
         if (!srs.empty())
             table.setSpatialReference(srs);
 
-        // When we get a false back from a filter, we're filtering out a
-        // point, so add it to the list of skips so that it doesn't get
-        // processed by subsequent filters.
-        for (Streamable *s : filters)
+        runFilters(filters.begin(), pointLimit);
+        table.clear(pointLimit);
+    }
+
+    // The reader is exhausted.  Give each filter that won't receive any
+    // more input, in order, a chance to emit points it has held back, and
+    // pass those points through the filters that follow it.
+    for (auto fi = filters.begin(); fi != filters.end(); ++fi)
+    {
+        Streamable *s = *fi;
+        if (std::find(exhausted.begin(), exhausted.end(), s) ==
+                exhausted.end())
+            continue;
+        bool held = true;
+        while (held)
         {
-            auto si = srsMap.find(s);
-            if (si == srsMap.end() || si->second != srs)
-            {
-                s->spatialReferenceChanged(srs);
-                srsMap[s] = srs;
-            }
+            PointRef point(table, 0);
+            point_count_t pointLimit = 0;
             s->startLogging();
-            for (PointId idx = 0; idx < pointLimit; idx++)
+            while (pointLimit < table.capacity())
             {
-                if (table.skip(idx))
-                    continue;
-                point.setPointId(idx);
-                if (!s->processOne(point))
-                    table.setSkip(idx);
-            }
-            const SpatialReference& tempSrs = s->getSpatialReference();
-            if (!tempSrs.empty())
-            {
-                srs = tempSrs;
-                table.setSpatialReference(srs);
+                point.setPointId(pointLimit);
+                held = s->flushOne(point);
+                if (!held)
+                    break;
+                pointLimit++;
             }
             s->stopLogging();
+            runFilters(std::next(fi), pointLimit);
+            table.clear(pointLimit);
         }
-
-        table.clear(pointLimit);
     }
 }
 
@@ -81,7 +81,7 @@ protected:
     using SrsMap = std::map<Streamable *, SpatialReference>;
 
     void execute(StreamPointTable& table, std::list<Streamable *>& stages,
-        SrsMap& srsMap);
+        const std::list<Streamable *>& exhausted, SrsMap& srsMap);
 
     /**
       Process a single point (streaming mode).  Implement in subclass.
@@ -99,6 +99,20 @@ protected:
     }
     **/
 
+    /**
+      Emit a point that was held back by \ref processOne (streaming mode).
+      Called once every input of the stage has no more points to provide.
+      Stages that buffer points (returning false from \ref processOne and
+      releasing the point later by overwriting a subsequent point) implement
+      this to drain the points still held.
+
+      \param point  Point to fill with held data.
+      \return  Whether \a point was filled.  Return false when no more
+        points are held.
+    */
+    virtual bool flushOne(PointRef& /*point*/)
+        { return false; }
+
     /**
       Notification that the points that will follow in processing are from
       a spatial reference different than the previous spatial reference.
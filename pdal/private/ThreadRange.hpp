@@ -0,0 +1,106 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+#pragma once
+
+#include <pdal/pdal_internal.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace pdal
+{
+
+// Split the index range [0, count) into (at most) 'threads' contiguous
+// ranges and run fn(begin, end) for each range on its own thread.  With a
+// single thread the function is run on the calling thread.  An exception
+// thrown by any of the ranges is rethrown on the calling thread after all
+// threads have been joined.
+template<typename FUNC>
+void forEachRange(point_count_t count, int threads, FUNC fn)
+{
+    point_count_t numThreads = (point_count_t)(std::max)(threads, 1);
+    numThreads = (std::min)(numThreads, (std::max)(count, point_count_t(1)));
+    if (numThreads == 1)
+    {
+        fn(point_count_t(0), count);
+        return;
+    }
+
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::vector<std::thread> threadList;
+    for (point_count_t t = 0; t < numThreads; ++t)
+    {
+        const point_count_t begin = t * count / numThreads;
+        const point_count_t end = (t + 1) * count / numThreads;
+        threadList.emplace_back([&fn, &error, &mutex, begin, end]()
+        {
+            try
+            {
+                fn(begin, end);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        });
+    }
+    for (auto& t : threadList)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+// Run fn(i) for each index in [0, count) on (at most) 'threads' threads.
+// Indices are handed out one at a time, so this balances better than
+// forEachRange() when the cost of an item varies widely.
+template<typename FUNC>
+void forEachIndex(point_count_t count, int threads, FUNC fn)
+{
+    point_count_t numThreads = (point_count_t)(std::max)(threads, 1);
+    numThreads = (std::min)(numThreads, (std::max)(count, point_count_t(1)));
+
+    std::atomic<point_count_t> next(0);
+    forEachRange(numThreads, (int)numThreads,
+        [&fn, &next, count](point_count_t, point_count_t)
+    {
+        point_count_t i;
+        while ((i = next++) < count)
+            fn(i);
+    });
+}
+
+} // namespace pdal
@@ -235,3 +235,68 @@ TEST(EigenTest, computeCentroid)
     EXPECT_EQ(80, centroid.x());
     EXPECT_EQ(800, centroid.y());
 }
+
+TEST(EigenTest, computeCovarianceArrays)
+{
+    double x[] = { 1, 2, 3, 4, 5, 6, 7 };
+    double y[] = { 3, 1, 4, 1, 5, 9, 2 };
+    double z[] = { 2, 7, 1, 8, 2, 8, 1 };
+
+    Eigen::MatrixXd A(3, 7);
+    for (int i = 0; i < 7; ++i)
+        A.col(i) << x[i], y[i], z[i];
+    Eigen::Vector3d mean = A.rowwise().mean();
+    A.colwise() -= mean;
+    Eigen::Matrix3d expected = A * A.transpose() / 6;
+
+    Eigen::Matrix3d B = computeCovariance(x, y, z, 7);
+    for (int i = 0; i < 3; ++i)
+        for (int j = 0; j < 3; ++j)
+            EXPECT_NEAR(expected(i, j), B(i, j), 1e-12);
+}
+
+TEST(EigenTest, computeEigen3x3)
+{
+    using namespace Eigen;
+
+    Vector3d values;
+    Matrix3d vectors;
+
+    // Diagonal matrices are decomposed exactly.
+    Matrix3d B;
+    B << 2, 0, 0,
+         0, 3, 0,
+         0, 0, 1;
+    EXPECT_TRUE(computeEigen3x3(B, values, vectors));
+    EXPECT_EQ(values, Vector3d(1, 2, 3));
+    EXPECT_EQ(vectors.col(0), Vector3d(0, 0, 1));
+    EXPECT_EQ(vectors.col(1), Vector3d(1, 0, 0));
+    EXPECT_EQ(vectors.col(2), Vector3d(0, 1, 0));
+
+    // A planar neighborhood has an exactly zero smallest eigenvalue.
+    double s = 1.0 / 3.0;
+    B << s, 0, s,
+         0, s, 0,
+         s, 0, s;
+    EXPECT_TRUE(computeEigen3x3(B, values, vectors));
+    EXPECT_EQ(values[0], 0.0);
+    EXPECT_NEAR(std::fabs(vectors(0, 0)), std::sqrt(2.0) / 2.0, 1e-12);
+    EXPECT_NEAR(vectors(1, 0), 0.0, 1e-12);
+    EXPECT_NEAR(std::fabs(vectors(2, 0)), std::sqrt(2.0) / 2.0, 1e-12);
+
+    // General case agrees with the iterative solver.
+    B << 4.6, 2.3, 0.1,
+         2.3, 7.9, 0.9,
+         0.1, 0.9, 11.1;
+    SelfAdjointEigenSolver<Matrix3d> solver(B);
+    EXPECT_TRUE(computeEigen3x3(B, values, vectors));
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_NEAR(values[i], solver.eigenvalues()[i], 1e-10);
+        EXPECT_NEAR(std::fabs(vectors.col(i).dot(solver.eigenvectors().col(i))),
+            1.0, 1e-10);
+    }
+
+    B(0, 0) = std::numeric_limits<double>::quiet_NaN();
+    EXPECT_FALSE(computeEigen3x3(B, values, vectors));
+}
@@ -376,5 +376,12 @@ TEST(KDIndex, radius3D)
     EXPECT_EQ(ids[0], 0u);
     EXPECT_EQ(ids[1], 1u);
     EXPECT_EQ(ids[2], 2u);
+
+    // Count only, with and without an early-exit limit.
+    EXPECT_EQ(index.radiusCount(0, 0, 0, 5.2), 3u);
+    EXPECT_EQ(index.radiusCount(3.1, 3.1, 3.1, 12.2), 5u);
+    EXPECT_EQ(index.radiusCount(3.1, 3.1, 3.1, 12.2, 2), 2u);
+    EXPECT_EQ(index.radiusCount(0, 5.2), 3u);
+    EXPECT_EQ(index.radiusCount(0, 5.2, 10), 3u);
 }
 
@@ -36,6 +36,7 @@
 
 #include <pdal/StageFactory.hpp>
 #include <pdal/pdal_test_main.hpp>
+#include <filters/StreamCallbackFilter.hpp>
 
 #include "Support.hpp"
 
@@ -193,6 +194,93 @@ TEST(OldPCLBlockTests, RadiusOutliers2)
     EXPECT_EQ(3u, view->size());
 }
 
+// Stream mode holds points until their neighborhood is complete, so the
+// result should match RadiusOutliers1.
+TEST(OldPCLBlockTests, RadiusOutliersStream)
+{
+    StageFactory f;
+
+    Options ro;
+    ro.add("filename", Support::datapath("autzen/autzen-point-format-3.las"));
+
+    Stage* r(f.createStage("readers.las"));
+    EXPECT_TRUE(r);
+    r->setOptions(ro);
+
+    Options fo;
+    fo.add("method", "radius");
+    fo.add("radius", 200.0);
+    fo.add("min_k", 1);
+
+    Stage* outlier(f.createStage("filters.outlier"));
+    EXPECT_TRUE(outlier);
+    outlier->setOptions(fo);
+    outlier->setInput(*r);
+
+    point_count_t total = 0;
+    point_count_t kept = 0;
+    StreamCallbackFilter cb;
+    cb.setCallback([&total, &kept](PointRef& point)
+    {
+        total++;
+        if (point.getFieldAs<uint8_t>(Dimension::Id::Classification) != 7)
+            kept++;
+        return true;
+    });
+    cb.setInput(*outlier);
+
+    FixedPointTable table(10);
+    cb.prepare(table);
+    cb.execute(table);
+
+    EXPECT_EQ(106u, total);
+    EXPECT_EQ(60u, kept);
+}
+
+// Points from both readers are held until every input is exhausted, so
+// each point has its duplicate from the other reader as a neighbor.
+TEST(OldPCLBlockTests, RadiusOutliersStreamTwoReaders)
+{
+    StageFactory f;
+
+    Options ro;
+    ro.add("filename", Support::datapath("autzen/autzen-point-format-3.las"));
+
+    Stage* r1(f.createStage("readers.las"));
+    r1->setOptions(ro);
+    Stage* r2(f.createStage("readers.las"));
+    r2->setOptions(ro);
+
+    Options fo;
+    fo.add("method", "radius");
+    fo.add("radius", 200.0);
+    fo.add("min_k", 1);
+
+    Stage* outlier(f.createStage("filters.outlier"));
+    outlier->setOptions(fo);
+    outlier->setInput(*r1);
+    outlier->setInput(*r2);
+
+    point_count_t total = 0;
+    point_count_t kept = 0;
+    StreamCallbackFilter cb;
+    cb.setCallback([&total, &kept](PointRef& point)
+    {
+        total++;
+        if (point.getFieldAs<uint8_t>(Dimension::Id::Classification) != 7)
+            kept++;
+        return true;
+    });
+    cb.setInput(*outlier);
+
+    FixedPointTable table(10);
+    cb.prepare(table);
+    cb.execute(table);
+
+    EXPECT_EQ(212u, total);
+    EXPECT_EQ(212u, kept);
+}
+
 TEST(OldPCLBlockTests, PMF)
 {
     StageFactory f;
@@ -38,7 +38,9 @@
 
 #include <pdal/Stage.hpp>
 #include <pdal/StageFactory.hpp>
+#include <pdal/PipelineExecutor.hpp>
 #include <pdal/PipelineManager.hpp>
+#include <pdal/PipelineTemplate.hpp>
 #include <pdal/util/FileUtils.hpp>
 
 using namespace pdal;
@@ -238,3 +240,96 @@ TEST(PipelineManagerTest, replace)
     EXPECT_EQ(w2->getInputs().size(), 1U);
     EXPECT_EQ(w2->getInputs().front(), f2);
 }
+
+TEST(PipelineManagerTest, pipelineTemplate)
+{
+    std::string json =
+        "[ \"" + Support::datapath("las/1.2-with-color.las") + "\", "
+        "{ \"type\": \"filters.head\", \"tag\": \"head\", "
+        "\"count\": 10 } ]";
+
+    std::shared_ptr<const PipelineTemplate> t =
+        PipelineTemplate::cached(json);
+    EXPECT_EQ(t, PipelineTemplate::cached(json));
+
+    // Each manager creates its own stages from the template.
+    PipelineManager mgr1;
+    mgr1.readPipeline(*t);
+    EXPECT_EQ(mgr1.execute(), 10U);
+
+    PipelineManager mgr2;
+    Options opts;
+    opts.add("count", 20);
+    mgr2.stageOptions()["stage.head"] = opts;
+    mgr2.readPipeline(*t);
+    EXPECT_EQ(mgr2.execute(), 20U);
+    EXPECT_NE(mgr1.getStage(), mgr2.getStage());
+
+    // Tags are checked when the pipeline is parsed.
+    std::istringstream bad("[ { \"type\": \"filters.head\", "
+        "\"inputs\": \"missing\" } ]");
+    EXPECT_THROW(PipelineTemplate t2(bad), pdal_error);
+
+    PipelineTemplate::clearCache();
+    EXPECT_NE(t, PipelineTemplate::cached(json));
+}
+
+TEST(PipelineManagerTest, pipelineTemplateCacheSize)
+{
+    auto json = [](int count)
+    {
+        return "[ { \"type\": \"filters.head\", \"count\": " +
+            std::to_string(count) + " } ]";
+    };
+
+    // Room for two pipelines.  The least recently used one is dropped.
+    PipelineTemplate::clearCache();
+    PipelineTemplate::setCacheSize(json(10).size() * 2);
+    auto t1 = PipelineTemplate::cached(json(10));
+    auto t2 = PipelineTemplate::cached(json(20));
+    EXPECT_EQ(t1, PipelineTemplate::cached(json(10)));
+    auto t3 = PipelineTemplate::cached(json(30));
+    EXPECT_EQ(t1, PipelineTemplate::cached(json(10)));
+    EXPECT_EQ(t3, PipelineTemplate::cached(json(30)));
+    EXPECT_NE(t2, PipelineTemplate::cached(json(20)));
+
+    // Nothing is cached.
+    PipelineTemplate::setCacheSize(0);
+    EXPECT_NE(PipelineTemplate::cached(json(10)),
+        PipelineTemplate::cached(json(10)));
+
+    PipelineTemplate::setCacheSize(16 * 1024 * 1024);
+}
+
+TEST(PipelineManagerTest, reexecute)
+{
+    std::string json =
+        "[ \"" + Support::datapath("las/1.2-with-color.las") + "\", "
+        "{ \"type\": \"filters.head\", \"tag\": \"head\", "
+        "\"count\": 10 } ]";
+
+    PipelineExecutor exec(json);
+    EXPECT_EQ(exec.execute(), 10);
+
+    PipelineManager& mgr = exec.getManager();
+    Stage *stage = mgr.getStage();
+    PointLayoutPtr layout = mgr.pointTable().layout();
+    double x = (*mgr.views().begin())->getFieldAs<double>(Dimension::Id::X, 0);
+
+    // The stages and the table are reused and the new option applies.
+    Options opts;
+    opts.add("count", 20);
+    exec.setStageOptions("head", opts);
+    EXPECT_EQ(exec.execute(), 20);
+    EXPECT_EQ(mgr.getStage(), stage);
+    EXPECT_EQ(mgr.pointTable().layout(), layout);
+    EXPECT_EQ(mgr.stages().size(), 2U);
+
+    PointViewPtr v = *mgr.views().begin();
+    EXPECT_EQ(v->size(), 20U);
+    EXPECT_DOUBLE_EQ(v->getFieldAs<double>(Dimension::Id::X, 0), x);
+    EXPECT_EQ(mgr.pointTable().metadata().children("readers.las").size(),
+        1U);
+
+    EXPECT_THROW(exec.setStageOptions("missing", opts), pdal_error);
+}
@@ -257,4 +257,60 @@ TEST(PointTable, simple)
     simpleTest(t2);
 }
 
+
+TEST(PointTable, allocator)
+{
+    // Fill a table with two blocks of points, setting intensity only if
+    // requested.  Returns the size of a block.
+    auto fill = [](PointTable& t, int intensity) -> size_t
+    {
+        t.layout()->registerDim(Dimension::Id::X);
+        t.layout()->registerDim(Dimension::Id::Intensity);
+        PointView v(t);
+        for (PointId id = 0; id < 70000; ++id)
+        {
+            v.setField(Dimension::Id::X, id, id);
+            if (intensity)
+                v.setField(Dimension::Id::Intensity, id, intensity);
+        }
+        for (PointId id = 0; id < 70000; id += 1000)
+            EXPECT_EQ(v.getFieldAs<int>(Dimension::Id::Intensity, id),
+                intensity);
+        return 65536 * t.layout()->pointSize();
+    };
+
+    for (bool hugePages : { false, true })
+    {
+        BlockAllocator pool(100000000, hugePages);
+
+        size_t blockSize;
+        {
+            PointTable t(pool);
+            blockSize = fill(t, 1);
+            BlockAllocator::Stats stats = pool.stats();
+            EXPECT_EQ(stats.m_systemAllocs, 2U);
+            EXPECT_EQ(stats.m_bytesInUse, 2 * blockSize);
+        }
+        BlockAllocator::Stats stats = pool.stats();
+        EXPECT_EQ(stats.m_bytesInUse, 0U);
+        EXPECT_EQ(stats.m_bytesCached, 2 * blockSize);
+
+        // Blocks released by the first table are reused and zeroed.
+        {
+            PointTable t(pool);
+            fill(t, 0);
+            stats = pool.stats();
+            EXPECT_EQ(stats.m_systemAllocs, 2U);
+            EXPECT_EQ(stats.m_reuses, 2U);
+            EXPECT_EQ(stats.m_bytesCached, 0U);
+            EXPECT_EQ(stats.m_peakBytesInUse, 2 * blockSize);
+        }
+
+        pool.setMaxCachedBytes(blockSize);
+        EXPECT_EQ(pool.stats().m_bytesCached, blockSize);
+        pool.trim();
+        EXPECT_EQ(pool.stats().m_bytesCached, 0U);
+    }
+}
+
 } // namespace
@@ -34,10 +34,12 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <algorithm>
 #include <array>
 #include <random>
 
 #include <pdal/EigenUtils.hpp>
+#include <pdal/FieldAccessor.hpp>
 #include <pdal/PointView.hpp>
 #include <pdal/PDALUtils.hpp>
 #include "Support.hpp"
@@ -290,6 +292,116 @@ TEST(PointViewTest, getFloatNan)
     EXPECT_NO_THROW(view->getFieldAs<float>(Dimension::Id::ScanAngleRank, 0));
 }
 
+TEST(PointViewTest, fieldAccessor)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Id::X);
+    layout->registerDim(Id::Classification);
+    layout->finalize();
+
+    PointView view(table);
+    FieldAccessor<double> x(layout, Id::X);
+    FieldAccessor<int> c(layout, Id::Classification);
+    FieldAccessor<double> z(layout, Id::Z);
+    EXPECT_TRUE(x.valid());
+    EXPECT_TRUE(c.valid());
+    EXPECT_FALSE(z.valid());
+
+    // Setting through a view appends a point at the end.
+    x.set(view, 0, 12.5);
+    c.set(view, 0, 6);
+    EXPECT_EQ(view.size(), 1u);
+    EXPECT_DOUBLE_EQ(view.getFieldAs<double>(Id::X, 0), 12.5);
+    EXPECT_EQ(view.getFieldAs<int>(Id::Classification, 0), 6);
+    EXPECT_THROW(c.set(view, 0, 300), pdal_error);
+
+    // So does setting through a reference to the end of the view.
+    PointRef point(view, 1);
+    x.set(point, -3.25);
+    c.set(point, 2);
+    EXPECT_EQ(view.size(), 2u);
+    EXPECT_DOUBLE_EQ(x.get(point), -3.25);
+    EXPECT_EQ(c.get(view, 1), 2);
+
+    // Values that can't be converted are ignored when set through a point.
+    c.set(point, -1);
+    EXPECT_EQ(c.get(point), 2);
+
+    view.setField(Id::X, 0, 1000.0);
+    FieldAccessor<uint8_t> xSmall(layout, Id::X);
+    EXPECT_THROW(xSmall.get(view, 0), pdal_error);
+
+    // Absent dimensions read as 0 and ignore values set.
+    z.set(point, 5.0);
+    EXPECT_DOUBLE_EQ(z.get(point), 0.0);
+    EXPECT_EQ(view.size(), 2u);
+
+    // Reading never appends a point.
+    PointRef end(view, 2);
+    EXPECT_EQ(end.constData(), nullptr);
+    EXPECT_EQ(view.size(), 2u);
+    EXPECT_DOUBLE_EQ(x.get(point, point.constData()), -3.25);
+    EXPECT_EQ(view.size(), 2u);
+}
+
+TEST(PointViewTest, select)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    PointLayoutPtr layout(table.layout());
+    layout->registerDim(Id::X);
+    layout->finalize();
+
+    PointViewPtr view(new PointView(table));
+    for (PointId i = 0; i < 1000; ++i)
+        view->setField(Id::X, i, 999 - i);
+
+    // Select multiples of 3, then multiples of 2 of those.
+    std::vector<uint8_t> mask(view->size());
+    for (PointId i = 0; i < mask.size(); ++i)
+        mask[i] = (i % 3 == 0);
+    PointViewPtr threes = PointView::select(view, mask);
+    EXPECT_EQ(threes->size(), 334u);
+
+    mask.assign(threes->size(), 0);
+    std::vector<int> expected;
+    PointId count = 0;
+    threes->forEachPoint([&](PointId idx, char *data)
+    {
+        EXPECT_EQ(idx, count++);
+        EXPECT_TRUE(data);
+        mask[idx] = (idx % 2 == 0);
+        if (mask[idx])
+            expected.push_back(999 - (int)idx * 3);
+    });
+    EXPECT_EQ(count, threes->size());
+    PointViewPtr sixes = PointView::select(threes, mask);
+    ASSERT_EQ(sixes->size(), expected.size());
+
+    // Sorting the source builds the indexes of the selections first, so
+    // they keep their points.
+    std::sort(view->begin(), view->end(),
+        [](const PointRef& p1, const PointRef& p2)
+        { return p1.compare(Id::X, p2); });
+    for (PointId i = 0; i < sixes->size(); ++i)
+        EXPECT_EQ(sixes->getFieldAs<int>(Id::X, i), expected[i]);
+    for (PointId i = 0; i < threes->size(); ++i)
+        EXPECT_EQ(threes->getFieldAs<int>(Id::X, i), 999 - (int)i * 3);
+    EXPECT_EQ(view->getFieldAs<int>(Id::X, 0), 0);
+
+    // A selected view can be extended like any other.
+    sixes->setField(Id::X, sixes->size(), 5000);
+    EXPECT_EQ(sixes->size(), expected.size() + 1);
+    EXPECT_EQ(sixes->getFieldAs<int>(Id::X, expected.size()), 5000);
+
+    mask.assign(view->size(), 0);
+    EXPECT_EQ(PointView::select(view, mask)->size(), 0u);
+}
+
 // Per discussions with @abellgithub (https://github.com/gadomski/PDAL/commit/c1d54e56e2de841d37f2a1b1c218ed723053f6a9#commitcomment-14415138)
 // we only do bounds checking on `PointView`s when in debug mode.
 #ifndef NDEBUG
@@ -218,4 +218,55 @@ TEST(PolygonTest, streams)
 
 }
 
+
+// A polygon with many short edges in a small area, so that point-in-polygon
+// cells are split.  Check against simple ray casting.
+TEST(PolygonTest, contains_dense)
+{
+    using Ring = std::vector<std::pair<double, double>>;
+
+    Ring ring;
+    const int count = 20000;
+    for (int i = 0; i < count; ++i)
+    {
+        double a = 2 * 3.14159265358979 * i / count;
+        double r = 10 + 2 * std::sin(a * 7);
+        if (a < 1)
+            r += std::sin(a * 3000);
+        ring.push_back({ r * std::cos(a), r * std::sin(a) });
+    }
+    ring.push_back(ring.front());
+
+    std::ostringstream wkt;
+    wkt.precision(15);
+    wkt << "POLYGON ((";
+    for (size_t i = 0; i < ring.size(); ++i)
+        wkt << (i ? ", " : "") << ring[i].first << " " << ring[i].second;
+    wkt << "))";
+    Polygon p(wkt.str());
+
+    auto rayCast = [&ring](double x, double y)
+    {
+        bool inside = false;
+        for (size_t i = 0, j = ring.size() - 2; i < ring.size() - 1; j = i++)
+        {
+            const auto& pi = ring[i];
+            const auto& pj = ring[j];
+            if (((pi.second > y) != (pj.second > y)) &&
+                (x < (pj.first - pi.first) * (y - pi.second) /
+                    (pj.second - pi.second) + pi.first))
+                inside = !inside;
+        }
+        return inside;
+    };
+
+    for (double x = -13.01; x < 13; x += .37)
+        for (double y = -13.01; y < 13; y += .37)
+            EXPECT_EQ(p.contains(x, y), rayCast(x, y));
+    // Focus on the area with many edges.
+    for (double x = 7.003; x < 13; x += .051)
+        for (double y = 0.003; y < 10; y += .051)
+            EXPECT_EQ(p.contains(x, y), rayCast(x, y));
+}
+
 } // namespace pdal
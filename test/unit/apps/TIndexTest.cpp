@@ -36,7 +36,9 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <pdal/StageFactory.hpp>
 #include <pdal/util/FileUtils.hpp>
+#include <filters/StreamCallbackFilter.hpp>
 
 #include "Support.hpp"
 
@@ -103,6 +105,26 @@ TEST(TIndex, test2)
     EXPECT_NE(pos, std::string::npos);
 }
 
+// Files that haven't changed since they were indexed are skipped.  The
+// default driver stores the 'modified' field as a date only.
+TEST(TIndex, skipUnchanged)
+{
+    std::string inSpec(Support::datapath("tindex/*.txt"));
+    std::string outSpec(Support::temppath("tindex.out"));
+
+    FileUtils::deleteDirectory(outSpec);
+    std::string cmd = Support::binpath("pdal") + " --verbose=info "
+        "tindex create " + outSpec + " \"" + inSpec + "\" --log=stdout";
+
+    std::string output;
+    Utils::run_shell_command(cmd, output);
+    EXPECT_NE(output.find("Indexed file"), std::string::npos);
+
+    Utils::run_shell_command(cmd, output);
+    EXPECT_EQ(output.find("Indexed file"), std::string::npos);
+    EXPECT_EQ(output.find("Unable to remove"), std::string::npos);
+}
+
 // Indentical to test1, but filespec input comes from find command.
 TEST(TIndex, test3)
 {
@@ -147,3 +169,65 @@ TEST(TIndex, test3)
 #endif
 }
 
+
+// Reading with several threads or in stream mode produces the same points
+// as reading the files one at a time.
+TEST(TIndex, reader)
+{
+    std::string inSpec(Support::datapath("tindex/*.txt"));
+    std::string outSpec(Support::temppath("tindex.out"));
+
+    FileUtils::deleteDirectory(outSpec);
+    std::string cmd = Support::binpath("pdal") + " tindex create " +
+        outSpec + " \"" + inSpec + "\"";
+    std::string output;
+    Utils::run_shell_command(cmd, output);
+
+    auto read = [&outSpec](int threads, bool stream)
+    {
+        StageFactory factory;
+        Stage *r = factory.createStage("readers.tindex");
+        Options opts;
+        opts.add("filename", outSpec);
+        opts.add("bounds", "([1.25, 3],[1.25, 3])");
+        opts.add("threads", threads);
+        r->setOptions(opts);
+
+        std::vector<std::pair<double, double>> points;
+        auto add = [&points](PointRef& point)
+        {
+            points.emplace_back(point.getFieldAs<double>(Dimension::Id::X),
+                point.getFieldAs<double>(Dimension::Id::Y));
+        };
+
+        if (stream)
+        {
+            StreamCallbackFilter f;
+            f.setInput(*r);
+            f.setCallback([&add](PointRef& point)
+                { add(point); return true; });
+            FixedPointTable t(2);
+            f.prepare(t);
+            f.execute(t);
+        }
+        else
+        {
+            PointTable t;
+            r->prepare(t);
+            PointViewSet s = r->execute(t);
+            EXPECT_EQ(s.size(), 1u);
+            PointViewPtr v = *s.begin();
+            for (PointId idx = 0; idx < v->size(); ++idx)
+            {
+                PointRef point(*v, idx);
+                add(point);
+            }
+        }
+        return points;
+    };
+
+    std::vector<std::pair<double, double>> serial = read(1, false);
+    EXPECT_GT(serial.size(), 0u);
+    EXPECT_EQ(serial, read(3, false));
+    EXPECT_EQ(serial, read(1, true));
+}
@@ -36,6 +36,7 @@
 
 #include <pdal/StageFactory.hpp>
 #include <pdal/util/FileUtils.hpp>
+#include <filters/StreamCallbackFilter.hpp>
 
 #include "Support.hpp"
 
@@ -177,3 +178,64 @@ TEST(AssignFilterTest, test_condition)
     EXPECT_EQ(v->size(), 10u);
     EXPECT_EQ(ielse, 7);
 }
+
+// The condition is tested before any assignment is made to a point, and
+// each assignment sees the result of the previous ones.
+TEST(AssignFilterTest, chained)
+{
+    StageFactory factory;
+
+    auto test = [&factory](bool stream)
+    {
+        Stage& r = *factory.createStage("readers.faux");
+        Stage& f = *factory.createStage("filters.assign");
+
+        Options ro;
+        ro.add("bounds", BOX3D(0, 0, 0, 9999, 9999, 9999));
+        ro.add("mode", "ramp");
+        ro.add("count", 10000);
+        r.setOptions(ro);
+
+        Options fo;
+        fo.add("condition", "Y[1000:5000]");
+        fo.add("assignment", "Y[:]=1");
+        fo.add("assignment", "Y[1:1]=2");
+        f.setOptions(fo);
+        f.setInput(r);
+
+        auto check = [](PointRef& point)
+        {
+            int x = point.getFieldAs<int>(Dimension::Id::X);
+            int y = point.getFieldAs<int>(Dimension::Id::Y);
+            EXPECT_EQ(y, (x >= 1000 && x <= 5000) ? 2 : x);
+            return true;
+        };
+
+        if (stream)
+        {
+            StreamCallbackFilter c;
+            c.setCallback(check);
+            c.setInput(f);
+
+            FixedPointTable t(100);
+            c.prepare(t);
+            c.execute(t);
+        }
+        else
+        {
+            PointTable t;
+            f.prepare(t);
+            PointViewSet s = f.execute(t);
+            PointViewPtr v = *s.begin();
+            EXPECT_EQ(v->size(), 10000u);
+            for (PointId i = 0; i < v->size(); ++i)
+            {
+                PointRef point(*v, i);
+                check(point);
+            }
+        }
+    };
+
+    test(false);
+    test(true);
+}
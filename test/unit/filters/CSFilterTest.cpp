@@ -33,6 +33,9 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <cmath>
+#include <map>
+
 #include <io/BufferReader.hpp>
 #include <pdal/StageFactory.hpp>
 
@@ -64,3 +67,76 @@ TEST(CSFilterTest, emptyView)
     PointViewSet s = filter->execute(table);
     EXPECT_EQ(s.size(), 0u);
 }
+
+TEST(CSFilterTest, tiles)
+{
+    // A sloped surface with flat-roofed blocks on it.
+    auto addPoints = [](PointViewPtr view)
+    {
+        PointId id = 0;
+        for (int i = 0; i < 120; ++i)
+            for (int j = 0; j < 120; ++j)
+            {
+                double x = i + 0.25 * (j % 3);
+                double y = j + 0.25 * (i % 3);
+                double z = 0.05 * x + 2 * std::sin(y / 15.0);
+                if (std::fmod(x, 40) > 10 && std::fmod(x, 40) < 25 &&
+                    std::fmod(y, 50) > 10 && std::fmod(y, 50) < 30)
+                    z += 8;
+                view->setField(Dimension::Id::X, id, x);
+                view->setField(Dimension::Id::Y, id, y);
+                view->setField(Dimension::Id::Z, id, z);
+                id++;
+            }
+    };
+
+    auto classify = [&addPoints](const Options& opts)
+    {
+        PointTable table;
+        table.layout()->registerDims(
+            {Dimension::Id::X, Dimension::Id::Y, Dimension::Id::Z});
+
+        PointViewPtr view(new PointView(table));
+        addPoints(view);
+        BufferReader reader;
+        reader.addView(view);
+
+        StageFactory factory;
+        Stage* filter(factory.createStage("filters.csf"));
+        filter->setOptions(opts);
+        filter->setInput(reader);
+        filter->prepare(table);
+
+        PointViewSet s = filter->execute(table);
+        EXPECT_EQ(s.size(), 1u);
+        PointViewPtr out = *s.begin();
+
+        // Output order isn't the input order, so key by position.
+        std::map<std::pair<double, double>, int> classes;
+        for (PointId i = 0; i < out->size(); ++i)
+            classes[std::make_pair(
+                out->getFieldAs<double>(Dimension::Id::X, i),
+                out->getFieldAs<double>(Dimension::Id::Y, i))] =
+                out->getFieldAs<int>(Dimension::Id::Classification, i);
+        return classes;
+    };
+
+    auto global = classify(Options());
+
+    Options tiled;
+    tiled.add("tile_size", 30.0);
+    tiled.add("tile_buffer", 15.0);
+    tiled.add("threads", 3);
+    auto tiles = classify(tiled);
+
+    ASSERT_EQ(global.size(), tiles.size());
+    size_t ground = 0;
+    for (auto& g : global)
+    {
+        EXPECT_EQ(g.second, tiles[g.first]);
+        if (g.second == 2)
+            ground++;
+    }
+    EXPECT_GT(ground, 0u);
+    EXPECT_LT(ground, global.size());
+}
@@ -37,6 +37,7 @@
 #include <pdal/PointView.hpp>
 #include <io/LasReader.hpp>
 #include <filters/ColorizationFilter.hpp>
+#include <filters/RangeFilter.hpp>
 #include <filters/StreamCallbackFilter.hpp>
 
 #include "Support.hpp"
@@ -188,3 +189,68 @@ TEST(ColorizationFilterTest, test4)
 }
 
 
+
+// Standard mode reads the raster in batches and stream mode a point at a
+// time.  Both should produce the same values for each resampling method.
+TEST(ColorizationFilterTest, resample)
+{
+    auto colors = [](const std::string& method, bool stream)
+    {
+        Options readerOps;
+        readerOps.add("filename",
+            Support::datapath("autzen/autzen-point-format-3.las"));
+        LasReader reader;
+        reader.setOptions(readerOps);
+
+        // Points off the raster are dropped in stream mode, so only
+        // keep points well inside it.
+        Options rangeOps;
+        rangeOps.add("limits", "X[635700:638800],Y[849000:853300]");
+        RangeFilter range;
+        range.setOptions(rangeOps);
+        range.setInput(reader);
+
+        Options filterOps;
+        filterOps.add("raster", Support::datapath("autzen/autzen.jpg"));
+        filterOps.add("resample", method);
+        ColorizationFilter filter;
+        filter.setOptions(filterOps);
+        filter.setInput(range);
+
+        std::vector<uint16_t> red;
+        if (stream)
+        {
+            StreamCallbackFilter f;
+            f.setInput(filter);
+            f.setCallback([&red](PointRef& point)
+            {
+                red.push_back(point.getFieldAs<uint16_t>(Dimension::Id::Red));
+                return true;
+            });
+            FixedPointTable table(100);
+            f.prepare(table);
+            f.execute(table);
+        }
+        else
+        {
+            PointTable table;
+            filter.prepare(table);
+            PointViewSet viewSet = filter.execute(table);
+            PointViewPtr view = *viewSet.begin();
+            for (PointId idx = 0; idx < view->size(); ++idx)
+                red.push_back(
+                    view->getFieldAs<uint16_t>(Dimension::Id::Red, idx));
+        }
+        return red;
+    };
+
+    std::vector<uint16_t> nearest = colors("nearest", false);
+    EXPECT_EQ(nearest, colors("nearest", true));
+    std::vector<uint16_t> bilinear = colors("bilinear", false);
+    EXPECT_EQ(bilinear, colors("bilinear", true));
+    EXPECT_EQ(nearest.size(), bilinear.size());
+    EXPECT_NE(nearest, bilinear);
+    EXPECT_EQ(colors("cubic", false), colors("cubic", true));
+
+    EXPECT_THROW(colors("lanczos", false), pdal_error);
+}
@@ -616,3 +616,40 @@ TEST(CropFilterTest, bounds_inside_outside)
     // Expect 1026 points when cropping to the outside of the bounds.
     EXPECT_EQ(nStreamPoints, 1026U);
 }
+
+// Check that each polygon gets its own view when cropping against many
+// (overlapping) polygons at once, both inside and outside.
+TEST(CropFilterTest, many_polygons)
+{
+    std::istream* wkt_stream =
+        FileUtils::openFile(Support::datapath("autzen/autzen-selection.wkt"));
+    std::stringstream strbuf;
+    strbuf << wkt_stream->rdbuf();
+    std::string wkt(strbuf.str());
+    FileUtils::closeFile(wkt_stream);
+
+    for (bool outside : { false, true })
+    {
+        Options ops1;
+        ops1.add("filename", Support::datapath("las/1.2-with-color.las"));
+        LasReader reader;
+        reader.setOptions(ops1);
+
+        Options options;
+        for (int i = 0; i < 50; ++i)
+            options.add("polygon", wkt);
+        options.add("outside", outside);
+        options.add("threads", 3);
+
+        CropFilter crop;
+        crop.setInput(reader);
+        crop.setOptions(options);
+
+        PointTable table;
+        crop.prepare(table);
+        PointViewSet viewSet = crop.execute(table);
+        EXPECT_EQ(viewSet.size(), 50u);
+        for (PointViewPtr view : viewSet)
+            EXPECT_EQ(view->size(), outside ? 1065u - 47u : 47u);
+    }
+}
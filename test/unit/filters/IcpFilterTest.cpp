@@ -32,11 +32,16 @@
  * OF SUCH DAMAGE.
  ****************************************************************************/
 
+#define _USE_MATH_DEFINES
+
 #include "Support.hpp"
 #include <Eigen/Dense>
 #include <filters/TransformationFilter.hpp>
 #include <io/LasReader.hpp>
+#include <iomanip>
 #include <memory>
+#include <numeric>
+#include <sstream>
 #include <pdal/pdal_test_main.hpp>
 #include <pdal/EigenUtils.hpp>
 #include <pdal/StageFactory.hpp>
@@ -136,6 +141,169 @@ TEST(IcpFilterTest, RecoverTranslation)
     checkPointsEqualReader(pointViewSet, tolerance);
 }
 
+TEST(IcpFilterTest, RecoverTranslationMultiLevel)
+{
+    auto reader1 = newReader();
+    auto reader2 = newReader();
+    TransformationFilter transformationFilter;
+    Options transformationOptions;
+    transformationOptions.add("matrix", "1 0 0 1\n0 1 0 2\n0 0 1 3\n0 0 0 1");
+    transformationFilter.setOptions(transformationOptions);
+    transformationFilter.setInput(*reader2);
+
+    auto filter = newFilter();
+    Options options;
+    options.add("levels", 3);
+    options.add("threads", 3);
+    filter->setOptions(options);
+    filter->setInput(*reader1);
+    filter->setInput(transformationFilter);
+
+    PointTable table;
+    filter->prepare(table);
+    PointViewSet pointViewSet = filter->execute(table);
+
+    MetadataNode root = filter->getMetadata();
+    Eigen::MatrixXd transform =
+        root.findChild("transform").value<Eigen::MatrixXd>();
+    double tolerance = 1e-3;
+    EXPECT_NEAR(-1.0, transform(0, 3), tolerance);
+    EXPECT_NEAR(-2.0, transform(1, 3), tolerance);
+    EXPECT_NEAR(-3.0, transform(2, 3), tolerance);
+    checkPointsEqualReader(pointViewSet, tolerance);
+}
+
+TEST(IcpFilterTest, PointToPlaneIdentity)
+{
+    auto reader1 = newReader();
+    auto reader2 = newReader();
+    auto filter = newFilter();
+    Options options;
+    options.add("objective", "point2plane");
+    options.add("threads", 2);
+    filter->setOptions(options);
+    filter->setInput(*reader1);
+    filter->setInput(*reader2);
+
+    PointTable table;
+    filter->prepare(table);
+    PointViewSet viewSet = filter->execute(table);
+    EXPECT_EQ(1u, viewSet.size());
+
+    MetadataNode root = filter->getMetadata();
+    EXPECT_EQ("true", root.findChild("converged").value());
+    Eigen::MatrixXd transformMatrix =
+        root.findChild("transform").value<Eigen::MatrixXd>();
+    EXPECT_TRUE(transformMatrix.isApprox(Eigen::MatrixXd::Identity(4, 4),
+        1e-6));
+    EXPECT_NEAR(0.0, root.findChild("fitness").value<double>(), 1e-6);
+}
+
+TEST(IcpFilterTest, PointToPlaneRecoverRigid)
+{
+    // ICP works on points centered on the centroid of the fixed points, so
+    // rotate the moving points about it to get a transformation that can
+    // be checked.
+    Eigen::Vector3d centroid;
+    {
+        auto reader = newReader();
+        PointTable table;
+        reader->prepare(table);
+        PointViewPtr view = *reader->execute(table).begin();
+        PointIdList ids(view->size());
+        std::iota(ids.begin(), ids.end(), 0);
+        centroid = computeCentroid(*view, ids);
+    }
+
+    Eigen::Matrix3d rotation(Eigen::AngleAxisd(2.0 * M_PI / 180.0,
+        Eigen::Vector3d::UnitZ()));
+    Eigen::Vector3d translation(1, 2, 3);
+    Eigen::Matrix4d applied(Eigen::Matrix4d::Identity());
+    applied.block<3, 3>(0, 0) = rotation;
+    applied.block<3, 1>(0, 3) = centroid + translation - rotation * centroid;
+    std::ostringstream matrix;
+    matrix << std::setprecision(17) << applied;
+
+    Eigen::Matrix4d expected(Eigen::Matrix4d::Identity());
+    expected.block<3, 3>(0, 0) = rotation.transpose();
+    expected.block<3, 1>(0, 3) = -rotation.transpose() * translation;
+
+    auto test = [&](int levels)
+    {
+        auto reader1 = newReader();
+        auto reader2 = newReader();
+        TransformationFilter transformationFilter;
+        Options transformationOptions;
+        transformationOptions.add("matrix", matrix.str());
+        transformationFilter.setOptions(transformationOptions);
+        transformationFilter.setInput(*reader2);
+
+        auto filter = newFilter();
+        Options options;
+        options.add("objective", "point2plane");
+        options.add("levels", levels);
+        filter->setOptions(options);
+        filter->setInput(*reader1);
+        filter->setInput(transformationFilter);
+
+        PointTable table;
+        filter->prepare(table);
+        PointViewSet pointViewSet = filter->execute(table);
+
+        MetadataNode root = filter->getMetadata();
+        EXPECT_EQ("true", root.findChild("converged").value());
+        Eigen::MatrixXd transform =
+            root.findChild("transform").value<Eigen::MatrixXd>();
+        double tolerance = 1e-3;
+        for (int i = 0; i < 4; ++i)
+            for (int j = 0; j < 4; ++j)
+                EXPECT_NEAR(expected(i, j), transform(i, j), tolerance);
+        checkPointsEqualReader(pointViewSet, tolerance);
+    };
+
+    test(1);
+    test(3);
+}
+
+TEST(IcpFilterTest, InvalidObjective)
+{
+    auto reader1 = newReader();
+    auto reader2 = newReader();
+    auto filter = newFilter();
+    Options options;
+    options.add("objective", "plane2plane");
+    filter->setOptions(options);
+    filter->setInput(*reader1);
+    filter->setInput(*reader2);
+
+    PointTable table;
+    EXPECT_THROW(filter->prepare(table), pdal_error);
+}
+
+TEST(IcpFilterTest, InvalidLevels)
+{
+    auto test = [](int levels, int stride)
+    {
+        auto reader1 = newReader();
+        auto reader2 = newReader();
+        auto filter = newFilter();
+        Options options;
+        options.add("levels", levels);
+        options.add("stride", stride);
+        filter->setOptions(options);
+        filter->setInput(*reader1);
+        filter->setInput(*reader2);
+
+        PointTable table;
+        filter->prepare(table);
+    };
+
+    EXPECT_THROW(test(64, 1), pdal_error);
+    EXPECT_THROW(test(1000, 1), pdal_error);
+    EXPECT_THROW(test(63, 2), pdal_error);
+    EXPECT_NO_THROW(test(63, 1));
+}
+
 TEST(IcpFilterTest, TooFewInputs)
 {
     auto reader = newReader();
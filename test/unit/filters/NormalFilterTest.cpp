@@ -251,4 +251,38 @@ TEST(NormalFilterTest, RampPlane2)
     }
 }
 
+TEST(NormalFilterTest, Threads)
+{
+    using namespace Dimension;
+
+    PointTable table;
+    table.layout()->registerDims({Id::X, Id::Y, Id::Z});
+
+    FauxReader reader;
+    Options readerOps;
+    readerOps.add("mode", "grid");
+    readerOps.add("bounds", "([0, 10], [0, 10], [0, 0])");
+    readerOps.add("count", 100);
+    reader.setOptions(readerOps);
+    NormalFilter filter;
+    Options filterOps;
+    filterOps.add("knn", 8);
+    filterOps.add("threads", 4);
+    filter.setInput(reader);
+    filter.setOptions(filterOps);
+    filter.prepare(table);
+
+    PointViewSet viewSet = filter.execute(table);
+    PointViewPtr outView = *viewSet.begin();
+    EXPECT_EQ(outView->size(), 100u);
+
+    for (auto const& p : *outView)
+    {
+        ASSERT_FLOAT_EQ(p.getFieldAs<float>(Id::NormalX), 0.0);
+        ASSERT_FLOAT_EQ(p.getFieldAs<float>(Id::NormalY), 0.0);
+        ASSERT_FLOAT_EQ(p.getFieldAs<float>(Id::NormalZ), 1.0);
+        ASSERT_FLOAT_EQ(p.getFieldAs<float>(Id::Curvature), 0.0);
+    }
+}
+
 } // namespace pdal
@@ -162,3 +162,48 @@ TEST(OverlayFilterTest, stream)
 {
     testOverlay(10, true);
 }
+
+// Make sure values assigned with multiple threads match those assigned
+// with a single thread.
+TEST(OverlayFilterTest, threads)
+{
+    auto run = [](size_t threads)
+    {
+        StageFactory factory;
+
+        Stage& m = *(factory.createStage("filters.merge"));
+        for (int i = 0; i < 10; ++i)
+        {
+            Options ro;
+            ro.add("filename", Support::datapath("autzen/autzen-dd.las"));
+            Stage& r = *(factory.createStage("readers.las"));
+            r.setOptions(ro);
+            m.setInput(r);
+        }
+
+        Options fo;
+        fo.add("dimension", "Classification");
+        fo.add("column", "cls");
+        fo.add("datasource", Support::datapath("autzen/attributes.shp"));
+        fo.add("threads", threads);
+        Stage& f = *(factory.createStage("filters.overlay"));
+        f.setInput(m);
+        f.setOptions(fo);
+
+        PointTable t;
+        f.prepare(t);
+        PointViewSet s = f.execute(t);
+        EXPECT_EQ(s.size(), 1u);
+        std::vector<uint8_t> classes;
+        PointViewPtr v = *s.begin();
+        for (PointId i = 0; i < v->size(); ++i)
+            classes.push_back(
+                v->getFieldAs<uint8_t>(Dimension::Id::Classification, i));
+        return classes;
+    };
+
+    std::vector<uint8_t> single = run(1);
+    std::vector<uint8_t> multi = run(4);
+    EXPECT_EQ(single.size(), 10650u);
+    EXPECT_EQ(single, multi);
+}
@@ -34,13 +34,16 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <algorithm>
 #include <random>
 
 #include <pdal/PipelineManager.hpp>
 #include <pdal/StageWrapper.hpp>
+#include <io/FauxReader.hpp>
 #include <io/LasReader.hpp>
 #include <io/LasWriter.hpp>
 #include <filters/SortFilter.hpp>
+#include <filters/StreamCallbackFilter.hpp>
 #include "Support.hpp"
 
 using namespace pdal;
@@ -169,3 +172,83 @@ TEST(SortFilterTest, issue1121_simpleSortOrderDesc)
     }
 }
 
+
+// Points that don't fit in the buffer are sorted in runs that are merged.
+TEST(SortFilterTest, stream)
+{
+    const point_count_t count = 200000;
+
+    FauxReader reader;
+    Options readerOps;
+    readerOps.add("count", count);
+    readerOps.add("mode", "random");
+    readerOps.add("bounds", BOX3D(0, 0, 0, 100, 100, 100));
+    reader.setOptions(readerOps);
+
+    SortFilter filter;
+    Options filterOps;
+    filterOps.add("dimension", "Z");
+    filterOps.add("order", "DESC");
+    filterOps.add("buffer_size", 1);
+    filter.setOptions(filterOps);
+    filter.setInput(reader);
+
+    std::vector<double> z;
+    StreamCallbackFilter f;
+    f.setCallback([&z](PointRef& point)
+    {
+        z.push_back(point.getFieldAs<double>(Dimension::Id::Z));
+        return true;
+    });
+    f.setInput(filter);
+
+    FixedPointTable table(1000);
+    f.prepare(table);
+    f.execute(table);
+
+    EXPECT_EQ(z.size(), count);
+    EXPECT_TRUE(std::is_sorted(z.rbegin(), z.rend()));
+}
+
+// Points from all the inputs are sorted together, whether or not runs are
+// spilled to temporary files.
+TEST(SortFilterTest, streamTwoReaders)
+{
+    const point_count_t count = 100000;
+
+    for (uint64_t bufferSize : { 1, 1024 })
+    {
+        Options readerOps;
+        readerOps.add("count", count);
+        readerOps.add("mode", "random");
+        readerOps.add("bounds", BOX3D(0, 0, 0, 100, 100, 100));
+        FauxReader reader1;
+        reader1.setOptions(readerOps);
+        FauxReader reader2;
+        reader2.setOptions(readerOps);
+
+        SortFilter filter;
+        Options filterOps;
+        filterOps.add("dimension", "Z");
+        filterOps.add("buffer_size", bufferSize);
+        filter.setOptions(filterOps);
+        filter.setInput(reader1);
+        filter.setInput(reader2);
+
+        std::vector<double> z;
+        StreamCallbackFilter f;
+        f.setCallback([&z](PointRef& point)
+        {
+            z.push_back(point.getFieldAs<double>(Dimension::Id::Z));
+            return true;
+        });
+        f.setInput(filter);
+
+        FixedPointTable table(1000);
+        f.prepare(table);
+        f.execute(table);
+
+        EXPECT_EQ(z.size(), 2 * count);
+        EXPECT_TRUE(std::is_sorted(z.begin(), z.end()));
+    }
+}
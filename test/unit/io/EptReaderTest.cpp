@@ -33,6 +33,8 @@
  ****************************************************************************/
 
 #include <algorithm>
+#include <fstream>
+#include <set>
 
 #include <nlohmann/json.hpp>
 
@@ -40,8 +42,10 @@
 
 #include <io/EptReader.hpp>
 #include <io/LasReader.hpp>
+#include <io/private/EptCache.hpp>
 #include <filters/CropFilter.hpp>
 #include <filters/ReprojectionFilter.hpp>
+#include <filters/StreamCallbackFilter.hpp>
 #include <pdal/SrsBounds.hpp>
 #include <pdal/util/FileUtils.hpp>
 #include "Support.hpp"
@@ -427,6 +431,228 @@ TEST(EptReaderTest, boundedRead3d)
     EXPECT_EQ(np, 45930u);
 }
 
+// Nodes are decoded concurrently into their own ranges of the view, so the
+// result shouldn't depend on the number of threads.
+TEST(EptReaderTest, boundedReadThreads)
+{
+    BOX2D bounds(-8242700, 4966550, -8242500, 4966650);
+
+    auto read = [&bounds](PointTableRef table, int threads)
+    {
+        Options options;
+        options.add("filename", ellipsoidEptBinaryPath);
+        options.add("bounds", bounds);
+        options.add("threads", threads);
+
+        EptReader reader;
+        reader.setOptions(options);
+        reader.prepare(table);
+        PointViewSet set(reader.execute(table));
+        EXPECT_EQ(set.size(), 1u);
+        return *set.begin();
+    };
+
+    PointTable t4;
+    PointTable t16;
+    PointViewPtr v4 = read(t4, 4);
+    PointViewPtr v16 = read(t16, 16);
+
+    EXPECT_GT(v4->size(), 0u);
+    EXPECT_LT(v4->size(), ellipsoidNumPoints);
+    ASSERT_EQ(v4->size(), v16->size());
+    for (PointId i(0); i < v4->size(); ++i)
+    {
+        double x = v4->getFieldAs<double>(Dimension::Id::X, i);
+        double y = v4->getFieldAs<double>(Dimension::Id::Y, i);
+        ASSERT_TRUE(bounds.contains(x, y));
+        ASSERT_EQ(x, v16->getFieldAs<double>(Dimension::Id::X, i));
+        ASSERT_EQ(y, v16->getFieldAs<double>(Dimension::Id::Y, i));
+        ASSERT_EQ(v4->getFieldAs<double>(Dimension::Id::Z, i),
+            v16->getFieldAs<double>(Dimension::Id::Z, i));
+    }
+}
+
+TEST(EptReaderTest, progressive)
+{
+    // The root node of the dataset holds 41998 points and the five nodes
+    // at depth 1 hold 166916 in all.
+    const point_count_t rootCount(41998);
+
+    auto read = [](PointTableRef table, point_count_t budget)
+    {
+        Options options;
+        options.add("filename", eptLaszipPath);
+        options.add("progressive", true);
+        options.add("point_budget", budget);
+
+        EptReader reader;
+        reader.setOptions(options);
+        reader.prepare(table);
+        PointViewSet set(reader.execute(table));
+        EXPECT_EQ(set.size(), 1u);
+        return *set.begin();
+    };
+
+    // The first node is always read.
+    PointTable t1;
+    EXPECT_EQ(read(t1, 1)->size(), rootCount);
+
+    PointTable t2;
+    const Dimension::Id nodeIdDim = t2.layout()->registerOrAssignDim(
+        "EptNodeId", Dimension::Type::Unsigned32);
+    PointViewPtr v = read(t2, 100000);
+    EXPECT_GT(v->size(), rootCount);
+    EXPECT_LE(v->size(), 100000u);
+
+    // Nodes are read coarse to fine, each into its own range of the view.
+    std::set<uint32_t> seen;
+    uint32_t last(0);
+    for (PointId i(0); i < v->size(); ++i)
+    {
+        const uint32_t nodeId(v->getFieldAs<uint32_t>(nodeIdDim, i));
+        if (i < rootCount)
+        {
+            ASSERT_EQ(nodeId, 1u);
+        }
+        if (nodeId != last)
+        {
+            ASSERT_TRUE(seen.insert(nodeId).second);
+            last = nodeId;
+        }
+    }
+}
+
+TEST(EptReaderTest, progressiveStream)
+{
+    // The root node holds 41998 points, the five nodes at depth 1 hold
+    // 166916 and the five at depth 2 hold 270355.  A budget of 300000
+    // keeps the first two depths and some of the third.
+    const point_count_t budget(300000);
+
+    FixedPointTable table(1000);
+    const Dimension::Id nodeIdDim = table.layout()->registerOrAssignDim(
+        "EptNodeId", Dimension::Type::Unsigned32);
+
+    Options options;
+    options.add("filename", eptLaszipPath);
+    options.add("progressive", true);
+    options.add("point_budget", budget);
+    EptReader reader;
+    reader.setOptions(options);
+
+    std::vector<uint32_t> nodes;
+    point_count_t count(0);
+    StreamCallbackFilter f;
+    f.setCallback([&](PointRef& point)
+    {
+        const uint32_t nodeId(point.getFieldAs<uint32_t>(nodeIdDim));
+        if (nodes.empty() || nodes.back() != nodeId)
+            nodes.push_back(nodeId);
+        count++;
+        return true;
+    });
+    f.setInput(reader);
+    f.prepare(table);
+    f.execute(table);
+
+    EXPECT_GT(count, 41998u + 166916u);
+    EXPECT_LE(count, budget);
+
+    // Node IDs follow key order, which is by depth, so the root is node 1
+    // and the depth 1 nodes are 2 through 6.  Each node is passed on
+    // whole, and a depth is finished before the next one is started.
+    auto depth = [](uint32_t nodeId)
+        { return nodeId == 1 ? 0 : (nodeId <= 6 ? 1 : 2); };
+    std::set<uint32_t> seen;
+    for (size_t i = 0; i < nodes.size(); ++i)
+    {
+        EXPECT_TRUE(seen.insert(nodes[i]).second);
+        if (i)
+        {
+            EXPECT_LE(depth(nodes[i - 1]), depth(nodes[i]));
+        }
+    }
+    ASSERT_GT(nodes.size(), 6u);
+    EXPECT_EQ(nodes.front(), 1u);
+    EXPECT_EQ(depth(nodes.back()), 2);
+
+    // The same nodes are read when not streaming.
+    PointTable t;
+    t.layout()->registerOrAssignDim("EptNodeId", Dimension::Type::Unsigned32);
+    EptReader standard;
+    standard.setOptions(options);
+    standard.prepare(t);
+    PointViewSet set(standard.execute(t));
+    ASSERT_EQ(set.size(), 1u);
+    EXPECT_EQ((*set.begin())->size(), count);
+}
+
+// Reads served from the cache should match those from the resource.
+TEST(EptReaderTest, cache)
+{
+    const std::string cacheDir(Support::temppath("eptcache"));
+    for (const std::string& sub : FileUtils::directoryList(cacheDir))
+        for (const std::string& file : FileUtils::directoryList(sub))
+            FileUtils::deleteFile(file);
+
+    auto read = [&cacheDir](PointTableRef table, const std::string& path,
+        bool cached)
+    {
+        Options options;
+        options.add("filename", path);
+        if (cached)
+            options.add("cache", cacheDir);
+
+        EptReader reader;
+        reader.setOptions(options);
+        reader.prepare(table);
+        PointViewSet set(reader.execute(table));
+        EXPECT_EQ(set.size(), 1u);
+        return *set.begin();
+    };
+
+    for (const std::string& path :
+        { ellipsoidEptBinaryPath, eptLaszipPath })
+    {
+        PointTable t0, t1, t2;
+        PointViewPtr v0 = read(t0, path, false);
+        PointViewPtr v1 = read(t1, path, true);     // Fills the cache.
+        PointViewPtr v2 = read(t2, path, true);     // Reads from it.
+
+        EXPECT_GT(v0->size(), 0u);
+        ASSERT_EQ(v0->size(), v1->size());
+        ASSERT_EQ(v0->size(), v2->size());
+        for (PointId i(0); i < v0->size(); ++i)
+            for (Dimension::Id id : t0.layout()->dims())
+            {
+                const double d(v0->getFieldAs<double>(id, i));
+                ASSERT_EQ(d, v1->getFieldAs<double>(id, i));
+                ASSERT_EQ(d, v2->getFieldAs<double>(id, i));
+            }
+    }
+    EXPECT_EQ(FileUtils::directoryList(cacheDir).size(), 2u);
+}
+
+// Opening a cache removes only the files of writes that never completed,
+// even when the cache directory's path looks like a temporary file.
+TEST(EptReaderTest, cacheTempFiles)
+{
+    const std::string cacheDir(Support::temppath("ept.tmp123/cache"));
+    const std::string dataset(EptCache::datasetId("root", "info"));
+    const std::string sub(cacheDir + "/" + dataset);
+    for (const std::string& file : FileUtils::directoryList(sub))
+        FileUtils::deleteFile(file);
+
+    EptCache::open(cacheDir, 1 << 20)->putData(dataset, "0-0-0-0", "abc", 3);
+    std::ofstream(sub + "/1-0-0-0.tmp12345") << "partial";
+
+    std::shared_ptr<EptCache> cache(EptCache::open(cacheDir, 1 << 20));
+    std::vector<char> data;
+    EXPECT_TRUE(cache->data(dataset, "0-0-0-0", data));
+    EXPECT_EQ(std::string(data.begin(), data.end()), "abc");
+    EXPECT_FALSE(FileUtils::fileExists(sub + "/1-0-0-0.tmp12345"));
+}
+
 TEST(EptReaderTest, originRead)
 {
     uint64_t np(0);
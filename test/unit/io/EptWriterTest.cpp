@@ -0,0 +1,165 @@
+/******************************************************************************
+ * Copyright (c) 2020, Hobu Inc. (info@hobu.co)
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following
+ * conditions are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided
+ *       with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+ * OF SUCH DAMAGE.
+ ****************************************************************************/
+
+#include <pdal/pdal_test_main.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include <nlohmann/json.hpp>
+
+#include <pdal/util/FileUtils.hpp>
+#include <io/EptReader.hpp>
+#include <io/EptWriter.hpp>
+#include <io/FauxReader.hpp>
+#include "Support.hpp"
+
+using namespace pdal;
+
+namespace
+{
+
+using Position = std::array<int64_t, 3>;
+
+// Positions at the precision of the default scale, sorted.
+std::vector<Position> positions(const PointView& view)
+{
+    std::vector<Position> out;
+    for (PointId i = 0; i < view.size(); ++i)
+        out.push_back({{
+            std::llround(view.getFieldAs<double>(Dimension::Id::X, i) * 100),
+            std::llround(view.getFieldAs<double>(Dimension::Id::Y, i) * 100),
+            std::llround(view.getFieldAs<double>(Dimension::Id::Z, i) * 100)
+        }});
+    std::sort(out.begin(), out.end());
+    return out;
+}
+
+PointViewPtr readEpt(PointTableRef table, const std::string& path)
+{
+    Options options;
+    options.add("filename", "ept://" + path);
+
+    EptReader reader;
+    reader.setOptions(options);
+    reader.prepare(table);
+    PointViewSet set(reader.execute(table));
+    EXPECT_EQ(set.size(), 1u);
+    return *set.begin();
+}
+
+} // unnamed namespace
+
+TEST(EptWriterTest, roundTrip)
+{
+    const std::string path(Support::temppath("ept-writer"));
+    FileUtils::deleteDirectory(path);
+
+    Options readerOps;
+    readerOps.add("count", 50000);
+    readerOps.add("mode", "random");
+    readerOps.add("bounds", BOX3D(0, 0, 0, 1000, 500, 100));
+    FauxReader reader;
+    reader.setOptions(readerOps);
+
+    // Small nodes and buffer so that the tree is deep and points are
+    // spilled to disk.
+    Options writerOps;
+    writerOps.add("filename", path);
+    writerOps.add("max_node_size", 1000);
+    writerOps.add("span", 16);
+    writerOps.add("buffer_size", 1);
+    writerOps.add("hierarchy_step", 2);
+    EptWriter writer;
+    writer.setOptions(writerOps);
+    writer.setInput(reader);
+
+    PointTable table;
+    writer.prepare(table);
+    PointViewSet set(writer.execute(table));
+    ASSERT_EQ(set.size(), 1u);
+    PointViewPtr in(*set.begin());
+
+    NL::json info(NL::json::parse(
+        FileUtils::readFileIntoString(path + "/ept.json")));
+    EXPECT_EQ(info["points"].get<point_count_t>(), 50000u);
+    EXPECT_EQ(info["dataType"].get<std::string>(), "binary");
+
+    PointTable outTable;
+    PointViewPtr out(readEpt(outTable, path));
+    EXPECT_EQ(positions(*in), positions(*out));
+}
+
+TEST(EptWriterTest, stream)
+{
+    const std::string path(Support::temppath("ept-writer-stream"));
+    FileUtils::deleteDirectory(path);
+
+    Options readerOps;
+    readerOps.add("mode", "grid");
+    readerOps.add("bounds", BOX3D(0, 0, 0, 40, 50, 10));
+    FauxReader reader;
+    reader.setOptions(readerOps);
+
+    Options writerOps;
+    writerOps.add("filename", path);
+    writerOps.add("max_node_size", 500);
+    EptWriter writer;
+    writer.setOptions(writerOps);
+    writer.setInput(reader);
+
+    FixedPointTable table(1000);
+    writer.prepare(table);
+    writer.execute(table);
+
+    PointTable outTable;
+    PointViewPtr out(readEpt(outTable, path));
+    EXPECT_EQ(out->size(), 20000u);
+
+    BOX3D bounds;
+    out->calculateBounds(bounds);
+    EXPECT_EQ(bounds, BOX3D(0, 0, 0, 39, 49, 9));
+}
+
+TEST(EptWriterTest, badOptions)
+{
+    FauxReader reader;
+
+    Options options;
+    options.add("filename", Support::temppath("ept-writer-bad"));
+    options.add("data_type", "foo");
+    EptWriter writer;
+    writer.setOptions(options);
+    writer.setInput(reader);
+
+    PointTable table;
+    EXPECT_THROW(writer.prepare(table), pdal_error);
+}
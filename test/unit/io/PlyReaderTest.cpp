@@ -35,7 +35,12 @@
 #include <pdal/Filter.hpp>
 #include <pdal/pdal_test_main.hpp>
 
+#include <fstream>
+
 #include <io/PlyReader.hpp>
+#include <filters/StreamCallbackFilter.hpp>
+#include <pdal/util/FileUtils.hpp>
+#include <pdal/util/OStream.hpp>
 #include "Support.hpp"
 
 namespace pdal
@@ -188,6 +193,148 @@ TEST(PlyReader, ReadBinaryStream)
 }
 
 
+namespace
+{
+
+template<typename STREAM>
+void writeBinaryData(STREAM& os, point_count_t count)
+{
+    os << 1.5f << (uint8_t)2 << 7 << 8;
+    for (point_count_t i = 0; i < count; ++i)
+        os << (i + .25) << (i * .5f) << (uint16_t)(i % 60000) << -(int)i;
+    os << (uint8_t)3 << 0 << 1 << 2;
+}
+
+// Write a PLY file with an element on either side of the vertex element.
+std::string writeTestFile(const std::string& format, point_count_t count)
+{
+    std::string filename(Support::temppath("ply_" + format + ".ply"));
+    std::ofstream out(filename, std::ios::out | std::ios::binary);
+    out << "ply\n"
+        "format " << format << " 1.0\n"
+        "element camera 1\n"
+        "property float view\n"
+        "property list uchar int stuff\n"
+        "element vertex " << count << "\n"
+        "property double x\n"
+        "property float y\n"
+        "property ushort z\n"
+        "property int w\n"
+        "element face 1\n"
+        "property list uchar int vertex_indices\n"
+        "end_header\n";
+
+    if (format == "ascii")
+    {
+        out.precision(10);
+        out << "1.5 2 7 8\n";
+        for (point_count_t i = 0; i < count; ++i)
+            out << (i + .25) << " " << (i * .5f) << " " << (i % 60000) <<
+                " " << -(int)i << "\n";
+        out << "3 0 1 2\n";
+    }
+    else if (format == "binary_big_endian")
+    {
+        OBeStream os(&out);
+        writeBinaryData(os, count);
+    }
+    else
+    {
+        OLeStream os(&out);
+        writeBinaryData(os, count);
+    }
+    return filename;
+}
+
+} // unnamed namespace
+
+TEST(PlyReader, ReadFormats)
+{
+    const point_count_t count = 100000;
+    for (std::string format :
+        { "ascii", "binary_little_endian", "binary_big_endian" })
+    {
+        std::string filename = writeTestFile(format, count);
+        for (int threads : { 1, 4 })
+        {
+            PlyReader reader;
+            Options options;
+            options.add("filename", filename);
+            options.add("threads", threads);
+            reader.setOptions(options);
+
+            PointTable table;
+            reader.prepare(table);
+            PointViewSet viewSet = reader.execute(table);
+            EXPECT_EQ(viewSet.size(), 1u);
+            PointViewPtr view = *viewSet.begin();
+            ASSERT_EQ(view->size(), count);
+
+            Dimension::Id w = table.layout()->findDim("w");
+            for (PointId i = 0; i < count; i += 997)
+            {
+                checkPoint(view, i, i + .25, i * .5f, (double)(i % 60000));
+                EXPECT_EQ(view->getFieldAs<int>(w, i), -(int)i);
+            }
+        }
+        FileUtils::deleteFile(filename);
+    }
+}
+
+
+// Lines of only whitespace are skipped when reading ASCII data.
+TEST(PlyReader, ReadTextBlankLines)
+{
+    std::string filename(Support::temppath("ply_blank.ply"));
+    {
+        std::ofstream out(filename);
+        out << "ply\nformat ascii 1.0\nelement vertex 3\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "end_header\n"
+            "-1 0 0\n   \n\n 0 1 0\n  \r\n 1 0 0\n";
+    }
+
+    for (int threads : { 1, 4 })
+    {
+        PlyReader reader;
+        Options options;
+        options.add("filename", filename);
+        options.add("threads", threads);
+        reader.setOptions(options);
+
+        PointTable table;
+        reader.prepare(table);
+        PointViewSet viewSet = reader.execute(table);
+        PointViewPtr view = *viewSet.begin();
+        ASSERT_EQ(view->size(), 3u);
+        checkPoint(view, 0, -1, 0, 0);
+        checkPoint(view, 1, 0, 1, 0);
+        checkPoint(view, 2, 1, 0, 0);
+    }
+
+    PlyReader reader;
+    Options options;
+    options.add("filename", filename);
+    reader.setOptions(options);
+
+    FixedPointTable table(2);
+    reader.prepare(table);
+    std::vector<double> y;
+    StreamCallbackFilter f;
+    f.setCallback([&y](PointRef& point)
+    {
+        y.push_back(point.getFieldAs<double>(Dimension::Id::Y));
+        return true;
+    });
+    f.setInput(reader);
+    f.prepare(table);
+    f.execute(table);
+    EXPECT_EQ(y, std::vector<double>({ 0, 1, 0 }));
+
+    FileUtils::deleteFile(filename);
+}
+
+
 TEST(PlyReader, NoVertex)
 {
     PlyReader reader;
@@ -199,4 +346,27 @@ TEST(PlyReader, NoVertex)
     EXPECT_THROW(reader.prepare(table), pdal_error);
 }
 
+
+TEST(PlyReader, NoVertexProperties)
+{
+    std::string filename(Support::temppath("ply_noprops.ply"));
+    for (std::string format : { "ascii", "binary_little_endian" })
+    {
+        {
+            std::ofstream out(filename);
+            out << "ply\nformat " << format << " 1.0\n"
+                "element vertex 3\nend_header\n";
+        }
+
+        PlyReader reader;
+        Options options;
+        options.add("filename", filename);
+        reader.setOptions(options);
+
+        PointTable table;
+        EXPECT_THROW(reader.prepare(table), pdal_error);
+    }
+    FileUtils::deleteFile(filename);
+}
+
 }
@@ -34,6 +34,8 @@
 
 #include <pdal/pdal_test_main.hpp>
 
+#include <fstream>
+
 #include "Support.hpp"
 
 #include <io/LasReader.hpp>
@@ -177,6 +179,75 @@ TEST(TextReaderTest, t3)
         Support::datapath("las/utm17.las"));
 }
 
+TEST(TextReaderTest, threads)
+{
+    for (std::string f : { "text/utm17_1.txt", "text/utm17_2.txt",
+        "text/utm17_3.txt" })
+    {
+        Options textOptions;
+        textOptions.add("threads", 4);
+
+        compareTextLas(Support::datapath(f), textOptions,
+            Support::datapath("las/utm17.las"));
+    }
+}
+
+// Lines with the wrong field count are dropped and bad fields are zeroed
+// the same way no matter how the file is split among threads.
+TEST(TextReaderTest, threadsBadLines)
+{
+    std::string filename(Support::temppath("badlines.txt"));
+    {
+        std::ofstream out(filename);
+        out << "X,Y,Z\n";
+        for (int i = 0; i < 1000; ++i)
+        {
+            if (i % 97 == 0)
+                out << i << "," << i << "\n";
+            else if (i % 89 == 0)
+                out << i << ",bad," << i << "\n";
+            else
+                out << i << "," << (i * .5) << "," << (i * 1.5e-3) << "\n";
+        }
+    }
+
+    auto read = [&filename](int threads)
+    {
+        TextReader r;
+        Options o;
+        o.add("filename", filename);
+        o.add("threads", threads);
+        r.setOptions(o);
+
+        PointTable t;
+        r.prepare(t);
+        PointViewSet s = r.execute(t);
+        EXPECT_EQ(s.size(), 1U);
+        return *s.begin();
+    };
+
+    PointViewPtr v1 = read(1);
+    PointViewPtr v4 = read(4);
+
+    // 1000 lines less the 11 short ones.
+    EXPECT_EQ(v1->size(), 989U);
+    EXPECT_EQ(v1->size(), v4->size());
+    for (PointId i = 0; i < v1->size(); ++i)
+    {
+        double x = v1->getFieldAs<double>(Dimension::Id::X, i);
+        EXPECT_EQ(x, v4->getFieldAs<double>(Dimension::Id::X, i));
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i),
+            v4->getFieldAs<double>(Dimension::Id::Y, i));
+        EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Z, i),
+            v4->getFieldAs<double>(Dimension::Id::Z, i));
+        if ((int)x % 89 == 0 && (int)x % 97 != 0)
+            EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i), 0.0);
+        else
+            EXPECT_EQ(v1->getFieldAs<double>(Dimension::Id::Y, i), x * .5);
+    }
+    FileUtils::deleteFile(filename);
+}
+
 TEST(TextReaderTest, badheader)
 {
     TextReader t;
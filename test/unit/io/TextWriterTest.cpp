@@ -36,8 +36,11 @@
 
 #include "Support.hpp"
 
+#include <nlohmann/json.hpp>
+
 #include <pdal/util/FileUtils.hpp>
 #include <io/BufferReader.hpp>
+#include <io/FauxReader.hpp>
 #include <io/TextReader.hpp>
 #include <io/TextWriter.hpp>
 
@@ -185,3 +188,73 @@ TEST(TextWriterTest, precision)
     EXPECT_NE(out.find("3,3,3,3"), std::string::npos);
 }
 
+
+namespace
+{
+
+std::string writeFaux(const std::string& format, int threads, bool stream)
+{
+    std::string outfile(Support::temppath("faux.txt"));
+    FileUtils::deleteFile(outfile);
+
+    // Enough points that they're formatted in several chunks.
+    FauxReader r;
+    Options ro;
+    ro.add("bounds", BOX3D(-1000.0, 1.0, 2.0, 1000.0, 3000.0, 4.0));
+    ro.add("count", 120000);
+    ro.add("mode", "ramp");
+    r.setOptions(ro);
+
+    TextWriter w;
+    Options wo;
+    wo.add("filename", outfile);
+    wo.add("format", format);
+    wo.add("order", "X:2,Y:5,Z:0");
+    wo.add("threads", threads);
+    w.setOptions(wo);
+    w.setInput(r);
+
+    if (stream)
+    {
+        FixedPointTable t(1000);
+        w.prepare(t);
+        w.execute(t);
+    }
+    else
+    {
+        PointTable t;
+        w.prepare(t);
+        w.execute(t);
+    }
+    return FileUtils::readFileIntoString(outfile);
+}
+
+} // unnamed namespace
+
+TEST(TextWriterTest, threads)
+{
+    for (std::string format : { "csv", "geojson" })
+    {
+        std::string serial = writeFaux(format, 1, false);
+        EXPECT_EQ(serial, writeFaux(format, 4, false));
+        EXPECT_EQ(serial, writeFaux(format, 1, true));
+    }
+}
+
+TEST(TextWriterTest, geojson)
+{
+    std::string out = writeFaux("geojson", 3, false);
+
+    NL::json j = NL::json::parse(out);
+    NL::json& features = j["features"];
+    ASSERT_EQ(features.size(), 120000U);
+
+    NL::json& first = features[0];
+    EXPECT_EQ(first["geometry"]["coordinates"][0].get<double>(), -1000.0);
+    EXPECT_EQ(first["geometry"]["coordinates"][1].get<double>(), 1.0);
+    EXPECT_EQ(first["properties"]["X"].get<std::string>(), "-1000.00");
+    EXPECT_EQ(first["properties"]["Y"].get<std::string>(), "1.00000");
+    EXPECT_EQ(first["properties"]["Z"].get<std::string>(), "2");
+    EXPECT_EQ(features[119999]["properties"]["X"].get<std::string>(),
+        "1000.00");
+}